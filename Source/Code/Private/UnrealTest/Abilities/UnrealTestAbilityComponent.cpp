@@ -0,0 +1,286 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Abilities/UnrealTestAbilityComponent.h"
+#include "UnrealTest/Game/UnrealTestGameMode.h"
+#include "UnrealTest/Game/UnrealTestTimerSubsystem.h"
+#include "UnrealTest/Player/UnrealTestClockSyncComponent.h"
+#include "UnrealTest/Player/UnrealTestPlayerController.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "Net/UnrealNetwork.h"
+
+static_assert(UNREALTEST_MAX_ABILITIES < 32, "Ability ready masks are 32 bits wide");
+
+UUnrealTestAbilityComponent::UUnrealTestAbilityComponent()
+{
+	// Charges are derived from timestamps when asked for, there is nothing to advance every frame
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+
+	FMemory::Memzero(ChargesFullAtMs);
+	FMemory::Memzero(BuffEndMs);
+	FMemory::Memzero(BuffIds);
+	FMemory::Memzero(CooldownMs);
+	FMemory::Memzero(MaxCharges);
+	NumAbilities = 0;
+}
+
+void UUnrealTestAbilityComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (Abilities.Num() > UNREALTEST_MAX_ABILITIES)
+	{
+		UE_LOG(LogUnrealTest, Warning, TEXT("%s: %d abilities defined, only the first %d are used"), *GetPathName(), Abilities.Num(), UNREALTEST_MAX_ABILITIES);
+	}
+
+	// Unused slots keep one charge and no cooldown so the ready mask needs no bounds check
+	NumAbilities = FMath::Min(Abilities.Num(), UNREALTEST_MAX_ABILITIES);
+	for (int32 Index = 0; Index < UNREALTEST_MAX_ABILITIES; ++Index)
+	{
+		const bool bDefined = Index < NumAbilities;
+		CooldownMs[Index] = bDefined ? FMath::RoundToInt(Abilities[Index].CooldownSeconds * 1000.f) : 0;
+		MaxCharges[Index] = bDefined ? FMath::Max(Abilities[Index].MaxCharges, 1) : 1;
+	}
+
+	if (AUnrealTestGameMode* GameMode = GetWorld()->GetAuthGameMode<AUnrealTestGameMode>())
+	{
+		GameMode->RegisterRoundResettable(this);
+	}
+}
+
+void UUnrealTestAbilityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelReadyTimers();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UUnrealTestAbilityComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Static arrays replicate per element, so only the timestamps that changed are sent
+	DOREPLIFETIME(UUnrealTestAbilityComponent, ChargesFullAtMs);
+	DOREPLIFETIME(UUnrealTestAbilityComponent, BuffEndMs);
+	DOREPLIFETIME(UUnrealTestAbilityComponent, BuffIds);
+}
+
+void UUnrealTestAbilityComponent::ResetForNewRound()
+{
+	CancelReadyTimers();
+
+	FMemory::Memzero(ChargesFullAtMs);
+	FMemory::Memzero(BuffEndMs);
+	FMemory::Memzero(BuffIds);
+}
+
+int32 UUnrealTestAbilityComponent::FindAbility(FName AbilityName) const
+{
+	for (int32 Index = 0; Index < NumAbilities; ++Index)
+	{
+		if (Abilities[Index].Name == AbilityName)
+		{
+			return Index;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 UUnrealTestAbilityComponent::GetCharges(int32 AbilityIndex) const
+{
+	if (AbilityIndex < 0 || AbilityIndex >= NumAbilities)
+	{
+		return 0;
+	}
+
+	const int32 RemainingMs = ChargesFullAtMs[AbilityIndex] - GetNowMs();
+	if (RemainingMs <= 0 || CooldownMs[AbilityIndex] <= 0)
+	{
+		return MaxCharges[AbilityIndex];
+	}
+
+	// Every charge still missing accounts for one full cooldown of the remaining time
+	const int32 MissingCharges = FMath::DivideAndRoundUp(RemainingMs, CooldownMs[AbilityIndex]);
+	return FMath::Max(MaxCharges[AbilityIndex] - MissingCharges, 0);
+}
+
+float UUnrealTestAbilityComponent::GetCooldownRemaining(int32 AbilityIndex) const
+{
+	if (AbilityIndex < 0 || AbilityIndex >= NumAbilities || CooldownMs[AbilityIndex] <= 0)
+	{
+		return 0.f;
+	}
+
+	const int32 RemainingMs = ChargesFullAtMs[AbilityIndex] - GetNowMs();
+	if (RemainingMs <= 0)
+	{
+		return 0.f;
+	}
+
+	// The next charge comes back when the remaining time drops to the previous multiple of the cooldown
+	const int32 NextChargeMs = RemainingMs % CooldownMs[AbilityIndex];
+	return (NextChargeMs > 0 ? NextChargeMs : CooldownMs[AbilityIndex]) * 0.001f;
+}
+
+bool UUnrealTestAbilityComponent::IsAbilityReady(int32 AbilityIndex) const
+{
+	return AbilityIndex >= 0 && AbilityIndex < NumAbilities && (GetReadyMask() & (1u << AbilityIndex)) != 0;
+}
+
+uint32 UUnrealTestAbilityComponent::GetReadyMask() const
+{
+	return GetReadyMaskAt(GetNowMs());
+}
+
+uint32 UUnrealTestAbilityComponent::GetReadyMaskAt(int32 AtMs) const
+{
+	// An ability has a charge once fewer than all of its cooldowns are left before it is full.
+	// Fixed trip count and no branches, so the compiler can keep the whole loop in vector registers
+	uint32 ReadyMask = 0;
+	for (int32 Index = 0; Index < UNREALTEST_MAX_ABILITIES; ++Index)
+	{
+		const int32 FirstChargeAtMs = ChargesFullAtMs[Index] - CooldownMs[Index] * (MaxCharges[Index] - 1);
+		ReadyMask |= uint32(FirstChargeAtMs <= AtMs) << Index;
+	}
+
+	return ReadyMask & ((1u << NumAbilities) - 1u);
+}
+
+bool UUnrealTestAbilityComponent::TryActivateAbility(int32 AbilityIndex, float SecondsAgo)
+{
+	if (AbilityIndex < 0 || AbilityIndex >= NumAbilities)
+	{
+		return false;
+	}
+
+	// Remote activations are judged at the time they happened on the owning player's machine
+	const int32 ActivationMs = GetNowMs() - FMath::RoundToInt(FMath::Max(SecondsAgo, 0.f) * 1000.f);
+	if ((GetReadyMaskAt(ActivationMs) & (1u << AbilityIndex)) == 0)
+	{
+		return false;
+	}
+
+	// Spending a charge pushes the full time back by one cooldown, starting then if it was already full
+	ChargesFullAtMs[AbilityIndex] = FMath::Max(ChargesFullAtMs[AbilityIndex], ActivationMs) + CooldownMs[AbilityIndex];
+	ScheduleReadyTimer(AbilityIndex);
+	return true;
+}
+
+int32 UUnrealTestAbilityComponent::GetChargesFullAtMs(int32 AbilityIndex) const
+{
+	return AbilityIndex >= 0 && AbilityIndex < NumAbilities ? ChargesFullAtMs[AbilityIndex] : 0;
+}
+
+void UUnrealTestAbilityComponent::ResyncAbility(int32 AbilityIndex, int32 ServerChargesFullAtMs)
+{
+	if (AbilityIndex < 0 || AbilityIndex >= NumAbilities || GetOwnerRole() == ROLE_Authority)
+	{
+		return;
+	}
+
+	ChargesFullAtMs[AbilityIndex] = ServerChargesFullAtMs;
+	ScheduleReadyTimer(AbilityIndex);
+}
+
+void UUnrealTestAbilityComponent::ScheduleReadyTimer(int32 AbilityIndex)
+{
+	UUnrealTestTimerSubsystem* Timers = GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>();
+	if (Timers == nullptr)
+	{
+		return;
+	}
+
+	// Nothing polls for the ability coming back, the gameplay timers call us when it does
+	Timers->Cancel(ReadyTimers[AbilityIndex]);
+	const int32 NowMs = GetNowMs();
+	const int32 FirstChargeAtMs = ChargesFullAtMs[AbilityIndex] - CooldownMs[AbilityIndex] * (MaxCharges[AbilityIndex] - 1);
+	if (FirstChargeAtMs > NowMs)
+	{
+		ReadyTimers[AbilityIndex] = Timers->Schedule((FirstChargeAtMs - NowMs) * 0.001f, FSimpleDelegate::CreateUObject(this, &UUnrealTestAbilityComponent::OnReadyTimerElapsed, AbilityIndex));
+	}
+}
+
+void UUnrealTestAbilityComponent::OnReadyTimerElapsed(int32 AbilityIndex)
+{
+	ReadyTimers[AbilityIndex].Invalidate();
+	OnAbilityReady.Broadcast(this, AbilityIndex);
+}
+
+void UUnrealTestAbilityComponent::CancelReadyTimers()
+{
+	UUnrealTestTimerSubsystem* Timers = GetWorld() ? GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>() : nullptr;
+	if (Timers == nullptr)
+	{
+		return;
+	}
+
+	for (FUnrealTestTimerHandle& ReadyTimer : ReadyTimers)
+	{
+		Timers->Cancel(ReadyTimer);
+	}
+}
+
+void UUnrealTestAbilityComponent::ApplyBuff(uint8 BuffId, float Duration)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	// Refresh the slot already holding the buff, otherwise take the one expiring first
+	const int32 NowMs = GetNowMs();
+	int32 Slot = 0;
+	for (int32 Index = 0; Index < UNREALTEST_MAX_BUFFS; ++Index)
+	{
+		if (BuffIds[Index] == BuffId && BuffEndMs[Index] > NowMs)
+		{
+			Slot = Index;
+			break;
+		}
+		if (BuffEndMs[Index] < BuffEndMs[Slot])
+		{
+			Slot = Index;
+		}
+	}
+
+	BuffIds[Slot] = BuffId;
+	BuffEndMs[Slot] = NowMs + FMath::RoundToInt(Duration * 1000.f);
+}
+
+bool UUnrealTestAbilityComponent::IsBuffActive(uint8 BuffId) const
+{
+	const int32 NowMs = GetNowMs();
+	bool bActive = false;
+	for (int32 Index = 0; Index < UNREALTEST_MAX_BUFFS; ++Index)
+	{
+		bActive |= BuffIds[Index] == BuffId && BuffEndMs[Index] > NowMs;
+	}
+	return bActive;
+}
+
+int32 UUnrealTestAbilityComponent::GetNowMs() const
+{
+	const UWorld* World = GetWorld();
+	double ServerTime = World ? World->GetTimeSeconds() : 0.0;
+
+	if (World && GetOwnerRole() != ROLE_Authority)
+	{
+		// The owning player has a finely synchronized clock, everyone else settles for the game state's
+		const APawn* Pawn = Cast<APawn>(GetOwner());
+		const AUnrealTestPlayerController* PlayerController = Pawn ? Pawn->GetController<AUnrealTestPlayerController>() : nullptr;
+		const UUnrealTestClockSyncComponent* ClockSync = PlayerController ? PlayerController->GetClockSync() : nullptr;
+		if (ClockSync && ClockSync->IsSynchronized())
+		{
+			ServerTime = ClockSync->GetServerTime();
+		}
+		else if (const AGameStateBase* GameState = World->GetGameState())
+		{
+			ServerTime = GameState->GetServerWorldTimeSeconds();
+		}
+	}
+
+	return static_cast<int32>(ServerTime * 1000.0);
+}
@@ -0,0 +1,252 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Character/UnrealTestAnimationBudgetSubsystem.h"
+#include "UnrealTest/Character/UnrealTestSkeletalMeshComponent.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Animation Budget Update"), STAT_UnrealTest_AnimationBudget, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Animated Meshes Full Rate"), STAT_UnrealTest_AnimFullRate, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Animated Meshes Reduced Rate"), STAT_UnrealTest_AnimReducedRate, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Animated Meshes Off Screen"), STAT_UnrealTest_AnimOffScreen, STATGROUP_UnrealTest);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Animation Game Thread (ms)"), STAT_UnrealTest_AnimGameThread, STATGROUP_UnrealTest);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Animation Mesh Cost (ms)"), STAT_UnrealTest_AnimMeshCost, STATGROUP_UnrealTest);
+
+UUnrealTestAnimationBudgetSubsystem::UUnrealTestAnimationBudgetSubsystem()
+{
+	FrameBudgetMs = FRAME_BUDGET_MS;
+	InitialMeshCostMs = INITIAL_MESH_COST_MS;
+	ReferenceDistance = REFERENCE_DISTANCE;
+	ReducedTickRates = { 2, 4, 12 };
+	bInterpolateReducedRates = true;
+	UpdateInterval = UPDATE_INTERVAL;
+	bServerEvaluatesHitboxPose = true;
+	ServerForcedLOD = INDEX_NONE;
+	ServerPoseTickRate = SERVER_POSE_TICK_RATE;
+
+	TimeUntilUpdate = 0.f;
+	MeshCostMs = 0.f;
+	NextFrameOffset = 0;
+}
+
+TStatId UUnrealTestAnimationBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUnrealTestAnimationBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UUnrealTestAnimationBudgetSubsystem::RegisterMesh(USkeletalMeshComponent* Mesh, bool bNeedsHitboxPose)
+{
+	if (Mesh == nullptr || Meshes.ContainsByPredicate([Mesh](const FBudgetedMesh& Budgeted) { return Budgeted.Mesh == Mesh; }))
+	{
+		return;
+	}
+
+	// The budget drives the update rate optimizations from outside, they never pick a rate of their own
+	Mesh->bEnableUpdateRateOptimizations = true;
+
+	FBudgetedMesh& Budgeted = Meshes.AddDefaulted_GetRef();
+	Budgeted.Mesh = Mesh;
+	Budgeted.FrameOffset = NextFrameOffset++;
+
+	if (GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		// Nothing ranks meshes on a dedicated server, they are configured once
+		ConfigureServerMesh(Budgeted, bNeedsHitboxPose);
+		return;
+	}
+
+	// Meshes nobody sees catch up on their pose the next time they are rendered,
+	// unless a listen server rewinds their bones
+	const bool bKeepPose = bNeedsHitboxPose && GetWorld()->GetNetMode() == NM_ListenServer;
+	Mesh->VisibilityBasedAnimTickOption = bKeepPose ? EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones : EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+}
+
+void UUnrealTestAnimationBudgetSubsystem::UnregisterMesh(USkeletalMeshComponent* Mesh)
+{
+	const int32 Index = Meshes.IndexOfByPredicate([Mesh](const FBudgetedMesh& Budgeted) { return Budgeted.Mesh == Mesh; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (Mesh)
+	{
+		Mesh->EnableExternalTickRateControl(false);
+		Mesh->EnableExternalInterpolation(false);
+		Mesh->EnableExternalUpdate(false);
+	}
+	Meshes.RemoveAtSwap(Index);
+}
+
+void UUnrealTestAnimationBudgetSubsystem::ConfigureServerMesh(FBudgetedMesh& Budgeted, bool bNeedsHitboxPose) const
+{
+	USkeletalMeshComponent* Mesh = Budgeted.Mesh.Get();
+	if (!bNeedsHitboxPose || !bServerEvaluatesHitboxPose)
+	{
+		// Montages keep ticking for their notifies and root motion, the pose is never built
+		Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		return;
+	}
+
+	// Hitboxes read the latest evaluated bones, blending towards them would only add lag
+	Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	Mesh->SetForcedLOD(ServerForcedLOD == INDEX_NONE ? Mesh->GetNumLODs() : ServerForcedLOD);
+	Budgeted.TickRate = uint8(FMath::Clamp(ServerPoseTickRate, 1, 255));
+	Budgeted.bInterpolate = false;
+}
+
+void UUnrealTestAnimationBudgetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Meshes.Num() == 0)
+	{
+		return;
+	}
+
+	Meshes.RemoveAllSwap([](const FBudgetedMesh& Budgeted) { return !Budgeted.Mesh.IsValid(); });
+
+	// Meshes ticked earlier this frame, updating as DriveMeshUpdates asked them to last frame
+	MeasureMeshCosts();
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate <= 0.f && GetWorld()->GetNetMode() != NM_DedicatedServer)
+	{
+		TimeUntilUpdate = UpdateInterval;
+		UpdateBudget();
+	}
+
+	DriveMeshUpdates(DeltaTime);
+}
+
+void UUnrealTestAnimationBudgetSubsystem::MeasureMeshCosts()
+{
+	uint64 Cycles = 0;
+	int32 NumUpdated = 0;
+	for (const FBudgetedMesh& Budgeted : Meshes)
+	{
+		if (UUnrealTestSkeletalMeshComponent* Mesh = Cast<UUnrealTestSkeletalMeshComponent>(Budgeted.Mesh.Get()))
+		{
+			Cycles += Mesh->ConsumeGameThreadCycles();
+			NumUpdated += Budgeted.bUpdated && (Mesh->WasRecentlyRendered() || Mesh->VisibilityBasedAnimTickOption == EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones);
+		}
+	}
+
+	// Skipped frames still cost a little and are counted against the meshes that did update, which errs on the safe side
+	const float FrameMs = float(FPlatformTime::ToMilliseconds64(Cycles));
+	if (NumUpdated > 0)
+	{
+		const float FrameMeshCostMs = FrameMs / NumUpdated;
+		MeshCostMs = MeshCostMs > 0.f ? FMath::Lerp(MeshCostMs, FrameMeshCostMs, MESH_COST_SMOOTHING) : FrameMeshCostMs;
+	}
+
+	SET_FLOAT_STAT(STAT_UnrealTest_AnimGameThread, FrameMs);
+	SET_FLOAT_STAT(STAT_UnrealTest_AnimMeshCost, MeshCostMs);
+}
+
+void UUnrealTestAnimationBudgetSubsystem::DriveMeshUpdates(float DeltaTime)
+{
+	const uint64 FrameCounter = GFrameCounter;
+	for (FBudgetedMesh& Budgeted : Meshes)
+	{
+		USkeletalMeshComponent* Mesh = Budgeted.Mesh.Get();
+		Budgeted.AccumulatedDeltaTime += DeltaTime;
+
+		// 0 on the frames the mesh updates, then how far it is towards the next update
+		const int32 Phase = int32((FrameCounter + Budgeted.FrameOffset) % Budgeted.TickRate);
+		Budgeted.bUpdated = Phase == 0;
+
+		// The update rate parameters may only be created once the mesh ticked, so control is asked for every frame
+		Mesh->EnableExternalTickRateControl(true);
+		Mesh->SetExternalTickRate(Budgeted.TickRate);
+		Mesh->EnableExternalInterpolation(Budgeted.bInterpolate);
+		Mesh->EnableExternalUpdate(Budgeted.bUpdated);
+		if (Budgeted.bUpdated)
+		{
+			Mesh->SetExternalDeltaTime(Budgeted.AccumulatedDeltaTime);
+			Budgeted.AccumulatedDeltaTime = 0.f;
+		}
+		else if (Budgeted.bInterpolate)
+		{
+			Mesh->SetExternalInterpolationAlpha(float(Phase) / Budgeted.TickRate);
+		}
+	}
+}
+
+bool UUnrealTestAnimationBudgetSubsystem::GetViewLocation(FVector& OutLocation) const
+{
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController == nullptr || !PlayerController->IsLocalController())
+	{
+		return false;
+	}
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+	return true;
+}
+
+void UUnrealTestAnimationBudgetSubsystem::UpdateBudget()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_AnimationBudget);
+
+	FVector ViewLocation = FVector::ZeroVector;
+	const bool bHasView = GetViewLocation(ViewLocation);
+
+	// Off screen meshes are already skipped by the visibility tick option and don't take from the budget
+	Significances.SetNumUninitialized(Meshes.Num());
+	RankedIndices.Reset();
+	int32 NumOffScreen = 0;
+	for (int32 Index = 0; Index < Meshes.Num(); ++Index)
+	{
+		const USkeletalMeshComponent* Mesh = Meshes[Index].Mesh.Get();
+		if (!Mesh->WasRecentlyRendered())
+		{
+			++NumOffScreen;
+			continue;
+		}
+
+		const float Distance = bHasView ? FVector::Dist(ViewLocation, Mesh->GetComponentLocation()) : 0.f;
+		Significances[Index] = ReferenceDistance / (ReferenceDistance + Distance);
+		RankedIndices.Add(Index);
+	}
+
+	RankedIndices.Sort([this](int32 A, int32 B) { return Significances[A] > Significances[B]; });
+
+	// Costs are per frame: a mesh updating every N frames takes a Nth of its cost from every frame
+	const float CostPerMeshMs = MeshCostMs > 0.f ? MeshCostMs : InitialMeshCostMs;
+	float RemainingMs = FrameBudgetMs;
+	int32 NumFullRate = 0;
+	for (const int32 Index : RankedIndices)
+	{
+		FBudgetedMesh& Budgeted = Meshes[Index];
+
+		int32 TickRate = 1;
+		if (CostPerMeshMs > RemainingMs)
+		{
+			TickRate = ReducedTickRates.Num() > 0 ? ReducedTickRates.Last() : 1;
+			for (const int32 ReducedRate : ReducedTickRates)
+			{
+				if (CostPerMeshMs / FMath::Max(ReducedRate, 1) <= RemainingMs)
+				{
+					TickRate = ReducedRate;
+					break;
+				}
+			}
+		}
+		else
+		{
+			++NumFullRate;
+		}
+
+		Budgeted.TickRate = uint8(FMath::Clamp(TickRate, 1, 255));
+		Budgeted.bInterpolate = bInterpolateReducedRates && Budgeted.TickRate > 1;
+		RemainingMs -= CostPerMeshMs / Budgeted.TickRate;
+	}
+
+	SET_DWORD_STAT(STAT_UnrealTest_AnimFullRate, NumFullRate);
+	SET_DWORD_STAT(STAT_UnrealTest_AnimReducedRate, RankedIndices.Num() - NumFullRate);
+	SET_DWORD_STAT(STAT_UnrealTest_AnimOffScreen, NumOffScreen);
+}
@@ -1,17 +1,40 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Abilities/UnrealTestAbilityComponent.h"
+#include "UnrealTest/Character/UnrealTestAnimationBudgetSubsystem.h"
+#include "UnrealTest/Character/UnrealTestMovementSettings.h"
+#include "UnrealTest/Character/UnrealTestSkeletalMeshComponent.h"
+#include "UnrealTest/Combat/UnrealTestHealthComponent.h"
+#include "UnrealTest/Combat/UnrealTestHitboxHistoryComponent.h"
+#include "UnrealTest/Combat/UnrealTestMeleeAttackComponent.h"
+#include "UnrealTest/Combat/UnrealTestProjectile.h"
+#include "UnrealTest/Game/UnrealTestActorPoolSubsystem.h"
+#include "UnrealTest/Game/UnrealTestGameMode.h"
+#include "UnrealTest/Game/UnrealTestGameState.h"
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "UnrealTest/Math/UnrealTestBatchMath.h"
+#include "UnrealTest/Net/UnrealTestNetPrioritizerSubsystem.h"
+#include "UnrealTest/Player/UnrealTestPlayerController.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
 #include "GameFramework/SpringArmComponent.h"
 
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Attack Rewind (ms)"), STAT_UnrealTest_AttackRewind, STATGROUP_UnrealTest);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Attack Rewind Error vs Half RTT (ms)"), STAT_UnrealTest_AttackRewindError, STATGROUP_UnrealTest);
+
 //////////////////////////////////////////////////////////////////////////
 // AUnrealTestCharacter
 
-AUnrealTestCharacter::AUnrealTestCharacter()
+AUnrealTestCharacter::AUnrealTestCharacter(const FObjectInitializer& ObjectInitializer)
+	// The mesh measures its animation time for the animation budget
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UUnrealTestSkeletalMeshComponent>(ACharacter::MeshComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -22,14 +45,187 @@ AUnrealTestCharacter::AUnrealTestCharacter()
 	DisableCotrollerRotation();
 
 	ConfigureCharacterMovement(GetCharacterMovement());
-	
+
+	// Nobody looks through the camera of a dedicated server
+#if !UE_SERVER
 	SetCameraBoom();
 	SetFollowCamera();
 
+	NextProjectileId = 1;
+	GamepadLookStick = FVector2D::ZeroVector;
+	bJumpInputHeld = false;
+	bAttackQueued = false;
+	AttackInputPlatformTime = 0.0;
+#endif
+
+	SetHitboxHistory();
+	SetAbilities();
+	SetHealth();
+	SetMeleeAttack();
+
+	bMeleeAttack = false;
+	MuzzleOffset = MUZZLE_OFFSET;
+	MaxAttackOriginError = MAX_ATTACK_ORIGIN_ERROR;
+	ProjectilePrewarmCount = PROJECTILE_PREWARM_COUNT;
+
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 }
 
+void AUnrealTestCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The server's tuning wins, clients predicting with other values would keep getting corrected
+	const AUnrealTestGameState* GameState = GetWorld()->GetGameState<AUnrealTestGameState>();
+	ApplyMovementTuning(GameState ? GameState->GetMovementTuning(ChampionName) : GetDefault<UUnrealTestMovementSettings>()->GetTuning(ChampionName));
+
+	Health->OnDeath.AddUObject(this, &AUnrealTestCharacter::HandleDeath);
+	Health->OnRevived.AddUObject(this, &AUnrealTestCharacter::HandleRevived);
+
+	// Characters are kept between rounds and reset in place by the game mode
+	if (AUnrealTestGameMode* GameMode = GetWorld()->GetAuthGameMode<AUnrealTestGameMode>())
+	{
+		GameMode->RegisterRoundResettable(this);
+	}
+
+	if (HasAuthority())
+	{
+		if (UUnrealTestNetPrioritizerSubsystem* NetPrioritizer = GetWorld()->GetSubsystem<UUnrealTestNetPrioritizerSubsystem>())
+		{
+			NetPrioritizer->RegisterCharacter(this);
+		}
+
+		// Enough projectiles for this champion's shots in flight, so firing never spawns any
+		UUnrealTestActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UUnrealTestActorPoolSubsystem>();
+		if (Pool && !bMeleeAttack)
+		{
+			Pool->Prewarm(ProjectileClass, ProjectilePrewarmCount);
+		}
+	}
+
+	if (Health->IsDead())
+	{
+		HitboxHistory->SetHittable(false);
+	}
+	else if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->RegisterPawn(this);
+	}
+
+	if (UUnrealTestAnimationBudgetSubsystem* AnimationBudget = GetWorld()->GetSubsystem<UUnrealTestAnimationBudgetSubsystem>())
+	{
+		AnimationBudget->RegisterMesh(GetMesh(), HitboxHistory->HasBoneHitboxes());
+	}
+}
+
+void AUnrealTestCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UUnrealTestNetPrioritizerSubsystem* NetPrioritizer = GetWorld()->GetSubsystem<UUnrealTestNetPrioritizerSubsystem>())
+	{
+		NetPrioritizer->UnregisterCharacter(this);
+	}
+
+	if (UUnrealTestAnimationBudgetSubsystem* AnimationBudget = GetWorld()->GetSubsystem<UUnrealTestAnimationBudgetSubsystem>())
+	{
+		AnimationBudget->UnregisterMesh(GetMesh());
+	}
+
+	if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->UnregisterPawn(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AUnrealTestCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+#if !UE_SERVER
+	// Pawns tick after their controller, so the view rotation of this frame is final here
+	if (bAttackQueued)
+	{
+		bAttackQueued = false;
+		FireQueuedAttack();
+	}
+#endif
+}
+
+float AUnrealTestCharacter::GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth)
+{
+	// Time since the last update to this connection keeps starved characters climbing back up
+	UUnrealTestNetPrioritizerSubsystem* NetPrioritizer = GetWorld()->GetSubsystem<UUnrealTestNetPrioritizerSubsystem>();
+	const float Score = NetPrioritizer ? NetPrioritizer->GetRelevancyScore(this, ViewPos, ViewDir, ViewTarget) : 1.f;
+	return NetPriority * Time * FMath::Max(Score, KINDA_SMALL_NUMBER);
+}
+
+void AUnrealTestCharacter::ResetForNewRound()
+{
+	GetCharacterMovement()->StopMovementImmediately();
+	HitboxHistory->ClearHistory();
+	MeleeAttack->CancelSwing();
+}
+
+void AUnrealTestCharacter::OnAcquiredFromPool()
+{
+	// NPCs from the waves, prewarmed or parked by a previous round, are only found by queries once handed out
+	if (Health->IsDead())
+	{
+		return;
+	}
+
+	if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->RegisterPawn(this);
+	}
+	HitboxHistory->SetHittable(true);
+}
+
+void AUnrealTestCharacter::OnReleasedToPool()
+{
+	GetCharacterMovement()->StopMovementImmediately();
+	MeleeAttack->CancelSwing();
+
+	if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->UnregisterPawn(this);
+	}
+	HitboxHistory->SetHittable(false);
+}
+
+void AUnrealTestCharacter::HandleDeath(UUnrealTestHealthComponent* DeadHealth, AController* Killer)
+{
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	SetActorEnableCollision(false);
+	MeleeAttack->CancelSwing();
+
+	// Queries and rewound attacks only look for the living
+	if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->UnregisterPawn(this);
+	}
+	HitboxHistory->SetHittable(false);
+
+	if (AUnrealTestGameMode* GameMode = GetWorld()->GetAuthGameMode<AUnrealTestGameMode>())
+	{
+		GameMode->NotifyPlayerDied(GetController());
+	}
+}
+
+void AUnrealTestCharacter::HandleRevived(UUnrealTestHealthComponent* RevivedHealth)
+{
+	GetCharacterMovement()->SetDefaultMovementMode();
+	SetActorEnableCollision(true);
+	if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->RegisterPawn(this);
+	}
+	HitboxHistory->SetHittable(true);
+}
+
 void AUnrealTestCharacter::DisableCotrollerRotation()
 {
 	// Don't rotate when the controller rotates. Let that just affect the camera.
@@ -44,15 +240,50 @@ void AUnrealTestCharacter::ConfigureCharacterMovement(UCharacterMovementComponen
 	characterMovement->bOrientRotationToMovement = true; // Character moves in the direction of input...	
 	characterMovement->RotationRate = FRotator(0.0f, 500.0f, 0.0f); // ...at this rotation rate
 
-	// Note: For faster iteration times these variables, and many more, can be tweaked in the Character Blueprint
-	// instead of recompiling to adjust them
-	characterMovement->JumpZVelocity = JUMP_Z_VELOCITY;
-	characterMovement->AirControl = AIR_CONTROL;
-	characterMovement->MaxWalkSpeed = MAX_WALK_SPEED;
-	characterMovement->MinAnalogWalkSpeed = MIN_ANALOG_WALK_SPEED;
-	characterMovement->BrakingDecelerationWalking = BRAKING_DECELERATION_WALKING;
+	// Note: Champions get their own tuning in BeginPlay, see UUnrealTestMovementSettings
+	ApplyMovementTuning(GetDefault<UUnrealTestMovementSettings>()->DefaultTuning);
+}
+
+void AUnrealTestCharacter::ApplyMovementTuning(const FUnrealTestMovementTuning& Tuning)
+{
+	UCharacterMovementComponent* characterMovement = GetCharacterMovement();
+	characterMovement->JumpZVelocity = Tuning.JumpZVelocity;
+	characterMovement->AirControl = Tuning.AirControl;
+	characterMovement->MaxWalkSpeed = Tuning.MaxWalkSpeed;
+	characterMovement->MinAnalogWalkSpeed = Tuning.MinAnalogWalkSpeed;
+	characterMovement->BrakingDecelerationWalking = Tuning.BrakingDecelerationWalking;
+}
+
+void AUnrealTestCharacter::SetHitboxHistory()
+{
+	// Record where the capsule was so the server can rewind it when validating attacks
+	HitboxHistory = CreateDefaultSubobject<UUnrealTestHitboxHistoryComponent>(TEXT("HitboxHistory"));
+}
+
+void AUnrealTestCharacter::SetAbilities()
+{
+	// The primary attack is always the first ability, champions add theirs after it in the blueprint
+	Abilities = CreateDefaultSubobject<UUnrealTestAbilityComponent>(TEXT("Abilities"));
+
+	FUnrealTestAbilityDefinition PrimaryAttack;
+	PrimaryAttack.Name = TEXT("PrimaryAttack");
+	PrimaryAttack.CooldownSeconds = PRIMARY_ATTACK_COOLDOWN;
+	Abilities->Abilities.Add(PrimaryAttack);
 }
 
+void AUnrealTestCharacter::SetHealth()
+{
+	// Takes the damage dealt to the character and ticks status effects on the game mode's timers
+	Health = CreateDefaultSubobject<UUnrealTestHealthComponent>(TEXT("Health"));
+}
+
+void AUnrealTestCharacter::SetMeleeAttack()
+{
+	// Resolves the swings of melee champions against the rewound hitboxes, never ticks otherwise
+	MeleeAttack = CreateDefaultSubobject<UUnrealTestMeleeAttackComponent>(TEXT("MeleeAttack"));
+}
+
+#if !UE_SERVER
 void AUnrealTestCharacter::SetCameraBoom()
 {
 	// Create a camera boom (pulls in towards the player if there is a collision)
@@ -69,6 +300,7 @@ void AUnrealTestCharacter::SetFollowCamera()
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 }
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 // Input
@@ -78,20 +310,25 @@ void AUnrealTestCharacter::SetupPlayerInputComponent(class UInputComponent* Play
 	// Set up gameplay key bindings
 	check(PlayerInputComponent);
 
+#if !UE_SERVER
 	JumpBinding(PlayerInputComponent);
 
 	MovementBinding(PlayerInputComponent);
 
 	TurnBinding(PlayerInputComponent);
 	LookUpBinding(PlayerInputComponent);
-	
-	TouchBinding(PlayerInputComponent);
+
+	// Touches are turned into input commands by the player controller
+
+	AttackBinding(PlayerInputComponent);
+#endif
 }
 
+#if !UE_SERVER
 void AUnrealTestCharacter::JumpBinding(class UInputComponent* PlayerInputComponent)
 {
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
+	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &AUnrealTestCharacter::JumpPressed);
+	PlayerInputComponent->BindAction("Jump", IE_Released, this, &AUnrealTestCharacter::JumpReleased);
 }
 
 void AUnrealTestCharacter::MovementBinding(class UInputComponent* PlayerInputComponent)
@@ -105,69 +342,298 @@ void AUnrealTestCharacter::TurnBinding(class UInputComponent* PlayerInputCompone
 	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
 	// "turn" handles devices that provide an absolute delta, such as a mouse.
 	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
-	PlayerInputComponent->BindAxis("Turn Right / Left Mouse", this, &APawn::AddControllerYawInput);
+	PlayerInputComponent->BindAxis("Turn Right / Left Mouse", this, &AUnrealTestCharacter::Turn);
 	PlayerInputComponent->BindAxis("Turn Right / Left Gamepad", this, &AUnrealTestCharacter::TurnAtRate);
 }
 
 void AUnrealTestCharacter::LookUpBinding(class UInputComponent* PlayerInputComponent)
 {
-	PlayerInputComponent->BindAxis("Look Up / Down Mouse", this, &APawn::AddControllerPitchInput);
+	PlayerInputComponent->BindAxis("Look Up / Down Mouse", this, &AUnrealTestCharacter::LookUp);
 	PlayerInputComponent->BindAxis("Look Up / Down Gamepad", this, &AUnrealTestCharacter::LookUpAtRate);
 }
 
-void AUnrealTestCharacter::TouchBinding(class UInputComponent* PlayerInputComponent)
+void AUnrealTestCharacter::AttackBinding(class UInputComponent* PlayerInputComponent)
+{
+	PlayerInputComponent->BindAction("Attack", IE_Pressed, this, &AUnrealTestCharacter::Attack);
+}
+
+void AUnrealTestCharacter::JumpPressed()
+{
+	PendingInputCommand.bJump = true;
+}
+
+void AUnrealTestCharacter::JumpReleased()
 {
-	PlayerInputComponent->BindTouch(IE_Pressed, this, &AUnrealTestCharacter::TouchStarted);
-	PlayerInputComponent->BindTouch(IE_Released, this, &AUnrealTestCharacter::TouchStopped);
+	PendingInputCommand.bJump = false;
 }
 
-void AUnrealTestCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
+void AUnrealTestCharacter::Turn(float Value)
 {
-	Jump();
+	PendingInputCommand.Look.X += Value;
 }
 
-void AUnrealTestCharacter::TouchStopped(ETouchIndex::Type FingerIndex, FVector Location)
+void AUnrealTestCharacter::LookUp(float Value)
 {
-	StopJumping();
+	PendingInputCommand.Look.Y += Value;
 }
 
 void AUnrealTestCharacter::TurnAtRate(float Rate)
 {
-	// calculate delta for this frame from the rate information
-	AddControllerYawInput(Rate * TurnRateGamepad * GetWorld()->GetDeltaSeconds());
+	GamepadLookStick.X = Rate;
 }
 
 void AUnrealTestCharacter::LookUpAtRate(float Rate)
 {
-	// calculate delta for this frame from the rate information
-	AddControllerPitchInput(Rate * TurnRateGamepad * GetWorld()->GetDeltaSeconds());
+	GamepadLookStick.Y = Rate;
 }
 
-void AUnrealTestCharacter::MoveForward(float Value)
+FUnrealTestInputCommandFrame AUnrealTestCharacter::ConsumeInputCommand(float DeltaSeconds)
+{
+	// Both axes are processed together so the dead zone is radial
+	PendingInputCommand.Look += GamepadLookProcessor.Process(GamepadLookSettings, GamepadLookStick, DeltaSeconds, TurnRateGamepad);
+
+	// Axes are sent again every frame and jump stays held until released
+	FUnrealTestInputCommandFrame Command = PendingInputCommand;
+	PendingInputCommand.Move = FVector2D::ZeroVector;
+	PendingInputCommand.Look = FVector2D::ZeroVector;
+	PendingInputCommand.bFire = false;
+	return Command;
+}
+
+void AUnrealTestCharacter::ApplyInputCommand(const FUnrealTestInputCommandFrame& Command)
 {
-	if ((Controller != nullptr) && (Value != 0.0f))
+	if ((Controller != nullptr) && !Command.Move.IsZero())
 	{
-		// find out which way is forward
-		const FRotator Rotation = Controller->GetControlRotation();
-		const FRotator YawRotation(0, Rotation.Yaw, 0);
+		// find out which way is forward and right
+		FVector Forward;
+		FVector Right;
+		FUnrealTestBatchMath::YawToForwardRight(Controller->GetControlRotation().Yaw, Forward, Right);
 
-		// get forward vector
-		const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X);
-		AddMovementInput(Direction, Value);
+		AddMovementInput(Forward, Command.Move.X);
+		AddMovementInput(Right, Command.Move.Y);
 	}
+
+	AddControllerYawInput(Command.Look.X);
+	AddControllerPitchInput(Command.Look.Y);
+
+	if (Command.bJump != bJumpInputHeld)
+	{
+		bJumpInputHeld = Command.bJump;
+		if (bJumpInputHeld)
+		{
+			Jump();
+		}
+		else
+		{
+			StopJumping();
+		}
+	}
+
+	if (Command.bFire)
+	{
+		bAttackQueued = true;
+		AttackInputPlatformTime = Command.FirePlatformTime;
+	}
+}
+
+void AUnrealTestCharacter::MoveForward(float Value)
+{
+	PendingInputCommand.Move.X = Value;
 }
 
 void AUnrealTestCharacter::MoveRight(float Value)
 {
-	if ( (Controller != nullptr) && (Value != 0.0f) )
+	PendingInputCommand.Move.Y = Value;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Attack
+
+#if !UE_SERVER
+void AUnrealTestCharacter::Attack()
+{
+	// Devices without a timestamp of their own get the time the binding fired at
+	PendingInputCommand.bFire = true;
+	PendingInputCommand.FirePlatformTime = FPlatformTime::Seconds();
+}
+
+void AUnrealTestCharacter::FireQueuedAttack()
+{
+	if (Controller == nullptr || (ProjectileClass == nullptr && !bMeleeAttack))
+	{
+		return;
+	}
+
+	// Remote players predict the cooldown, the listen server host spends it in HandleAttack
+	if (!HasAuthority() && !Abilities->TryActivateAbility(PRIMARY_ATTACK_ABILITY))
 	{
-		// find out which way is right
-		const FRotator Rotation = Controller->GetControlRotation();
-		const FRotator YawRotation(0, Rotation.Yaw, 0);
-	
-		// get right vector 
-		const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y);
-		// add movement in that direction
-		AddMovementInput(Direction, Value);
+		return;
 	}
+
+	// Mouse clicks carry the aim of the moment they happened, other devices use the current aim
+	FRotator AimRotation = Controller->GetControlRotation();
+	double InputPlatformTime = AttackInputPlatformTime;
+
+	FUnrealTestAttackRequest Request;
+	if (const AUnrealTestPlayerController* PlayerController = Cast<AUnrealTestPlayerController>(Controller))
+	{
+		PlayerController->GetClickAim(AimRotation, InputPlatformTime);
+		Request.ClientFireTime = PlayerController->PlatformTimeToServerTime(InputPlatformTime);
+	}
+
+	Request.Direction = AimRotation.Vector();
+	Request.Origin = GetActorLocation() + Request.Direction * MuzzleOffset;
+	Request.ProjectileId = NextProjectileId++;
+
+	// The listen server host resolves the attack right away, remote players show a prediction meanwhile
+	if (!HasAuthority() && !bMeleeAttack)
+	{
+		SpawnPredictedProjectile(Request);
+	}
+
+	ServerAttack(Request);
+}
+#endif
+
+void AUnrealTestCharacter::ServerAttack_Implementation(const FUnrealTestAttackRequest& Request)
+{
+	HandleAttack(Request);
+}
+
+void AUnrealTestCharacter::HandleAttack(const FUnrealTestAttackRequest& Request)
+{
+	if ((ProjectileClass == nullptr && !bMeleeAttack) || Health->IsDead())
+	{
+		return;
+	}
+
+	// The cooldown is checked at the client fire time, within the history we keep, so a shot sent right as
+	// the ability came back isn't turned down because it arrived closer to the previous one than it was fired
+	const float RewindSeconds = IsLocallyControlled() ? 0.f : FMath::Min(GetAttackRewindSeconds(Request), HitboxHistory->MaxRewindSeconds);
+	if (!Abilities->TryActivateAbility(PRIMARY_ATTACK_ABILITY, RewindSeconds))
+	{
+		UE_LOG(LogUnrealTest, Verbose, TEXT("%s: rejected attack %u on cooldown"), *GetName(), Request.ProjectileId);
+		if (!IsLocallyControlled())
+		{
+			ClientRejectAttack(Request.ProjectileId, Abilities->GetChargesFullAtMs(PRIMARY_ATTACK_ABILITY));
+		}
+		return;
+	}
+
+	// Swings start from the server character, only the aim and the fire time come from the client
+	if (bMeleeAttack)
+	{
+		MeleeAttack->StartSwing(Request.Direction, RewindSeconds);
+		return;
+	}
+
+	// Trust the client origin only as long as it is close to where the server thinks we are
+	FVector Origin = Request.Origin;
+	if (FVector::DistSquared(Origin, GetActorLocation()) > FMath::Square(MaxAttackOriginError))
+	{
+		UE_LOG(LogUnrealTest, Verbose, TEXT("%s: rejected attack origin %s"), *GetName(), *Origin.ToString());
+		Origin = GetActorLocation() + Request.Direction * MuzzleOffset;
+	}
+
+	const FTransform SpawnTransform(Request.Direction.Rotation(), Origin);
+	UUnrealTestActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UUnrealTestActorPoolSubsystem>();
+	AUnrealTestProjectile* Projectile = Pool ? Pool->AcquireActor(ProjectileClass, SpawnTransform, this, this) : nullptr;
+	if (Projectile == nullptr)
+	{
+		return;
+	}
+	Projectile->SetProjectileId(Request.ProjectileId);
+
+	// Catch the projectile up with where it already is on the shooter's screen
+	if (!IsLocallyControlled())
+	{
+		Projectile->FastForward(RewindSeconds);
+	}
+}
+
+void AUnrealTestCharacter::ClientRejectAttack_Implementation(uint32 ProjectileId, int32 ChargesFullAtMs)
+{
+	// The server timestamp didn't change, so it won't replicate over the predicted one by itself
+	Abilities->ResyncAbility(PRIMARY_ATTACK_ABILITY, ChargesFullAtMs);
+
+#if !UE_SERVER
+	if (AUnrealTestProjectile* Prediction = TakePredictedProjectile(ProjectileId))
+	{
+		Prediction->Release();
+	}
+#endif
+}
+
+float AUnrealTestCharacter::GetAttackRewindSeconds(const FUnrealTestAttackRequest& Request) const
+{
+	const float HalfRoundTripSeconds = GetHalfRoundTripSeconds();
+	const float RewindSeconds = GetRewindSeconds(Request, GetWorld()->GetTimeSeconds(), HalfRoundTripSeconds);
+	if (Request.ClientFireTime <= 0.0)
+	{
+		return RewindSeconds;
+	}
+
+	SET_FLOAT_STAT(STAT_UnrealTest_AttackRewind, RewindSeconds * 1000.f);
+	SET_FLOAT_STAT(STAT_UnrealTest_AttackRewindError, (RewindSeconds - HalfRoundTripSeconds) * 1000.f);
+	UE_LOG(LogUnrealTest, Verbose, TEXT("%s: attack rewind %.1f ms, half round trip %.1f ms"), *GetName(), RewindSeconds * 1000.f, HalfRoundTripSeconds * 1000.f);
+
+	return RewindSeconds;
+}
+
+float AUnrealTestCharacter::GetRewindSeconds(const FUnrealTestAttackRequest& Request, double ServerTime, float HalfRoundTripSeconds)
+{
+	if (Request.ClientFireTime <= 0.0)
+	{
+		return HalfRoundTripSeconds;
+	}
+
+	// Fire times from the future are clamped
+	return float(FMath::Max(ServerTime - Request.ClientFireTime, 0.0));
+}
+
+#if !UE_SERVER
+void AUnrealTestCharacter::SpawnPredictedProjectile(const FUnrealTestAttackRequest& Request)
+{
+	const FTransform SpawnTransform(Request.Direction.Rotation(), Request.Origin);
+	UUnrealTestActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UUnrealTestActorPoolSubsystem>();
+	AUnrealTestProjectile* Projectile = Pool ? Pool->AcquireActor(ProjectileClass, SpawnTransform, this, this) : nullptr;
+	if (Projectile == nullptr)
+	{
+		return;
+	}
+
+	Projectile->MarkAsPredicted();
+	Projectile->SetProjectileId(Request.ProjectileId);
+
+	// Drop predictions the server never answered before tracking the new one,
+	// pooled projectiles stay valid so those went back to the pool or were reused for another shot
+	for (auto It = PredictedProjectiles.CreateIterator(); It; ++It)
+	{
+		if (!IsPredictionPending(It->Key, It->Value.Get()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	PredictedProjectiles.Add(Request.ProjectileId, Projectile);
+}
+
+AUnrealTestProjectile* AUnrealTestCharacter::TakePredictedProjectile(uint32 ProjectileId)
+{
+	TWeakObjectPtr<AUnrealTestProjectile> Projectile;
+	PredictedProjectiles.RemoveAndCopyValue(ProjectileId, Projectile);
+	return IsPredictionPending(ProjectileId, Projectile.Get()) ? Projectile.Get() : nullptr;
+}
+
+bool AUnrealTestCharacter::IsPredictionPending(uint32 ProjectileId, const AUnrealTestProjectile* Projectile)
+{
+	return IsValid(Projectile) && Projectile->IsPoolActive() && Projectile->GetProjectileId() == ProjectileId;
+}
+#endif
+
+float AUnrealTestCharacter::GetHalfRoundTripSeconds() const
+{
+	const APlayerState* State = GetPlayerState();
+	return State ? State->GetPingInMilliseconds() * 0.0005f : 0.f;
 }
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Character/UnrealTestMovementSettings.h"
+
+const FUnrealTestMovementTuning& UUnrealTestMovementSettings::GetTuning(FName ChampionName) const
+{
+	const FUnrealTestMovementTuning* Tuning = ChampionTunings.Find(ChampionName);
+	return Tuning ? *Tuning : DefaultTuning;
+}
+
+void UUnrealTestMovementSettings::GetChampionTunings(TArray<FUnrealTestChampionMovementTuning>& OutTunings) const
+{
+	OutTunings.Reset(ChampionTunings.Num() + 1);
+
+	FUnrealTestChampionMovementTuning& Default = OutTunings.AddDefaulted_GetRef();
+	Default.ChampionName = NAME_None;
+	Default.Tuning = DefaultTuning;
+
+	for (const TPair<FName, FUnrealTestMovementTuning>& Pair : ChampionTunings)
+	{
+		FUnrealTestChampionMovementTuning& Champion = OutTunings.AddDefaulted_GetRef();
+		Champion.ChampionName = Pair.Key;
+		Champion.Tuning = Pair.Value;
+	}
+}
@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Character/UnrealTestSkeletalMeshComponent.h"
+
+void UUnrealTestSkeletalMeshComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// Covers the animation update, and the evaluation too when it doesn't run on a worker thread
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	GameThreadCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void UUnrealTestSkeletalMeshComponent::FinalizeBoneTransform()
+{
+	// Back on the game thread after a parallel evaluation: notifies, bone transforms and bounds
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	Super::FinalizeBoneTransform();
+	GameThreadCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+uint64 UUnrealTestSkeletalMeshComponent::ConsumeGameThreadCycles()
+{
+	const uint64 Cycles = GameThreadCycles;
+	GameThreadCycles = 0;
+	return Cycles;
+}
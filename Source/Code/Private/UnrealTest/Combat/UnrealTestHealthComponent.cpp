@@ -0,0 +1,276 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Combat/UnrealTestHealthComponent.h"
+#include "UnrealTest/Game/UnrealTestGameMode.h"
+#include "UnrealTest/Game/UnrealTestTimerSubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Controller.h"
+#include "Net/UnrealNetwork.h"
+
+//////////////////////////////////////////////////////////////////////////
+// FUnrealTestStatusEffect
+
+void FUnrealTestStatusEffect::PostReplicatedAdd(const FUnrealTestStatusEffectArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnStatusEffectChanged.Broadcast(InArraySerializer.Owner, Name);
+	}
+}
+
+void FUnrealTestStatusEffect::PostReplicatedChange(const FUnrealTestStatusEffectArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnStatusEffectChanged.Broadcast(InArraySerializer.Owner, Name);
+	}
+}
+
+void FUnrealTestStatusEffect::PreReplicatedRemove(const FUnrealTestStatusEffectArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnStatusEffectChanged.Broadcast(InArraySerializer.Owner, Name);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UUnrealTestHealthComponent
+
+UUnrealTestHealthComponent::UUnrealTestHealthComponent()
+{
+	// Everything happens in response to damage or to the gameplay timers
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicatedByDefault(true);
+
+	MaxHealth = MAX_HEALTH;
+	Health = MAX_HEALTH;
+	Shield = 0.f;
+	bDead = false;
+	StatusEffects.Owner = this;
+}
+
+void UUnrealTestHealthComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Health = MaxHealth;
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		GetOwner()->OnTakeAnyDamage.AddDynamic(this, &UUnrealTestHealthComponent::HandleTakeAnyDamage);
+
+		if (AUnrealTestGameMode* GameMode = GetWorld()->GetAuthGameMode<AUnrealTestGameMode>())
+		{
+			GameMode->RegisterRoundResettable(this);
+		}
+	}
+}
+
+void UUnrealTestHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The timers outlive the component otherwise, they would only find a dead delegate when they fire
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		ClearStatusEffects();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UUnrealTestHealthComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UUnrealTestHealthComponent, Health);
+	DOREPLIFETIME(UUnrealTestHealthComponent, Shield);
+	DOREPLIFETIME(UUnrealTestHealthComponent, bDead);
+	DOREPLIFETIME(UUnrealTestHealthComponent, StatusEffects);
+}
+
+void UUnrealTestHealthComponent::ResetForNewRound()
+{
+	ClearStatusEffects();
+
+	const bool bWasDead = bDead;
+	Health = MaxHealth;
+	Shield = 0.f;
+	bDead = false;
+	OnHealthChanged.Broadcast(this);
+
+	if (bWasDead)
+	{
+		OnRevived.Broadcast(this);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Damage
+
+void UUnrealTestHealthComponent::HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser)
+{
+	ApplyDamage(Damage, InstigatedBy);
+}
+
+void UUnrealTestHealthComponent::ApplyDamage(float Amount, AController* DamageInstigator)
+{
+	if (bDead || Amount <= 0.f || GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const float Absorbed = FMath::Min(Shield, Amount);
+	Shield -= Absorbed;
+	Health = FMath::Max(Health - (Amount - Absorbed), 0.f);
+	OnHealthChanged.Broadcast(this);
+
+	if (Health <= 0.f)
+	{
+		Die(DamageInstigator);
+	}
+}
+
+void UUnrealTestHealthComponent::AddShield(float Amount)
+{
+	if (bDead || Amount <= 0.f || GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	Shield += Amount;
+	OnHealthChanged.Broadcast(this);
+}
+
+void UUnrealTestHealthComponent::Die(AController* Killer)
+{
+	bDead = true;
+	ClearStatusEffects();
+
+	UE_LOG(LogUnrealTest, Verbose, TEXT("%s killed by %s"), *GetNameSafe(GetOwner()), *GetNameSafe(Killer));
+	OnDeath.Broadcast(this, Killer);
+}
+
+void UUnrealTestHealthComponent::OnRep_Health()
+{
+	OnHealthChanged.Broadcast(this);
+}
+
+void UUnrealTestHealthComponent::OnRep_Dead()
+{
+	if (bDead)
+	{
+		OnDeath.Broadcast(this, nullptr);
+	}
+	else
+	{
+		OnRevived.Broadcast(this);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Status effects
+
+void UUnrealTestHealthComponent::ApplyStatusEffect(const FUnrealTestStatusEffectSpec& Spec, AController* EffectInstigator)
+{
+	UUnrealTestTimerSubsystem* Timers = GetTimers();
+	if (bDead || Timers == nullptr || Spec.Name.IsNone() || GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	FUnrealTestStatusEffect* Effect = StatusEffects.Items.FindByPredicate([&Spec](const FUnrealTestStatusEffect& Item) { return Item.Name == Spec.Name; });
+	if (Effect == nullptr)
+	{
+		Effect = &StatusEffects.Items.AddDefaulted_GetRef();
+		Effect->Name = Spec.Name;
+	}
+
+	// Refreshing restarts the duration and the tick period
+	Timers->Cancel(Effect->ExpiryTimer);
+	Timers->Cancel(Effect->TickTimer);
+
+	Effect->EndTime = GetWorld()->GetTimeSeconds() + Spec.Duration;
+	Effect->DamagePerTick = Spec.DamagePerTick;
+	Effect->TickInterval = Spec.TickInterval;
+	Effect->Instigator = EffectInstigator;
+
+	Effect->ExpiryTimer = Timers->Schedule(Spec.Duration, FSimpleDelegate::CreateUObject(this, &UUnrealTestHealthComponent::OnStatusEffectExpired, Spec.Name));
+	if (Spec.DamagePerTick > 0.f)
+	{
+		Effect->TickTimer = Timers->Schedule(Spec.TickInterval, FSimpleDelegate::CreateUObject(this, &UUnrealTestHealthComponent::OnStatusEffectTick, Spec.Name));
+	}
+
+	StatusEffects.MarkItemDirty(*Effect);
+	OnStatusEffectChanged.Broadcast(this, Spec.Name);
+}
+
+void UUnrealTestHealthComponent::RemoveStatusEffect(FName EffectName)
+{
+	const int32 Index = StatusEffects.Items.IndexOfByPredicate([EffectName](const FUnrealTestStatusEffect& Item) { return Item.Name == EffectName; });
+	if (Index == INDEX_NONE || GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	if (UUnrealTestTimerSubsystem* Timers = GetTimers())
+	{
+		Timers->Cancel(StatusEffects.Items[Index].ExpiryTimer);
+		Timers->Cancel(StatusEffects.Items[Index].TickTimer);
+	}
+
+	StatusEffects.Items.RemoveAtSwap(Index);
+	StatusEffects.MarkArrayDirty();
+	OnStatusEffectChanged.Broadcast(this, EffectName);
+}
+
+bool UUnrealTestHealthComponent::HasStatusEffect(FName EffectName) const
+{
+	return StatusEffects.Items.ContainsByPredicate([EffectName](const FUnrealTestStatusEffect& Item) { return Item.Name == EffectName; });
+}
+
+void UUnrealTestHealthComponent::OnStatusEffectTick(FName EffectName)
+{
+	FUnrealTestStatusEffect* Effect = StatusEffects.Items.FindByPredicate([EffectName](const FUnrealTestStatusEffect& Item) { return Item.Name == EffectName; });
+	UUnrealTestTimerSubsystem* Timers = GetTimers();
+	if (Effect == nullptr || Timers == nullptr)
+	{
+		return;
+	}
+
+	// Reschedule before dealing the damage, dying clears the effects and cancels the new timer with them
+	Effect->TickTimer = Timers->Schedule(Effect->TickInterval, FSimpleDelegate::CreateUObject(this, &UUnrealTestHealthComponent::OnStatusEffectTick, EffectName));
+	ApplyDamage(Effect->DamagePerTick, Effect->Instigator.Get());
+}
+
+void UUnrealTestHealthComponent::OnStatusEffectExpired(FName EffectName)
+{
+	RemoveStatusEffect(EffectName);
+}
+
+void UUnrealTestHealthComponent::ClearStatusEffects()
+{
+	if (StatusEffects.Items.Num() == 0)
+	{
+		return;
+	}
+
+	if (UUnrealTestTimerSubsystem* Timers = GetTimers())
+	{
+		for (FUnrealTestStatusEffect& Effect : StatusEffects.Items)
+		{
+			Timers->Cancel(Effect.ExpiryTimer);
+			Timers->Cancel(Effect.TickTimer);
+		}
+	}
+
+	StatusEffects.Items.Reset();
+	StatusEffects.MarkArrayDirty();
+}
+
+UUnrealTestTimerSubsystem* UUnrealTestHealthComponent::GetTimers() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UUnrealTestTimerSubsystem>() : nullptr;
+}
@@ -0,0 +1,335 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Combat/UnrealTestHitboxHistoryComponent.h"
+#include "UnrealTest/Combat/UnrealTestLagCompensationSubsystem.h"
+#include "UnrealTest/Memory/UnrealTestFrameArena.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+UUnrealTestHitboxHistoryComponent::UUnrealTestHitboxHistoryComponent()
+{
+	// Record after movement so the sample matches what gets replicated this frame
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+
+	MaxRewindSeconds = MAX_REWIND_SECONDS;
+	MaxBoneHistoryBytes = MAX_BONE_HISTORY_BYTES;
+	BoneHitboxReach = BONE_HITBOX_REACH;
+	Head = INDEX_NONE;
+	NumSamples = 0;
+	bHittable = true;
+}
+
+void UUnrealTestHitboxHistoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Only the server rewinds hitboxes
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	InitBonePoints();
+
+	// Keep fewer samples rather than going over the memory budget of the bone history
+	int32 Capacity = HISTORY_CAPACITY;
+	const int32 BytesPerSample = BonePoints.Num() * sizeof(FUnrealTestQuantizedBonePosition);
+	if (BonePoints.Num() > 0 && MaxBoneHistoryBytes / BytesPerSample < 2)
+	{
+		// Rewinding needs two samples to interpolate between, below that only the movement capsule is rewound
+		UE_LOG(LogUnrealTest, Warning, TEXT("%s: %d bytes of bone history can't hold two samples of %d bytes, only its capsule is rewound"),
+			*GetNameSafe(GetOwner()), MaxBoneHistoryBytes, BytesPerSample);
+		BonePoints.Reset();
+		BoneHitboxPoints.Reset();
+	}
+
+	if (BonePoints.Num() > 0)
+	{
+		Capacity = FMath::Min(MaxBoneHistoryBytes / BytesPerSample, HISTORY_CAPACITY);
+		BoneSamples.SetNumZeroed(Capacity * BonePoints.Num());
+
+		UE_LOG(LogUnrealTest, Verbose, TEXT("%s records %d bones in %d samples, %d bytes"),
+			*GetNameSafe(GetOwner()), BonePoints.Num(), Capacity, BoneSamples.Num() * BoneSamples.GetTypeSize());
+	}
+
+	Samples.SetNumZeroed(Capacity);
+
+	// Dead or pooled before play began
+	if (!bHittable)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	if (UUnrealTestLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UUnrealTestLagCompensationSubsystem>())
+	{
+		LagCompensation->RegisterHitbox(this);
+	}
+}
+
+void UUnrealTestHitboxHistoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UUnrealTestLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UUnrealTestLagCompensationSubsystem>())
+	{
+		LagCompensation->UnregisterHitbox(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UUnrealTestHitboxHistoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	RecordSample();
+}
+
+void UUnrealTestHitboxHistoryComponent::InitBonePoints()
+{
+	BonePoints.Reset();
+	BoneHitboxPoints.Reset();
+
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	const USkeletalMeshComponent* Mesh = Character ? Character->GetMesh() : nullptr;
+	if (Mesh == nullptr || BoneHitboxes.Num() == 0)
+	{
+		return;
+	}
+
+	auto FindPoint = [this, Mesh](FName Bone)
+	{
+		const int32 BoneIndex = Mesh->GetBoneIndex(Bone);
+		if (BoneIndex == INDEX_NONE)
+		{
+			UE_LOG(LogUnrealTest, Warning, TEXT("%s has no bone %s for its bone hitboxes"), *GetNameSafe(GetOwner()), *Bone.ToString());
+			return int32(INDEX_NONE);
+		}
+		return BonePoints.AddUnique(BoneIndex);
+	};
+
+	for (const FUnrealTestBoneHitbox& BoneHitbox : BoneHitboxes)
+	{
+		const int32 StartPoint = FindPoint(BoneHitbox.Bone);
+		const int32 EndPoint = BoneHitbox.EndBone.IsNone() ? INDEX_NONE : FindPoint(BoneHitbox.EndBone);
+
+		// Hitboxes still line up with BoneHitboxes, a missing bone only makes its hitbox impossible to hit
+		BoneHitboxPoints.Emplace(StartPoint, EndPoint);
+	}
+}
+
+void UUnrealTestHitboxHistoryComponent::RecordSample()
+{
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	const UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+	if (Capsule == nullptr)
+	{
+		return;
+	}
+
+	Head = (Head + 1) % Samples.Num();
+	NumSamples = FMath::Min(NumSamples + 1, Samples.Num());
+
+	FUnrealTestHitboxSample& Sample = Samples[Head];
+	Sample.Time = GetWorld()->GetTimeSeconds();
+	Sample.Center = Capsule->GetComponentLocation();
+	Sample.Radius = Capsule->GetScaledCapsuleRadius();
+	Sample.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+
+	if (BonePoints.Num() == 0)
+	{
+		return;
+	}
+
+	// Read the pose the mesh already has, the animation budget decides how often the server refreshes it
+	const USkeletalMeshComponent* Mesh = Character->GetMesh();
+	const float MaxOffset = float(MAX_int16) / BONE_POSITION_SCALE;
+	FUnrealTestQuantizedBonePosition* Positions = &BoneSamples[Head * BonePoints.Num()];
+	for (int32 PointIndex = 0; PointIndex < BonePoints.Num(); ++PointIndex)
+	{
+		const FVector Offset = Mesh->GetBoneTransform(BonePoints[PointIndex]).GetLocation() - Sample.Center;
+		Positions[PointIndex].X = int16(FMath::RoundToInt(FMath::Clamp(float(Offset.X), -MaxOffset, MaxOffset) * BONE_POSITION_SCALE));
+		Positions[PointIndex].Y = int16(FMath::RoundToInt(FMath::Clamp(float(Offset.Y), -MaxOffset, MaxOffset) * BONE_POSITION_SCALE));
+		Positions[PointIndex].Z = int16(FMath::RoundToInt(FMath::Clamp(float(Offset.Z), -MaxOffset, MaxOffset) * BONE_POSITION_SCALE));
+	}
+}
+
+const FUnrealTestHitboxSample& UUnrealTestHitboxHistoryComponent::GetSample(int32 AgeIndex) const
+{
+	// AgeIndex 0 is the newest sample
+	return Samples[(Head - AgeIndex + Samples.Num()) % Samples.Num()];
+}
+
+bool UUnrealTestHitboxHistoryComponent::FindSamples(double Time, int32& OutNewerAge, int32& OutOlderAge, float& OutAlpha) const
+{
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	const double OldestAllowedTime = GetSample(0).Time - MaxRewindSeconds;
+	Time = FMath::Max(Time, OldestAllowedTime);
+
+	OutNewerAge = 0;
+	OutOlderAge = 0;
+	OutAlpha = 1.f;
+
+	if (Time >= GetSample(0).Time)
+	{
+		return true;
+	}
+
+	for (int32 AgeIndex = 1; AgeIndex < NumSamples; ++AgeIndex)
+	{
+		const FUnrealTestHitboxSample& Older = GetSample(AgeIndex);
+		if (Older.Time <= Time)
+		{
+			const FUnrealTestHitboxSample& Newer = GetSample(AgeIndex - 1);
+			OutNewerAge = AgeIndex - 1;
+			OutOlderAge = AgeIndex;
+			OutAlpha = (Newer.Time > Older.Time) ? float((Time - Older.Time) / (Newer.Time - Older.Time)) : 1.f;
+			return true;
+		}
+	}
+
+	OutNewerAge = NumSamples - 1;
+	OutOlderAge = NumSamples - 1;
+	return true;
+}
+
+bool UUnrealTestHitboxHistoryComponent::GetHitboxAtTime(double Time, FUnrealTestHitboxSample& OutSample) const
+{
+	int32 NewerAge;
+	int32 OlderAge;
+	float Alpha;
+	if (!FindSamples(Time, NewerAge, OlderAge, Alpha))
+	{
+		return false;
+	}
+
+	const FUnrealTestHitboxSample& Older = GetSample(OlderAge);
+	const FUnrealTestHitboxSample& Newer = GetSample(NewerAge);
+	if (NewerAge == OlderAge)
+	{
+		OutSample = Newer;
+		return true;
+	}
+
+	OutSample.Time = FMath::Lerp(Older.Time, Newer.Time, Alpha);
+	OutSample.Center = FMath::Lerp(Older.Center, Newer.Center, Alpha);
+	OutSample.Radius = FMath::Lerp(Older.Radius, Newer.Radius, Alpha);
+	OutSample.HalfHeight = FMath::Lerp(Older.HalfHeight, Newer.HalfHeight, Alpha);
+	return true;
+}
+
+bool UUnrealTestHitboxHistoryComponent::SweepBoneHitboxes(double Time, const FVector& Start, const FVector& End, float Radius, FUnrealTestRewindHit& OutHit) const
+{
+	int32 NewerAge;
+	int32 OlderAge;
+	float Alpha;
+	if (BonePoints.Num() == 0 || !FindSamples(Time, NewerAge, OlderAge, Alpha))
+	{
+		return false;
+	}
+
+	const FUnrealTestHitboxSample& Older = GetSample(OlderAge);
+	const FUnrealTestHitboxSample& Newer = GetSample(NewerAge);
+	const FVector Center = FMath::Lerp(Older.Center, Newer.Center, Alpha);
+
+	const int32 NumPoints = BonePoints.Num();
+	const int32 NumCapacity = Samples.Num();
+	const FUnrealTestQuantizedBonePosition* OlderPositions = &BoneSamples[((Head - OlderAge + NumCapacity) % NumCapacity) * NumPoints];
+	const FUnrealTestQuantizedBonePosition* NewerPositions = &BoneSamples[((Head - NewerAge + NumCapacity) % NumCapacity) * NumPoints];
+
+	TArray<FVector, FUnrealTestFrameAllocator> Points;
+	Points.SetNumUninitialized(NumPoints);
+	for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+	{
+		const FUnrealTestQuantizedBonePosition& From = OlderPositions[PointIndex];
+		const FUnrealTestQuantizedBonePosition& To = NewerPositions[PointIndex];
+		const FVector Offset(
+			FMath::Lerp(float(From.X), float(To.X), Alpha),
+			FMath::Lerp(float(From.Y), float(To.Y), Alpha),
+			FMath::Lerp(float(From.Z), float(To.Z), Alpha));
+		Points[PointIndex] = Center + Offset / BONE_POSITION_SCALE;
+	}
+
+	const float SegmentLength = FVector::Dist(Start, End);
+	bool bHit = false;
+
+	for (int32 HitboxIndex = 0; HitboxIndex < BoneHitboxes.Num(); ++HitboxIndex)
+	{
+		const TPair<int32, int32>& HitboxPoints = BoneHitboxPoints[HitboxIndex];
+		if (HitboxPoints.Key == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FUnrealTestBoneHitbox& BoneHitbox = BoneHitboxes[HitboxIndex];
+		const FVector& BoneStart = Points[HitboxPoints.Key];
+		const FVector& BoneEnd = HitboxPoints.Value != INDEX_NONE ? Points[HitboxPoints.Value] : BoneStart;
+
+		FVector PointOnSweep;
+		FVector PointOnBone;
+		FMath::SegmentDistToSegmentSafe(Start, End, BoneStart, BoneEnd, PointOnSweep, PointOnBone);
+
+		if (FVector::DistSquared(PointOnSweep, PointOnBone) > FMath::Square(Radius + BoneHitbox.Radius))
+		{
+			continue;
+		}
+
+		const float HitTime = SegmentLength > KINDA_SMALL_NUMBER ? FVector::Dist(Start, PointOnSweep) / SegmentLength : 0.f;
+		if (!bHit || HitTime < OutHit.Time)
+		{
+			bHit = true;
+			OutHit.Actor = GetOwner();
+			OutHit.Time = HitTime;
+			OutHit.Normal = (PointOnSweep - PointOnBone).GetSafeNormal(KINDA_SMALL_NUMBER, FVector::UpVector);
+			OutHit.Location = PointOnBone + OutHit.Normal * BoneHitbox.Radius;
+			OutHit.BoneName = BoneHitbox.Bone;
+			OutHit.DamageMultiplier = BoneHitbox.DamageMultiplier;
+		}
+	}
+
+	return bHit;
+}
+
+void UUnrealTestHitboxHistoryComponent::ClearHistory()
+{
+	Head = INDEX_NONE;
+	NumSamples = 0;
+}
+
+void UUnrealTestHitboxHistoryComponent::SetHittable(bool bInHittable)
+{
+	if (bHittable == bInHittable)
+	{
+		return;
+	}
+	bHittable = bInHittable;
+
+	if (!HasBegunPlay() || GetOwnerRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	// Samples from before would bridge the time the owner was out of play
+	ClearHistory();
+	SetComponentTickEnabled(bHittable);
+
+	if (UUnrealTestLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UUnrealTestLagCompensationSubsystem>())
+	{
+		if (bHittable)
+		{
+			LagCompensation->RegisterHitbox(this);
+		}
+		else
+		{
+			LagCompensation->UnregisterHitbox(this);
+		}
+	}
+}
@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Combat/UnrealTestLagCompensationSubsystem.h"
+#include "UnrealTest/Combat/UnrealTestHitboxHistoryComponent.h"
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+void UUnrealTestLagCompensationSubsystem::RegisterHitbox(UUnrealTestHitboxHistoryComponent* Hitbox)
+{
+	Hitboxes.AddUnique(Hitbox);
+}
+
+void UUnrealTestLagCompensationSubsystem::UnregisterHitbox(UUnrealTestHitboxHistoryComponent* Hitbox)
+{
+	Hitboxes.RemoveSingleSwap(Hitbox);
+}
+
+bool UUnrealTestLagCompensationSubsystem::SweepSphereRewound(const FVector& Start, const FVector& End, float Radius, double RewindTime, const AActor* IgnoreActor, FUnrealTestRewindHit& OutHit) const
+{
+	const float SegmentLength = FVector::Dist(Start, End);
+	bool bHit = false;
+
+	for (const TWeakObjectPtr<UUnrealTestHitboxHistoryComponent>& HitboxPtr : Hitboxes)
+	{
+		const UUnrealTestHitboxHistoryComponent* Hitbox = HitboxPtr.Get();
+		if (Hitbox == nullptr || !Hitbox->IsHittable() || Hitbox->GetOwner() == IgnoreActor)
+		{
+			continue;
+		}
+
+		FUnrealTestHitboxSample Sample;
+		if (!Hitbox->GetHitboxAtTime(RewindTime, Sample))
+		{
+			continue;
+		}
+
+		// Characters are upright capsules: a swept sphere touches one when the distance
+		// between the sweep segment and the capsule axis is below the summed radii
+		const float AxisHalfLength = FMath::Max(Sample.HalfHeight - Sample.Radius, 0.f);
+		const FVector AxisTop = Sample.Center + FVector(0.f, 0.f, AxisHalfLength);
+		const FVector AxisBottom = Sample.Center - FVector(0.f, 0.f, AxisHalfLength);
+
+		FVector PointOnSweep;
+		FVector PointOnAxis;
+		FMath::SegmentDistToSegmentSafe(Start, End, AxisBottom, AxisTop, PointOnSweep, PointOnAxis);
+
+		// With bone hitboxes the capsule is only a broadphase, grown by how far limbs may reach out of it
+		const bool bHasBoneHitboxes = Hitbox->HasBoneHitboxes();
+		const float CombinedRadius = Radius + Sample.Radius + (bHasBoneHitboxes ? Hitbox->BoneHitboxReach : 0.f);
+		if (FVector::DistSquared(PointOnSweep, PointOnAxis) > FMath::Square(CombinedRadius))
+		{
+			continue;
+		}
+
+		if (bHasBoneHitboxes)
+		{
+			FUnrealTestRewindHit BoneHit;
+			if (Hitbox->SweepBoneHitboxes(RewindTime, Start, End, Radius, BoneHit) && (!bHit || BoneHit.Time < OutHit.Time))
+			{
+				bHit = true;
+				OutHit = BoneHit;
+			}
+			continue;
+		}
+
+		const float HitTime = SegmentLength > KINDA_SMALL_NUMBER ? FVector::Dist(Start, PointOnSweep) / SegmentLength : 0.f;
+		if (!bHit || HitTime < OutHit.Time)
+		{
+			bHit = true;
+			OutHit.Actor = Hitbox->GetOwner();
+			OutHit.Time = HitTime;
+			OutHit.Normal = (PointOnSweep - PointOnAxis).GetSafeNormal(KINDA_SMALL_NUMBER, FVector::UpVector);
+			OutHit.Location = PointOnAxis + OutHit.Normal * Sample.Radius;
+			OutHit.BoneName = NAME_None;
+			OutHit.DamageMultiplier = 1.f;
+		}
+	}
+
+	return bHit;
+}
+
+void UUnrealTestLagCompensationSubsystem::GatherHitboxesRewound(const FVector& Center, float Radius, double RewindTime, const AActor* IgnoreActor, TArray<FUnrealTestRewoundHitbox, FUnrealTestFrameAllocator>& OutHitboxes) const
+{
+	const UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>();
+	if (SpatialHash == nullptr)
+	{
+		return;
+	}
+
+	// The hash holds current locations, characters were anywhere they could run to since the rewind time
+	const float SearchRadius = Radius + MAX_CAPSULE_EXTENT + MAX_REWIND_TRAVEL;
+	TArray<int32, FUnrealTestFrameAllocator> Candidates;
+	Candidates.SetNumUninitialized(FMath::Max(SpatialHash->GetNumPawns(), 1));
+	Candidates.SetNum(SpatialHash->QueryRadius(Center, SearchRadius, Candidates), false);
+
+	for (const int32 Candidate : Candidates)
+	{
+		const APawn* Pawn = SpatialHash->GetPawn(Candidate);
+		const UUnrealTestHitboxHistoryComponent* Hitbox = Pawn ? Pawn->FindComponentByClass<UUnrealTestHitboxHistoryComponent>() : nullptr;
+		if (Hitbox == nullptr || !Hitbox->IsHittable() || Pawn == IgnoreActor)
+		{
+			continue;
+		}
+
+		FUnrealTestHitboxSample Sample;
+		if (!Hitbox->GetHitboxAtTime(RewindTime, Sample))
+		{
+			continue;
+		}
+
+		// Distance from the center to the capsule axis, minus the capsule radius
+		const float AxisHalfLength = FMath::Max(Sample.HalfHeight - Sample.Radius, 0.f);
+		const FVector ClosestOnAxis(Sample.Center.X, Sample.Center.Y, FMath::Clamp(Center.Z, Sample.Center.Z - AxisHalfLength, Sample.Center.Z + AxisHalfLength));
+		if (FVector::DistSquared(Center, ClosestOnAxis) > FMath::Square(Radius + Sample.Radius))
+		{
+			continue;
+		}
+
+		FUnrealTestRewoundHitbox& Rewound = OutHitboxes.AddDefaulted_GetRef();
+		Rewound.Actor = Hitbox->GetOwner();
+		Rewound.Sample = Sample;
+	}
+}
@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Combat/UnrealTestMeleeAttackComponent.h"
+#include "UnrealTest/Combat/UnrealTestLagCompensationSubsystem.h"
+#include "UnrealTest/Net/UnrealTestNetPrioritizerSubsystem.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Swing"), STAT_UnrealTest_MeleeSwing, STATGROUP_UnrealTest);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Melee Blade Tests"), STAT_UnrealTest_MeleeBladeTests, STATGROUP_UnrealTest);
+
+UUnrealTestMeleeAttackComponent::UUnrealTestMeleeAttackComponent()
+{
+	// Only ticks while a swing runs, after movement so the blade follows the owner of this frame
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+
+	SwingSeconds = SWING_SECONDS;
+	SwingArcDegrees = SWING_ARC_DEGREES;
+	Reach = REACH;
+	BladeRadius = BLADE_RADIUS;
+	Damage = DAMAGE;
+	MaxTargetsPerSwing = MAX_TARGETS_PER_SWING;
+	MaxStepsPerTick = MAX_STEPS_PER_TICK;
+
+	SwingDirection = FVector::ForwardVector;
+	SwingStartTime = 0.0;
+	SwingRewindSeconds = 0.f;
+	SweptProgress = 0.f;
+	bSwinging = false;
+}
+
+bool UUnrealTestMeleeAttackComponent::StartSwing(const FVector& AimDirection, float RewindSeconds)
+{
+	if (bSwinging || GetOwnerRole() != ROLE_Authority)
+	{
+		return false;
+	}
+
+	// Swings stay horizontal, the aim only picks the center of the arc
+	SwingDirection = FVector(AimDirection.X, AimDirection.Y, 0.f).GetSafeNormal(KINDA_SMALL_NUMBER, GetOwner()->GetActorForwardVector());
+	SwingStartTime = GetWorld()->GetTimeSeconds();
+	SwingRewindSeconds = RewindSeconds;
+	SweptProgress = -1.f;
+	HitActors.Reset();
+	bSwinging = true;
+
+	// The first blade position is tested right away
+	AdvanceSwing();
+	SetComponentTickEnabled(bSwinging);
+	return true;
+}
+
+void UUnrealTestMeleeAttackComponent::CancelSwing()
+{
+	bSwinging = false;
+	HitActors.Reset();
+	SetComponentTickEnabled(false);
+}
+
+void UUnrealTestMeleeAttackComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	AdvanceSwing();
+	if (!bSwinging)
+	{
+		SetComponentTickEnabled(false);
+	}
+}
+
+float UUnrealTestMeleeAttackComponent::GetBladeAngle(float Progress) const
+{
+	return SwingArcDegrees * (Progress - 0.5f);
+}
+
+void UUnrealTestMeleeAttackComponent::AdvanceSwing()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_MeleeSwing);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float Progress = FMath::Clamp(float(Now - SwingStartTime) / SwingSeconds, 0.f, 1.f);
+	const bool bFirstTest = SweptProgress < 0.f;
+	const float FromProgress = FMath::Max(SweptProgress, 0.f);
+	SweptProgress = Progress;
+	if (Progress >= 1.f)
+	{
+		bSwinging = false;
+	}
+
+	const UUnrealTestLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UUnrealTestLagCompensationSubsystem>();
+	if (LagCompensation == nullptr)
+	{
+		return;
+	}
+
+	// Rewind every character in reach once, then test every blade step against that short list
+	const FVector Pivot = GetOwner()->GetActorLocation();
+	TArray<FUnrealTestRewoundHitbox, FUnrealTestFrameAllocator> Candidates;
+	LagCompensation->GatherHitboxesRewound(Pivot, Reach + BladeRadius, Now - SwingRewindSeconds, GetOwner(), Candidates);
+	if (Candidates.Num() == 0)
+	{
+		return;
+	}
+
+	// Enough steps for the blade tip to never skip over a target, within the per tick cap
+	const float SweptTipLength = FMath::DegreesToRadians(SwingArcDegrees * (Progress - FromProgress)) * Reach;
+	const int32 NumSteps = Progress > FromProgress ? FMath::Clamp(FMath::CeilToInt(SweptTipLength / FMath::Max(BladeRadius, 1.f)), 1, MaxStepsPerTick) : 0;
+
+	// The blade position the last tick ended on was already tested
+	int32 NumTests = 0;
+	for (int32 Step = bFirstTest ? 0 : 1; Step <= NumSteps; ++Step)
+	{
+		const float StepProgress = NumSteps > 0 ? FMath::Lerp(FromProgress, Progress, float(Step) / NumSteps) : Progress;
+		const FVector BladeDirection = SwingDirection.RotateAngleAxis(GetBladeAngle(StepProgress), FVector::UpVector);
+		const FVector BladeEnd = Pivot + BladeDirection * Reach;
+
+		for (const FUnrealTestRewoundHitbox& Candidate : Candidates)
+		{
+			if (HitActors.Contains(Candidate.Actor))
+			{
+				continue;
+			}
+
+			const FUnrealTestHitboxSample& Sample = Candidate.Sample;
+			const float AxisHalfLength = FMath::Max(Sample.HalfHeight - Sample.Radius, 0.f);
+			const FVector AxisTop = Sample.Center + FVector(0.f, 0.f, AxisHalfLength);
+			const FVector AxisBottom = Sample.Center - FVector(0.f, 0.f, AxisHalfLength);
+
+			FVector PointOnBlade;
+			FVector PointOnAxis;
+			FMath::SegmentDistToSegmentSafe(Pivot, BladeEnd, AxisBottom, AxisTop, PointOnBlade, PointOnAxis);
+			++NumTests;
+
+			if (FVector::DistSquared(PointOnBlade, PointOnAxis) > FMath::Square(BladeRadius + Sample.Radius))
+			{
+				continue;
+			}
+
+			const FVector HitNormal = (PointOnBlade - PointOnAxis).GetSafeNormal(KINDA_SMALL_NUMBER, -BladeDirection);
+			ApplyHit(Candidate.Actor, Pivot, BladeEnd, PointOnAxis + HitNormal * Sample.Radius);
+			if (HitActors.Num() >= MaxTargetsPerSwing)
+			{
+				bSwinging = false;
+				INC_DWORD_STAT_BY(STAT_UnrealTest_MeleeBladeTests, NumTests);
+				return;
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_UnrealTest_MeleeBladeTests, NumTests);
+}
+
+void UUnrealTestMeleeAttackComponent::ApplyHit(AActor* Target, const FVector& BladeStart, const FVector& BladeEnd, const FVector& HitLocation)
+{
+	HitActors.Add(Target);
+
+	const FVector ShotDirection = (HitLocation - BladeStart).GetSafeNormal();
+	FHitResult Hit(Target, nullptr, HitLocation, -ShotDirection);
+	Hit.TraceStart = BladeStart;
+	Hit.TraceEnd = BladeEnd;
+
+	APawn* Attacker = GetOwner<APawn>();
+	UGameplayStatics::ApplyPointDamage(Target, Damage, ShotDirection, Hit, Attacker ? Attacker->GetController() : nullptr, GetOwner(), nullptr);
+
+	// Attacker and target now matter to each other more than anybody else around
+	if (UUnrealTestNetPrioritizerSubsystem* NetPrioritizer = GetWorld()->GetSubsystem<UUnrealTestNetPrioritizerSubsystem>())
+	{
+		NetPrioritizer->NotifyCombat(GetOwner(), Target);
+	}
+}
@@ -0,0 +1,413 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Combat/UnrealTestProjectile.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Combat/UnrealTestHitboxHistoryComponent.h"
+#include "UnrealTest/Combat/UnrealTestLagCompensationSubsystem.h"
+#include "UnrealTest/Game/UnrealTestActorPoolSubsystem.h"
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "UnrealTest/Game/UnrealTestTimerSubsystem.h"
+#include "UnrealTest/Memory/UnrealTestFrameArena.h"
+#include "UnrealTest/Net/UnrealTestNetPrioritizerSubsystem.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Fast Forward"), STAT_UnrealTest_ProjectileFastForward, STATGROUP_UnrealTest);
+
+AUnrealTestProjectile::AUnrealTestProjectile()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	bReplicates = true;
+	SetReplicateMovement(true);
+
+	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
+	CollisionComponent->InitSphereRadius(COLLISION_RADIUS);
+	CollisionComponent->SetCollisionProfileName(TEXT("Projectile"));
+	CollisionComponent->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+	CollisionComponent->SetGenerateOverlapEvents(true);
+	CollisionComponent->OnComponentHit.AddDynamic(this, &AUnrealTestProjectile::OnProjectileHit);
+	CollisionComponent->OnComponentBeginOverlap.AddDynamic(this, &AUnrealTestProjectile::OnProjectileOverlap);
+	RootComponent = CollisionComponent;
+
+	VisualRoot = CreateDefaultSubobject<USceneComponent>(TEXT("VisualRoot"));
+	VisualRoot->SetupAttachment(CollisionComponent);
+
+	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovement"));
+	ProjectileMovement->UpdatedComponent = CollisionComponent;
+	ProjectileMovement->InitialSpeed = INITIAL_SPEED;
+	ProjectileMovement->MaxSpeed = INITIAL_SPEED;
+	ProjectileMovement->bRotationFollowsVelocity = true;
+	ProjectileMovement->bShouldBounce = false;
+	ProjectileMovement->ProjectileGravityScale = 0.f;
+
+	Damage = DAMAGE;
+	ExplosionRadius = 0.f;
+	ExplosionDamage = 0.f;
+	FastForwardStepSeconds = FAST_FORWARD_STEP_SECONDS;
+	MaxFastForwardSeconds = MAX_FAST_FORWARD_SECONDS;
+	ReconcileBlendSeconds = RECONCILE_BLEND_SECONDS;
+
+	ProjectileId = 0;
+	bPoolActive = true;
+	ActivationCount = 0;
+	ReconciledActivation = 0;
+	bIsPredicted = false;
+	VisualOffset = FVector::ZeroVector;
+	VisualOffsetTimeRemaining = 0.f;
+}
+
+void AUnrealTestProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AUnrealTestProjectile, ProjectileId);
+	DOREPLIFETIME(AUnrealTestProjectile, bPoolActive);
+	DOREPLIFETIME(AUnrealTestProjectile, ActivationCount);
+}
+
+void AUnrealTestProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (AActor* ProjectileInstigator = GetInstigator())
+	{
+		CollisionComponent->IgnoreActorWhenMoving(ProjectileInstigator, true);
+	}
+
+	// Replicated properties of the initial bunch are already set when a client begins play
+	if (GetLocalRole() == ROLE_SimulatedProxy && ActivationCount != ReconciledActivation)
+	{
+		ReconcileWithPrediction();
+	}
+}
+
+void AUnrealTestProjectile::MarkAsPredicted()
+{
+	bIsPredicted = true;
+	SetReplicates(false);
+}
+
+void AUnrealTestProjectile::OnAcquiredFromPool()
+{
+	check(HasAuthority());
+
+	CollisionComponent->ClearMoveIgnoreActors();
+	if (APawn* ProjectileInstigator = GetInstigator())
+	{
+		CollisionComponent->IgnoreActorWhenMoving(ProjectileInstigator, true);
+	}
+
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+
+	// The pool only hands out the actor, the shooter sets the id of the shot right after
+	ProjectileId = 0;
+	bPoolActive = true;
+	++ActivationCount;
+	ApplyPoolState();
+
+	// Shots in flight are many and short lived, the timing wheel keeps them out of the timer manager
+	if (UUnrealTestTimerSubsystem* Timers = GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>())
+	{
+		LifeTimerHandle = Timers->Schedule(LIFE_SPAN, FSimpleDelegate::CreateUObject(this, &AUnrealTestProjectile::Release));
+	}
+}
+
+void AUnrealTestProjectile::OnReleasedToPool()
+{
+	check(HasAuthority());
+
+	if (UUnrealTestTimerSubsystem* Timers = GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>())
+	{
+		Timers->Cancel(LifeTimerHandle);
+	}
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+	CollisionComponent->ClearMoveIgnoreActors();
+
+	bPoolActive = false;
+	ApplyPoolState();
+}
+
+void AUnrealTestProjectile::OnRep_PoolState()
+{
+	ApplyPoolState();
+
+	if (bPoolActive && ActivationCount != ReconciledActivation)
+	{
+		ReconcileWithPrediction();
+	}
+}
+
+void AUnrealTestProjectile::ApplyPoolState()
+{
+	SetActorHiddenInGame(!bPoolActive);
+	SetActorEnableCollision(bPoolActive);
+
+	if (!bPoolActive)
+	{
+		VisualOffsetTimeRemaining = 0.f;
+		VisualRoot->SetRelativeLocation(FVector::ZeroVector);
+		SetActorTickEnabled(false);
+	}
+}
+
+void AUnrealTestProjectile::Release()
+{
+	if (UUnrealTestActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UUnrealTestActorPoolSubsystem>())
+	{
+		Pool->ReleaseActor(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AUnrealTestProjectile::FastForward(float Seconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_ProjectileFastForward);
+
+	check(HasAuthority());
+
+	const float ForwardSeconds = FMath::Min(Seconds, MaxFastForwardSeconds);
+	if (ForwardSeconds <= 0.f)
+	{
+		return;
+	}
+
+	const UWorld* World = GetWorld();
+	const UUnrealTestLagCompensationSubsystem* LagCompensation = World->GetSubsystem<UUnrealTestLagCompensationSubsystem>();
+
+	const int32 NumSteps = FMath::Max(1, FMath::CeilToInt(ForwardSeconds / FastForwardStepSeconds));
+	const float StepSeconds = ForwardSeconds / NumSteps;
+	const double FireTime = World->GetTimeSeconds() - ForwardSeconds;
+	const float GravityZ = ProjectileMovement->GetGravityZ();
+	const float Radius = CollisionComponent->GetScaledSphereRadius();
+
+	FVector Location = GetActorLocation();
+	FVector Velocity = ProjectileMovement->Velocity;
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		const FVector NewVelocity = Velocity + FVector(0.f, 0.f, GravityZ * StepSeconds);
+		const FVector NewLocation = Location + (Velocity + NewVelocity) * 0.5f * StepSeconds;
+		const double StepEndTime = FireTime + (Step + 1) * StepSeconds;
+
+		FHitResult WorldHit;
+		const bool bWorldHit = SweepWorld(Location, NewLocation, WorldHit);
+
+		FUnrealTestRewindHit RewindHit;
+		const bool bRewindHit = LagCompensation && LagCompensation->SweepSphereRewound(Location, NewLocation, Radius, StepEndTime, GetInstigator(), RewindHit);
+
+		if (bRewindHit && (!bWorldHit || RewindHit.Time <= WorldHit.Time))
+		{
+			const FVector ImpactDirection = (NewLocation - Location).GetSafeNormal();
+			FHitResult Hit(RewindHit.Actor.Get(), nullptr, RewindHit.Location, RewindHit.Normal);
+			Hit.TraceStart = Location;
+			Hit.TraceEnd = NewLocation;
+			Hit.Time = RewindHit.Time;
+			Hit.BoneName = RewindHit.BoneName;
+			SetActorLocation(FMath::Lerp(Location, NewLocation, RewindHit.Time));
+			HandleImpact(RewindHit.Actor.Get(), Hit, RewindHit.DamageMultiplier);
+			return;
+		}
+
+		if (bWorldHit)
+		{
+			SetActorLocation(WorldHit.Location);
+			HandleImpact(WorldHit.GetActor(), WorldHit);
+			return;
+		}
+
+		Location = NewLocation;
+		Velocity = NewVelocity;
+	}
+
+	SetActorLocation(Location);
+	ProjectileMovement->Velocity = Velocity;
+}
+
+bool AUnrealTestProjectile::SweepWorld(const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+	// Characters are tested against their rewound hitboxes, here we only care about the arena
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(UnrealTestProjectileFastForward), false, this);
+	QueryParams.AddIgnoredActor(GetInstigator());
+
+	return GetWorld()->SweepSingleByObjectType(OutHit, Start, End, FQuat::Identity, ObjectParams, FCollisionShape::MakeSphere(CollisionComponent->GetScaledSphereRadius()), QueryParams);
+}
+
+void AUnrealTestProjectile::OnProjectileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	HandleImpact(OtherActor, Hit);
+}
+
+void AUnrealTestProjectile::OnProjectileOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (!bPoolActive || OtherActor == nullptr || OtherActor == GetInstigator())
+	{
+		return;
+	}
+
+	// Overlaps found without a sweep, e.g. when handed out of the pool inside a pawn, have no impact of their own
+	FHitResult Hit = SweepResult;
+	if (!bFromSweep)
+	{
+		Hit = FHitResult(OtherActor, OtherComp, GetActorLocation(), -ProjectileMovement->Velocity.GetSafeNormal());
+		Hit.TraceStart = GetActorLocation();
+		Hit.TraceEnd = GetActorLocation() + ProjectileMovement->Velocity.GetSafeNormal();
+	}
+
+	float DamageMultiplier = 1.f;
+	if (HasAuthority() && !bIsPredicted && !ResolveBoneHit(OtherActor, Hit, DamageMultiplier))
+	{
+		return;
+	}
+
+	HandleImpact(OtherActor, Hit, DamageMultiplier);
+}
+
+bool AUnrealTestProjectile::ResolveBoneHit(AActor* HitActor, FHitResult& InOutHit, float& OutDamageMultiplier) const
+{
+	const UUnrealTestHitboxHistoryComponent* Hitbox = HitActor->FindComponentByClass<UUnrealTestHitboxHistoryComponent>();
+	if (Hitbox == nullptr || !Hitbox->HasBoneHitboxes())
+	{
+		return true;
+	}
+
+	// From where the projectile started this move to past the far side of the capsule, limbs sticking out included.
+	// The projectile flies in the server's present, so the bones are taken as they are now
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+	HitActor->GetSimpleCollisionCylinder(CapsuleRadius, CapsuleHalfHeight);
+	const FVector Direction = ProjectileMovement->Velocity.GetSafeNormal();
+	const FVector Start = InOutHit.TraceStart;
+	const FVector End = InOutHit.Location + Direction * 2.f * (FMath::Max(CapsuleRadius, CapsuleHalfHeight) + Hitbox->BoneHitboxReach);
+
+	FUnrealTestRewindHit BoneHit;
+	if (!Hitbox->SweepBoneHitboxes(GetWorld()->GetTimeSeconds(), Start, End, CollisionComponent->GetScaledSphereRadius(), BoneHit))
+	{
+		return false;
+	}
+
+	InOutHit = FHitResult(HitActor, nullptr, BoneHit.Location, BoneHit.Normal);
+	InOutHit.TraceStart = Start;
+	InOutHit.TraceEnd = End;
+	InOutHit.Time = BoneHit.Time;
+	InOutHit.BoneName = BoneHit.BoneName;
+	OutDamageMultiplier = BoneHit.DamageMultiplier;
+	return true;
+}
+
+void AUnrealTestProjectile::HandleImpact(AActor* HitActor, const FHitResult& Hit, float DamageMultiplier)
+{
+	if (HasAuthority() && !bIsPredicted && ExplosionRadius > 0.f)
+	{
+		Explode(Hit.Location, HitActor);
+	}
+
+	if (HasAuthority() && !bIsPredicted && HitActor != nullptr && HitActor != GetInstigator())
+	{
+		const FVector ShotDirection = (Hit.TraceEnd - Hit.TraceStart).GetSafeNormal();
+		UGameplayStatics::ApplyPointDamage(HitActor, Damage * DamageMultiplier, ShotDirection, Hit, GetInstigatorController(), this, nullptr);
+
+		// Shooter and target now matter to each other more than anybody else around
+		if (UUnrealTestNetPrioritizerSubsystem* NetPrioritizer = GetWorld()->GetSubsystem<UUnrealTestNetPrioritizerSubsystem>())
+		{
+			NetPrioritizer->NotifyCombat(GetInstigator(), HitActor);
+		}
+	}
+
+	// Clients only get rid of their predictions, the server tells them about the rest
+	if (HasAuthority() || bIsPredicted)
+	{
+		Release();
+	}
+}
+
+void AUnrealTestProjectile::Explode(const FVector& Location, const AActor* HitActor)
+{
+	// One query against the spatial hash instead of an overlap against the physics scene
+	const UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>();
+	if (SpatialHash == nullptr)
+	{
+		return;
+	}
+
+	UUnrealTestNetPrioritizerSubsystem* NetPrioritizer = GetWorld()->GetSubsystem<UUnrealTestNetPrioritizerSubsystem>();
+	TArray<int32, FUnrealTestFrameAllocator> Victims;
+	Victims.SetNumUninitialized(FMath::Max(SpatialHash->GetNumPawns(), 1));
+	Victims.SetNum(SpatialHash->QueryRadius(Location, ExplosionRadius, Victims), false);
+
+	for (const int32 Victim : Victims)
+	{
+		APawn* Pawn = SpatialHash->GetPawn(Victim);
+		if (Pawn == nullptr || Pawn == HitActor || Pawn == GetInstigator())
+		{
+			continue;
+		}
+
+		const FVector ToVictim = SpatialHash->GetLocation(Victim) - Location;
+		const float Falloff = 1.f - FMath::Clamp(ToVictim.Size() / ExplosionRadius, 0.f, 1.f);
+		FHitResult Hit(Pawn, nullptr, Location, -ToVictim.GetSafeNormal());
+		UGameplayStatics::ApplyPointDamage(Pawn, ExplosionDamage * Falloff, ToVictim.GetSafeNormal(), Hit, GetInstigatorController(), this, nullptr);
+		if (NetPrioritizer)
+		{
+			NetPrioritizer->NotifyCombat(GetInstigator(), Pawn);
+		}
+	}
+}
+
+void AUnrealTestProjectile::ReconcileWithPrediction()
+{
+	ReconciledActivation = ActivationCount;
+
+	// Only clients predict projectiles
+#if !UE_SERVER
+	AUnrealTestCharacter* Shooter = Cast<AUnrealTestCharacter>(GetInstigator());
+	if (Shooter == nullptr || !Shooter->IsLocallyControlled())
+	{
+		return;
+	}
+
+	AUnrealTestProjectile* Prediction = Shooter->TakePredictedProjectile(ProjectileId);
+	if (Prediction == nullptr)
+	{
+		return;
+	}
+
+	// Start drawn where the player already sees the shot and slide onto the authoritative path
+	VisualOffset = Prediction->VisualRoot->GetComponentLocation() - GetActorLocation();
+	VisualOffsetTimeRemaining = ReconcileBlendSeconds;
+	VisualRoot->SetWorldLocation(GetActorLocation() + VisualOffset);
+	SetActorTickEnabled(true);
+
+	Prediction->Release();
+#endif
+}
+
+void AUnrealTestProjectile::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	VisualOffsetTimeRemaining = FMath::Max(VisualOffsetTimeRemaining - DeltaSeconds, 0.f);
+	const float Alpha = ReconcileBlendSeconds > 0.f ? VisualOffsetTimeRemaining / ReconcileBlendSeconds : 0.f;
+	VisualRoot->SetWorldLocation(GetActorLocation() + VisualOffset * Alpha);
+
+	if (VisualOffsetTimeRemaining <= 0.f)
+	{
+		VisualRoot->SetRelativeLocation(FVector::ZeroVector);
+		SetActorTickEnabled(false);
+	}
+}
@@ -0,0 +1,246 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestActorPoolSubsystem.h"
+#include "UnrealTest/Game/UnrealTestPoolable.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors Active"), STAT_UnrealTest_PooledActorsActive, STATGROUP_UnrealTest);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors Free"), STAT_UnrealTest_PooledActorsFree, STATGROUP_UnrealTest);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors High Water Mark"), STAT_UnrealTest_PooledActorsHighWater, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Actors Spawned On Demand"), STAT_UnrealTest_PooledActorsSpawned, STATGROUP_UnrealTest);
+
+void UUnrealTestActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	for (const FUnrealTestActorPoolPrewarm& Entry : PrewarmPools)
+	{
+		if (UClass* ActorClass = Entry.ActorClass.LoadSynchronous())
+		{
+			Prewarm(ActorClass, Entry.Count);
+		}
+	}
+}
+
+AActor* UUnrealTestActorPoolSubsystem::AcquireActor(UClass* ActorClass, const FTransform& Transform, AActor* ActorOwner, APawn* ActorInstigator)
+{
+	if (ActorClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	FUnrealTestActorPool& Pool = Pools.FindOrAdd(ActorClass);
+
+	AActor* Actor = nullptr;
+	while (Actor == nullptr && Pool.Free.Num() > 0)
+	{
+		Actor = Pool.Free.Pop(false);
+		Actor = IsValid(Actor) ? Actor : nullptr;
+	}
+
+	if (Actor == nullptr)
+	{
+		Actor = SpawnPooledActor(ActorClass, Transform);
+		if (Actor == nullptr)
+		{
+			return nullptr;
+		}
+
+		++Pool.NumSpawnedOnDemand;
+		INC_DWORD_STAT(STAT_UnrealTest_PooledActorsSpawned);
+		UE_LOG(LogUnrealTest, Verbose, TEXT("Actor pool of %s was empty, spawned %s"), *ActorClass->GetName(), *Actor->GetName());
+	}
+
+	Actor->SetOwner(ActorOwner);
+	Actor->SetInstigator(ActorInstigator);
+	Actor->SetActorLocationAndRotation(Transform.GetLocation(), Transform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	// Waking up flushes the dormant channels, clients that kept the actor reuse it with the new state
+	if (Actor->GetIsReplicated())
+	{
+		Actor->SetNetDormancy(DORM_Awake);
+	}
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+
+	TArray<TWeakObjectPtr<UActorComponent>> TickingComponents;
+	if (Pool.ParkedTickingComponents.RemoveAndCopyValue(Actor, TickingComponents))
+	{
+		for (const TWeakObjectPtr<UActorComponent>& Component : TickingComponents)
+		{
+			if (Component.IsValid())
+			{
+				Component->SetComponentTickEnabled(true);
+			}
+		}
+	}
+
+	if (IUnrealTestPoolable* Poolable = Cast<IUnrealTestPoolable>(Actor))
+	{
+		Poolable->OnAcquiredFromPool();
+	}
+	Actor->ForceNetUpdate();
+
+	Pool.Active.Add(Actor);
+	Pool.HighWaterMark = FMath::Max(Pool.HighWaterMark, Pool.Active.Num());
+	UpdateStats();
+	return Actor;
+}
+
+void UUnrealTestActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	FUnrealTestActorPool* Pool = Actor ? Pools.Find(Actor->GetClass()) : nullptr;
+	if (Pool == nullptr || Pool->Active.RemoveSingleSwap(Actor, false) == 0)
+	{
+		return;
+	}
+
+	Deactivate(Actor, *Pool);
+	UpdateStats();
+}
+
+void UUnrealTestActorPoolSubsystem::ReleaseAllActors()
+{
+	for (TPair<UClass*, FUnrealTestActorPool>& Pair : Pools)
+	{
+		FUnrealTestActorPool& Pool = Pair.Value;
+		while (Pool.Active.Num() > 0)
+		{
+			AActor* Actor = Pool.Active.Pop(false);
+			if (IsValid(Actor))
+			{
+				Deactivate(Actor, Pool);
+			}
+		}
+	}
+
+	UpdateStats();
+}
+
+void UUnrealTestActorPoolSubsystem::Prewarm(UClass* ActorClass, int32 Count)
+{
+	if (ActorClass == nullptr || Count <= 0 || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	FUnrealTestActorPool& Pool = Pools.FindOrAdd(ActorClass);
+	Pool.Free.Reserve(Pool.Free.Num() + Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		if (AActor* Actor = SpawnPooledActor(ActorClass, FTransform::Identity))
+		{
+			Deactivate(Actor, Pool);
+		}
+	}
+
+	UpdateStats();
+}
+
+AActor* UUnrealTestActorPoolSubsystem::SpawnPooledActor(UClass* ActorClass, const FTransform& Transform)
+{
+	AActor* Actor = GetWorld()->SpawnActorDeferred<AActor>(ActorClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Actor == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Actors a client spawns exist only there
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		Actor->SetReplicates(false);
+	}
+
+	Actor->FinishSpawning(Transform);
+	return Actor;
+}
+
+void UUnrealTestActorPoolSubsystem::Deactivate(AActor* Actor, FUnrealTestActorPool& Pool)
+{
+	if (IUnrealTestPoolable* Poolable = Cast<IUnrealTestPoolable>(Actor))
+	{
+		Poolable->OnReleasedToPool();
+	}
+
+	GetWorld()->GetTimerManager().ClearAllTimersForObject(Actor);
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+	Actor->SetOwner(nullptr);
+	Actor->SetInstigator(nullptr);
+
+	// Components tick on their own, such as the movement and the mesh of a parked NPC
+	TArray<TWeakObjectPtr<UActorComponent>>& TickingComponents = Pool.ParkedTickingComponents.FindOrAdd(Actor);
+	TickingComponents.Reset();
+	Actor->ForEachComponent(false, [&TickingComponents](UActorComponent* Component)
+	{
+		if (Component->IsComponentTickEnabled())
+		{
+			Component->SetComponentTickEnabled(false);
+			TickingComponents.Add(Component);
+		}
+	});
+
+	// The dormant channels send this last state before closing, so clients see the actor go away.
+	// Hidden without collision it isn't relevant either, connections that never had it don't get it
+	if (Actor->GetIsReplicated())
+	{
+		Actor->ForceNetUpdate();
+		Actor->SetNetDormancy(DORM_DormantAll);
+	}
+
+	Pool.Free.Add(Actor);
+}
+
+void UUnrealTestActorPoolSubsystem::UpdateStats() const
+{
+	int32 NumActive = 0;
+	int32 NumFree = 0;
+	int32 HighWaterMark = 0;
+	for (const TPair<UClass*, FUnrealTestActorPool>& Pair : Pools)
+	{
+		NumActive += Pair.Value.Active.Num();
+		NumFree += Pair.Value.Free.Num();
+		HighWaterMark += Pair.Value.HighWaterMark;
+	}
+
+	SET_DWORD_STAT(STAT_UnrealTest_PooledActorsActive, NumActive);
+	SET_DWORD_STAT(STAT_UnrealTest_PooledActorsFree, NumFree);
+	SET_DWORD_STAT(STAT_UnrealTest_PooledActorsHighWater, HighWaterMark);
+}
+
+void UUnrealTestActorPoolSubsystem::DumpPools() const
+{
+	UE_LOG(LogUnrealTest, Display, TEXT("Actor pools of %s:"), *GetWorld()->GetMapName());
+	for (const TPair<UClass*, FUnrealTestActorPool>& Pair : Pools)
+	{
+		const FUnrealTestActorPool& Pool = Pair.Value;
+		UE_LOG(LogUnrealTest, Display, TEXT("  %s: %d active, %d free, high water mark %d, %d spawned on demand"),
+			*GetNameSafe(Pair.Key), Pool.Active.Num(), Pool.Free.Num(), Pool.HighWaterMark, Pool.NumSpawnedOnDemand);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Debug
+
+static FAutoConsoleCommandWithWorld DumpActorPoolsCommand(
+	TEXT("UnrealTest.ActorPool.Dump"),
+	TEXT("Logs the active and free actors, high water mark and on demand spawns of every actor pool. A warm pool spawns nothing on demand."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		if (const UUnrealTestActorPoolSubsystem* ActorPool = World ? World->GetSubsystem<UUnrealTestActorPoolSubsystem>() : nullptr)
+		{
+			ActorPool->DumpPools();
+		}
+	}));
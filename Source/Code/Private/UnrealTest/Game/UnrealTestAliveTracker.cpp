@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestAliveTracker.h"
+
+void FUnrealTestAliveTracker::MarkAlive(FObjectKey Player, int32 Team)
+{
+	if (Team < 0 || Team >= MAX_TEAMS)
+	{
+		MarkDead(Player);
+		return;
+	}
+
+	if (const int32* CurrentTeam = AliveTeamOfPlayer.Find(Player))
+	{
+		if (*CurrentTeam == Team)
+		{
+			return;
+		}
+		MarkDead(Player);
+	}
+
+	AliveTeamOfPlayer.Add(Player, Team);
+	AliveCounts[Team]++;
+	AliveTeamMask |= 1u << Team;
+}
+
+bool FUnrealTestAliveTracker::MarkDead(FObjectKey Player)
+{
+	int32 Team = INDEX_NONE;
+	if (!AliveTeamOfPlayer.RemoveAndCopyValue(Player, Team))
+	{
+		return false;
+	}
+
+	check(AliveCounts[Team] > 0);
+	if (--AliveCounts[Team] > 0)
+	{
+		return false;
+	}
+
+	AliveTeamMask &= ~(1u << Team);
+	return true;
+}
+
+void FUnrealTestAliveTracker::Reset()
+{
+	AliveTeamOfPlayer.Reset();
+	FMemory::Memzero(AliveCounts);
+	AliveTeamMask = 0;
+}
+
+bool FUnrealTestAliveTracker::IsAlive(FObjectKey Player) const
+{
+	return AliveTeamOfPlayer.Contains(Player);
+}
+
+int32 FUnrealTestAliveTracker::GetLastTeamStanding() const
+{
+	return GetNumAliveTeams() == 1 ? int32(FMath::CountTrailingZeros(AliveTeamMask)) : INDEX_NONE;
+}
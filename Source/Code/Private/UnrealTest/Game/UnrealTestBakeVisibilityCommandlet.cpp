@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestBakeVisibilityCommandlet.h"
+#include "UnrealTest/Game/UnrealTestVisibilityGrid.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+
+UUnrealTestBakeVisibilityCommandlet::UUnrealTestBakeVisibilityCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UUnrealTestBakeVisibilityCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogUnrealTest, Error, TEXT("Usage: -run=UnrealTestBakeVisibility -Map=/Game/Path/To/Map [-CellSize=400] [-Margin=2000] [-EyeHeight=160]"));
+		return 1;
+	}
+
+	float CellSize = CELL_SIZE;
+	float Margin = MARGIN;
+	float EyeHeight = EYE_HEIGHT;
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	FParse::Value(*Params, TEXT("Margin="), Margin);
+	FParse::Value(*Params, TEXT("EyeHeight="), EyeHeight);
+
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (World == nullptr)
+	{
+		UE_LOG(LogUnrealTest, Error, TEXT("%s is not a map"), *MapName);
+		return 1;
+	}
+
+	// Only collision is needed to trace against the level
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.InitializeScenes(false)
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true));
+	}
+	World->UpdateWorldComponents(true, false);
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+	const double StartTime = FPlatformTime::Seconds();
+	FUnrealTestVisibilityGrid Grid;
+	Grid.Bake(World, CellSize, Margin, EyeHeight);
+
+	int32 Result = 0;
+	const FString Filename = FUnrealTestVisibilityGrid::GetFilename(World->GetMapName());
+	if (!Grid.IsLoaded())
+	{
+		UE_LOG(LogUnrealTest, Error, TEXT("%s has no player starts to bake the visibility around"), *MapName);
+		Result = 1;
+	}
+	else if (!Grid.Save(Filename))
+	{
+		UE_LOG(LogUnrealTest, Error, TEXT("Could not write %s"), *Filename);
+		Result = 1;
+	}
+	else
+	{
+		UE_LOG(LogUnrealTest, Display, TEXT("Baked the visibility of %s into %s in %.1f s"), *MapName, *Filename, FPlatformTime::Seconds() - StartTime);
+	}
+
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+	return Result;
+}
@@ -2,6 +2,19 @@
 
 #include "UnrealTest/Game/UnrealTestGameMode.h"
 #include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Combat/UnrealTestHealthComponent.h"
+#include "UnrealTest/Game/UnrealTestActorPoolSubsystem.h"
+#include "UnrealTest/Game/UnrealTestMatchmakingComponent.h"
+#include "UnrealTest/Game/UnrealTestPlayerState.h"
+#include "UnrealTest/Game/UnrealTestRoundResettable.h"
+#include "UnrealTest/Game/UnrealTestSpawnSelectionSubsystem.h"
+#include "UnrealTest/Game/UnrealTestTimerSubsystem.h"
+#include "UnrealTest/Game/UnrealTestWaveSpawnerComponent.h"
+#include "UnrealTest/Player/UnrealTestPlayerController.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 #include "UObject/ConstructorHelpers.h"
 
 AUnrealTestGameMode::AUnrealTestGameMode()
@@ -12,4 +25,289 @@ AUnrealTestGameMode::AUnrealTestGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	GameStateClass = AUnrealTestGameState::StaticClass();
+	PlayerControllerClass = AUnrealTestPlayerController::StaticClass();
+	PlayerStateClass = AUnrealTestPlayerState::StaticClass();
+
+	Matchmaking = CreateDefaultSubobject<UUnrealTestMatchmakingComponent>(TEXT("Matchmaking"));
+	WaveSpawner = CreateDefaultSubobject<UUnrealTestWaveSpawnerComponent>(TEXT("WaveSpawner"));
+
+	MinPlayersToStart = MIN_PLAYERS_TO_START;
+	WarmupSeconds = WARMUP_SECONDS;
+	RoundTimeLimitSeconds = ROUND_TIME_LIMIT_SECONDS;
+	RoundEndSeconds = ROUND_END_SECONDS;
+
+	bVictoryCheckPending = false;
+}
+
+void AUnrealTestGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	SetMatchPhase(EUnrealTestMatchPhase::WaitingForPlayers, 0.f);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &AUnrealTestGameMode::OnWorldPostActorTick);
+}
+
+void AUnrealTestGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AUnrealTestGameMode::PostLogin(APlayerController* NewPlayer)
+{
+	// The team is needed before the player's first pawn spawns, so it is counted alive in it
+	Matchmaking->AddPlayer(NewPlayer->GetPlayerState<AUnrealTestPlayerState>());
+
+	Super::PostLogin(NewPlayer);
+
+	if (GetMatchPhase() == EUnrealTestMatchPhase::WaitingForPlayers)
+	{
+		TryStartWarmup();
+	}
+}
+
+void AUnrealTestGameMode::Logout(AController* Exiting)
+{
+	NotifyPlayerDied(Exiting);
+	Matchmaking->RemovePlayer(Exiting->GetPlayerState<AUnrealTestPlayerState>());
+
+	Super::Logout(Exiting);
+}
+
+void AUnrealTestGameMode::FinishRestartPlayer(AController* NewPlayer, const FRotator& StartRotation)
+{
+	Super::FinishRestartPlayer(NewPlayer, StartRotation);
+
+	TrackAlivePlayer(NewPlayer);
+}
+
+AActor* AUnrealTestGameMode::ChoosePlayerStart_Implementation(AController* Player)
+{
+	UUnrealTestSpawnSelectionSubsystem* SpawnSelection = GetWorld()->GetSubsystem<UUnrealTestSpawnSelectionSubsystem>();
+	AActor* SpawnPoint = SpawnSelection ? SpawnSelection->ChooseSpawnPoint(Player) : nullptr;
+	return SpawnPoint ? SpawnPoint : Super::ChoosePlayerStart_Implementation(Player);
+}
+
+bool AUnrealTestGameMode::ShouldSpawnAtStartSpot_Implementation(AController* Player)
+{
+	// Every spawn picks a fresh spot away from the enemies of the moment
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Match flow
+
+AUnrealTestGameState* AUnrealTestGameMode::GetUnrealTestGameState() const
+{
+	return GetGameState<AUnrealTestGameState>();
+}
+
+EUnrealTestMatchPhase AUnrealTestGameMode::GetMatchPhase() const
+{
+	const AUnrealTestGameState* State = GetUnrealTestGameState();
+	return State ? State->GetMatchPhase() : EUnrealTestMatchPhase::WaitingForPlayers;
+}
+
+void AUnrealTestGameMode::SetMatchPhase(EUnrealTestMatchPhase NewPhase, double Duration)
+{
+	GetUnrealTestGameState()->SetMatchPhase(NewPhase, Duration);
+
+	UUnrealTestTimerSubsystem* Timers = GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>();
+	Timers->Cancel(PhaseTimerHandle);
+	if (Duration > 0.f)
+	{
+		PhaseTimerHandle = Timers->Schedule(Duration, FSimpleDelegate::CreateUObject(this, &AUnrealTestGameMode::OnPhaseTimeElapsed));
+	}
+}
+
+void AUnrealTestGameMode::OnPhaseTimeElapsed()
+{
+	switch (GetMatchPhase())
+	{
+	case EUnrealTestMatchPhase::Warmup:
+		StartRound();
+		break;
+	case EUnrealTestMatchPhase::InProgress:
+		EndRound(AUnrealTestPlayerState::NO_TEAM);
+		break;
+	case EUnrealTestMatchPhase::RoundEnd:
+		TryStartWarmup();
+		break;
+	default:
+		break;
+	}
+}
+
+void AUnrealTestGameMode::TryStartWarmup()
+{
+	if (GetNumPlayers() < MinPlayersToStart)
+	{
+		SetMatchPhase(EUnrealTestMatchPhase::WaitingForPlayers, 0.f);
+		return;
+	}
+
+	// Teams first, the reset respawns everybody away from their enemies
+	Matchmaking->RebalanceTeams();
+	ResetRound();
+	SetMatchPhase(EUnrealTestMatchPhase::Warmup, WarmupSeconds);
+}
+
+void AUnrealTestGameMode::StartRound()
+{
+	AUnrealTestGameState* State = GetUnrealTestGameState();
+	State->SetRoundNumber(State->GetRoundNumber() + 1);
+	State->SetWinningTeam(AUnrealTestPlayerState::NO_TEAM);
+
+	RebuildAliveCounts();
+	SetMatchPhase(EUnrealTestMatchPhase::InProgress, RoundTimeLimitSeconds);
+	WaveSpawner->StartWaves();
+}
+
+void AUnrealTestGameMode::EndRound(int32 WinningTeam)
+{
+	if (GetMatchPhase() != EUnrealTestMatchPhase::InProgress)
+	{
+		return;
+	}
+
+	WaveSpawner->StopWaves();
+	GetUnrealTestGameState()->SetWinningTeam(WinningTeam);
+	Matchmaking->UpdateSkillRatings(WinningTeam);
+	SetMatchPhase(EUnrealTestMatchPhase::RoundEnd, RoundEndSeconds);
+
+	UE_LOG(LogUnrealTest, Log, TEXT("Round %d ended, winning team %d"), GetUnrealTestGameState()->GetRoundNumber(), WinningTeam);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Last team standing
+
+void AUnrealTestGameMode::RebuildAliveCounts()
+{
+	AliveTracker.Reset();
+	bVictoryCheckPending = false;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		TrackAlivePlayer(It->Get());
+	}
+}
+
+void AUnrealTestGameMode::TrackAlivePlayer(AController* Player)
+{
+	const AUnrealTestPlayerState* State = Player ? Player->GetPlayerState<AUnrealTestPlayerState>() : nullptr;
+	const AUnrealTestCharacter* Character = Player ? Player->GetPawn<AUnrealTestCharacter>() : nullptr;
+	if (State == nullptr || Character == nullptr || Character->GetHealth()->IsDead())
+	{
+		return;
+	}
+
+	AliveTracker.MarkAlive(Player, State->GetTeamId());
 }
+
+void AUnrealTestGameMode::NotifyPlayerDied(AController* Player)
+{
+	// Players that were never counted, or already removed by a death this frame, change nothing
+	if (Player && AliveTracker.MarkDead(Player))
+	{
+		bVictoryCheckPending = true;
+	}
+}
+
+void AUnrealTestGameMode::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || !bVictoryCheckPending)
+	{
+		return;
+	}
+
+	bVictoryCheckPending = false;
+	if (AliveTracker.GetNumAliveTeams() <= 1)
+	{
+		const int32 LastTeam = AliveTracker.GetLastTeamStanding();
+		EndRound(LastTeam != INDEX_NONE ? LastTeam : AUnrealTestPlayerState::NO_TEAM);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Round reset
+
+void AUnrealTestGameMode::RegisterRoundResettable(UObject* Resettable)
+{
+	check(Resettable && Resettable->Implements<UUnrealTestRoundResettable>());
+	RoundResettables.AddUnique(Resettable);
+}
+
+void AUnrealTestGameMode::ResetRound()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Player pawns are moved back to a start spot, only players without one get a new pawn.
+	// NPCs belong to the wave spawner, which puts them back in the actor pool with its reset
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr)
+		{
+			continue;
+		}
+
+		APawn* Pawn = PlayerController->GetPawn();
+		if (Pawn == nullptr)
+		{
+			RestartPlayer(PlayerController);
+			continue;
+		}
+
+		if (const AActor* StartSpot = FindPlayerStart(PlayerController))
+		{
+			const FRotator StartRotation(0.f, StartSpot->GetActorRotation().Yaw, 0.f);
+			Pawn->TeleportTo(StartSpot->GetActorLocation(), StartRotation, false, true);
+			PlayerController->ClientSetRotation(StartRotation, true);
+		}
+	}
+
+	RoundResettables.RemoveAllSwap([](const TWeakObjectPtr<UObject>& Resettable) { return !Resettable.IsValid(); });
+	for (const TWeakObjectPtr<UObject>& Resettable : RoundResettables)
+	{
+		CastChecked<IUnrealTestRoundResettable>(Resettable.Get())->ResetForNewRound();
+	}
+
+	// Last, so pooled actors revived by their own reset still end up hidden and without collision
+	if (UUnrealTestActorPoolSubsystem* ActorPool = GetWorld()->GetSubsystem<UUnrealTestActorPoolSubsystem>())
+	{
+		ActorPool->ReleaseAllActors();
+	}
+
+	UE_LOG(LogUnrealTest, Verbose, TEXT("Round reset took %.2f ms"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Debug
+
+static FAutoConsoleCommandWithWorldAndArgs KillPlayersCommand(
+	TEXT("UnrealTest.Match.KillPlayers"),
+	TEXT("Kills the pawns of every player, or of the players in the given team, in the same frame. Usage: UnrealTest.Match.KillPlayers [Team]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr || World->GetAuthGameMode<AUnrealTestGameMode>() == nullptr)
+		{
+			UE_LOG(LogUnrealTest, Warning, TEXT("UnrealTest.Match.KillPlayers needs to run on the server"));
+			return;
+		}
+
+		const int32 Team = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : AUnrealTestPlayerState::NO_TEAM;
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PlayerController = It->Get();
+			const AUnrealTestPlayerState* State = PlayerController ? PlayerController->GetPlayerState<AUnrealTestPlayerState>() : nullptr;
+			AUnrealTestCharacter* Character = PlayerController ? PlayerController->GetPawn<AUnrealTestCharacter>() : nullptr;
+			if (Character && State && (Team == AUnrealTestPlayerState::NO_TEAM || State->GetTeamId() == Team))
+			{
+				Character->GetHealth()->ApplyDamage(TNumericLimits<float>::Max(), nullptr);
+			}
+		}
+	}));
@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestGameState.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Game/UnrealTestPlayerState.h"
+#include "UnrealTest/Memory/UnrealTestGarbageCollectionSubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Net/UnrealNetwork.h"
+
+AUnrealTestGameState::AUnrealTestGameState()
+{
+	MatchPhase = EUnrealTestMatchPhase::WaitingForPlayers;
+	PhaseEndTime = 0.0;
+	RoundNumber = 0;
+	WinningTeam = AUnrealTestPlayerState::NO_TEAM;
+}
+
+void AUnrealTestGameState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		RefreshMovementTunings();
+	}
+}
+
+void AUnrealTestGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AUnrealTestGameState, MatchPhase);
+	DOREPLIFETIME(AUnrealTestGameState, PhaseEndTime);
+	DOREPLIFETIME(AUnrealTestGameState, RoundNumber);
+	DOREPLIFETIME(AUnrealTestGameState, WinningTeam);
+	DOREPLIFETIME(AUnrealTestGameState, MovementTunings);
+}
+
+void AUnrealTestGameState::SetMatchPhase(EUnrealTestMatchPhase NewPhase, double Duration)
+{
+	MatchPhase = NewPhase;
+	PhaseEndTime = Duration > 0.0 ? GetServerWorldTimeSeconds() + Duration : 0.0;
+	ForceNetUpdate();
+
+	OnRep_MatchPhase();
+}
+
+void AUnrealTestGameState::OnRep_MatchPhase()
+{
+	if (UUnrealTestGarbageCollectionSubsystem* GarbageCollection = GetWorld()->GetSubsystem<UUnrealTestGarbageCollectionSubsystem>())
+	{
+		GarbageCollection->OnMatchPhaseChanged(MatchPhase);
+	}
+}
+
+void AUnrealTestGameState::SetRoundNumber(int32 NewRoundNumber)
+{
+	RoundNumber = NewRoundNumber;
+}
+
+void AUnrealTestGameState::SetWinningTeam(int32 NewWinningTeam)
+{
+	WinningTeam = NewWinningTeam;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Movement tuning
+
+const FUnrealTestMovementTuning& AUnrealTestGameState::GetMovementTuning(FName ChampionName) const
+{
+	// A handful of champions, a linear search beats hashing
+	for (const FUnrealTestChampionMovementTuning& Champion : MovementTunings)
+	{
+		if (Champion.ChampionName == ChampionName)
+		{
+			return Champion.Tuning;
+		}
+	}
+
+	return MovementTunings.Num() > 0 ? MovementTunings[0].Tuning : GetDefault<UUnrealTestMovementSettings>()->GetTuning(ChampionName);
+}
+
+void AUnrealTestGameState::RefreshMovementTunings()
+{
+	GetDefault<UUnrealTestMovementSettings>()->GetChampionTunings(MovementTunings);
+	ApplyMovementTunings();
+
+	// Clients get every champion's tuning in the same update
+	ForceNetUpdate();
+}
+
+void AUnrealTestGameState::ApplyMovementTunings()
+{
+	for (TActorIterator<AUnrealTestCharacter> It(GetWorld()); It; ++It)
+	{
+		It->ApplyMovementTuning(GetMovementTuning(It->ChampionName));
+	}
+}
+
+void AUnrealTestGameState::OnRep_MovementTunings()
+{
+	ApplyMovementTunings();
+}
+
+static FAutoConsoleCommandWithWorld ReloadMovementCommand(
+	TEXT("UnrealTest.Movement.Reload"),
+	TEXT("Rereads the champion movement tuning from Game.ini and pushes it to every pawn on the server and its clients."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		AUnrealTestGameState* GameState = World ? World->GetGameState<AUnrealTestGameState>() : nullptr;
+		if (GameState == nullptr || !GameState->HasAuthority())
+		{
+			UE_LOG(LogUnrealTest, Warning, TEXT("UnrealTest.Movement.Reload needs to run on the server"));
+			return;
+		}
+
+		// Read the files again rather than the values cached at startup
+		FConfigCacheIni::LoadGlobalIniFile(GGameIni, TEXT("Game"), nullptr, true);
+		GetMutableDefault<UUnrealTestMovementSettings>()->ReloadConfig();
+
+		GameState->RefreshMovementTunings();
+		UE_LOG(LogUnrealTest, Display, TEXT("Movement tuning reloaded"));
+	}));
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestMatchmakingComponent.h"
+#include "UnrealTest/Game/UnrealTestPlayerState.h"
+#include "UnrealTest/Game/UnrealTestSkillRatingSaveGame.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+UUnrealTestMatchmakingComponent::UUnrealTestMatchmakingComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	MinTeamSize = MIN_TEAM_SIZE;
+	MaxTeamSize = MAX_TEAM_SIZE;
+	MaxTeams = MAX_TEAMS;
+	DefaultSkillRating = DEFAULT_SKILL_RATING;
+	SkillRatingKFactor = SKILL_RATING_K_FACTOR;
+	SkillRatingSlotName = TEXT("SkillRatings");
+}
+
+void UUnrealTestMatchmakingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FUnrealTestTeamSolverSettings Settings;
+	Settings.MinTeamSize = MinTeamSize;
+	Settings.MaxTeamSize = MaxTeamSize;
+	Settings.MaxTeams = MaxTeams;
+	Solver = FUnrealTestTeamSolver(Settings);
+
+	LoadSkillRatings();
+}
+
+void UUnrealTestMatchmakingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SaveSkillRatings();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UUnrealTestMatchmakingComponent::LoadSkillRatings()
+{
+	if (UGameplayStatics::DoesSaveGameExist(SkillRatingSlotName, 0))
+	{
+		SkillRatings = Cast<UUnrealTestSkillRatingSaveGame>(UGameplayStatics::LoadGameFromSlot(SkillRatingSlotName, 0));
+	}
+
+	if (SkillRatings == nullptr)
+	{
+		SkillRatings = Cast<UUnrealTestSkillRatingSaveGame>(UGameplayStatics::CreateSaveGameObject(UUnrealTestSkillRatingSaveGame::StaticClass()));
+	}
+}
+
+void UUnrealTestMatchmakingComponent::SaveSkillRatings()
+{
+	if (SkillRatings != nullptr)
+	{
+		UGameplayStatics::SaveGameToSlot(SkillRatings, SkillRatingSlotName, 0);
+	}
+}
+
+float UUnrealTestMatchmakingComponent::GetSkillRating(const AUnrealTestPlayerState* PlayerState) const
+{
+	const float* Rating = SkillRatings ? SkillRatings->Ratings.Find(PlayerState->GetSkillRatingKey()) : nullptr;
+	return Rating ? *Rating : DefaultSkillRating;
+}
+
+void UUnrealTestMatchmakingComponent::SetSkillRating(const AUnrealTestPlayerState* PlayerState, float Rating)
+{
+	if (SkillRatings != nullptr)
+	{
+		SkillRatings->Ratings.Add(PlayerState->GetSkillRatingKey(), Rating);
+	}
+}
+
+void UUnrealTestMatchmakingComponent::UpdateSkillRatings(int32 WinningTeam)
+{
+	// Ratings before the round, by team
+	TMap<int32, TPair<float, int32>> TeamRatings;
+	float TotalRating = 0.f;
+	int32 NumRated = 0;
+	for (const AUnrealTestPlayerState* PlayerState : Players)
+	{
+		if (IsValid(PlayerState) && PlayerState->GetTeamId() != AUnrealTestPlayerState::NO_TEAM)
+		{
+			TPair<float, int32>& TeamRating = TeamRatings.FindOrAdd(PlayerState->GetTeamId());
+			const float Rating = GetSkillRating(PlayerState);
+			TeamRating.Key += Rating;
+			TeamRating.Value++;
+			TotalRating += Rating;
+			NumRated++;
+		}
+	}
+
+	if (TeamRatings.Num() < 2)
+	{
+		return;
+	}
+
+	// Every team plays the average of the others, each member wins or loses what the team does
+	TMap<int32, float> TeamChanges;
+	for (const TPair<int32, TPair<float, int32>>& TeamRating : TeamRatings)
+	{
+		const float TeamAverage = TeamRating.Value.Key / TeamRating.Value.Value;
+		const float OthersAverage = (TotalRating - TeamRating.Value.Key) / (NumRated - TeamRating.Value.Value);
+		const float Expected = 1.f / (1.f + FMath::Pow(10.f, (OthersAverage - TeamAverage) / 400.f));
+		const float Score = WinningTeam == AUnrealTestPlayerState::NO_TEAM ? 0.5f : (TeamRating.Key == WinningTeam ? 1.f : 0.f);
+		TeamChanges.Add(TeamRating.Key, SkillRatingKFactor * (Score - Expected));
+	}
+
+	for (const AUnrealTestPlayerState* PlayerState : Players)
+	{
+		const float* Change = IsValid(PlayerState) ? TeamChanges.Find(PlayerState->GetTeamId()) : nullptr;
+		if (Change != nullptr)
+		{
+			SetSkillRating(PlayerState, GetSkillRating(PlayerState) + *Change);
+		}
+	}
+
+	SaveSkillRatings();
+}
+
+FUnrealTestMatchmakingPlayer UUnrealTestMatchmakingComponent::MakeMatchmakingPlayer(const AUnrealTestPlayerState* PlayerState) const
+{
+	FUnrealTestMatchmakingPlayer Player;
+	Player.PlayerId = PlayerState->GetPlayerId();
+	Player.Skill = GetSkillRating(PlayerState);
+	return Player;
+}
+
+void UUnrealTestMatchmakingComponent::AddPlayer(AUnrealTestPlayerState* PlayerState)
+{
+	if (PlayerState == nullptr || Players.Contains(PlayerState))
+	{
+		return;
+	}
+
+	Players.Add(PlayerState);
+	PlayerState->SetTeamId(Solver.AddPlayer(MakeMatchmakingPlayer(PlayerState)));
+}
+
+void UUnrealTestMatchmakingComponent::RemovePlayer(AUnrealTestPlayerState* PlayerState)
+{
+	if (PlayerState == nullptr || Players.RemoveSingleSwap(PlayerState) == 0)
+	{
+		return;
+	}
+
+	Solver.RemovePlayer(PlayerState->GetPlayerId());
+	PlayerState->SetTeamId(AUnrealTestPlayerState::NO_TEAM);
+}
+
+void UUnrealTestMatchmakingComponent::RebalanceTeams()
+{
+	Players.RemoveAllSwap([](const AUnrealTestPlayerState* PlayerState) { return !IsValid(PlayerState); });
+
+	TArray<FUnrealTestMatchmakingPlayer> Entries;
+	Entries.Reserve(Players.Num());
+	for (const AUnrealTestPlayerState* PlayerState : Players)
+	{
+		Entries.Add(MakeMatchmakingPlayer(PlayerState));
+	}
+
+	Solver.Solve(Entries);
+	ApplyTeams();
+
+	UE_LOG(LogUnrealTest, Log, TEXT("Matchmaking: %d players in %d teams, skill spread %.1f"), Solver.GetNumPlayers(), Solver.GetNumTeams(), Solver.GetSkillSpread());
+}
+
+void UUnrealTestMatchmakingComponent::ApplyTeams()
+{
+	for (AUnrealTestPlayerState* PlayerState : Players)
+	{
+		PlayerState->SetTeamId(Solver.GetTeamOf(PlayerState->GetPlayerId()));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static FAutoConsoleCommand MatchmakingBenchmarkCommand(
+	TEXT("UnrealTest.Matchmaking.Benchmark"),
+	TEXT("Solves teams for N random players and then late joins N/10 more. Usage: UnrealTest.Matchmaking.Benchmark [NumPlayers]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const int32 NumPlayers = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 5000;
+
+		FUnrealTestTeamSolverSettings Settings;
+		Settings.MaxTeams = FMath::Max(2, NumPlayers / Settings.MaxTeamSize);
+		FUnrealTestTeamSolver Solver(Settings);
+
+		FRandomStream Random(NumPlayers);
+		TArray<FUnrealTestMatchmakingPlayer> Players;
+		Players.SetNum(NumPlayers);
+		for (int32 Index = 0; Index < NumPlayers; ++Index)
+		{
+			Players[Index].PlayerId = Index;
+			Players[Index].Skill = Random.FRandRange(500.f, 2500.f);
+		}
+
+		const double SolveStart = FPlatformTime::Seconds();
+		Solver.Solve(Players);
+		const double SolveSeconds = FPlatformTime::Seconds() - SolveStart;
+
+		const int32 NumLateJoiners = NumPlayers / 10;
+		const double JoinStart = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumLateJoiners; ++Index)
+		{
+			Solver.AddPlayer({ NumPlayers + Index, Random.FRandRange(500.f, 2500.f) });
+		}
+		const double JoinSeconds = FPlatformTime::Seconds() - JoinStart;
+
+		UE_LOG(LogUnrealTest, Display, TEXT("Matchmaking benchmark: solved %d players in %d teams in %.3f ms (spread %.1f), %d late joins in %.3f ms"),
+			NumPlayers, Solver.GetNumTeams(), SolveSeconds * 1000.0, Solver.GetSkillSpread(), NumLateJoiners, JoinSeconds * 1000.0);
+	}));
@@ -0,0 +1,31 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestPlayerState.h"
+#include "Net/UnrealNetwork.h"
+
+AUnrealTestPlayerState::AUnrealTestPlayerState()
+{
+	TeamId = NO_TEAM;
+}
+
+void AUnrealTestPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AUnrealTestPlayerState, TeamId);
+}
+
+void AUnrealTestPlayerState::SetTeamId(int32 NewTeamId)
+{
+	if (TeamId != NewTeamId)
+	{
+		TeamId = NewTeamId;
+		ForceNetUpdate();
+	}
+}
+
+FString AUnrealTestPlayerState::GetSkillRatingKey() const
+{
+	// Players without an online identity, e.g. on a LAN session, are remembered by name
+	return GetUniqueId().IsValid() ? GetUniqueId().ToString() : GetPlayerName();
+}
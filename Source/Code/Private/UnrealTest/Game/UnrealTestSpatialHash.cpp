@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestSpatialHash.h"
+#include "UnrealTest/Math/UnrealTestBatchMath.h"
+
+namespace UnrealTestSpatialHash
+{
+	/** Position of padding slots, its squared distance to anything in the arena is beyond any query */
+	static const float PADDING_POSITION = 1.e18f;
+}
+
+FUnrealTestSpatialHash::FUnrealTestSpatialHash(float InCellSize)
+	: NumPoints(0)
+{
+	SetCellSize(InCellSize);
+	BucketStarts.SetNumZeroed(NUM_BUCKETS + 1);
+}
+
+void FUnrealTestSpatialHash::SetCellSize(float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.f);
+	InvCellSize = 1.f / CellSize;
+}
+
+void FUnrealTestSpatialHash::Build(TArrayView<const FVector> Locations)
+{
+	NumPoints = Locations.Num();
+
+	// Counting sort by bucket: count, turn the counts into padded starts, scatter
+	PointBuckets.SetNumUninitialized(NumPoints, false);
+	FMemory::Memzero(BucketStarts.GetData(), BucketStarts.Num() * BucketStarts.GetTypeSize());
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		const uint32 Bucket = GetBucket(FMath::FloorToInt(Locations[Index].X * InvCellSize), FMath::FloorToInt(Locations[Index].Y * InvCellSize));
+		PointBuckets[Index] = Bucket;
+		++BucketStarts[Bucket];
+	}
+
+	int32 NumSlots = 0;
+	for (int32 Bucket = 0; Bucket < NUM_BUCKETS; ++Bucket)
+	{
+		const int32 Count = BucketStarts[Bucket];
+		BucketStarts[Bucket] = NumSlots;
+		NumSlots += Align(Count, 4);
+	}
+	BucketStarts[NUM_BUCKETS] = NumSlots;
+
+	PositionsX.SetNumUninitialized(NumSlots, false);
+	PositionsY.SetNumUninitialized(NumSlots, false);
+	PositionsZ.SetNumUninitialized(NumSlots, false);
+	Indices.SetNumUninitialized(NumSlots, false);
+	for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+	{
+		PositionsX[Slot] = UnrealTestSpatialHash::PADDING_POSITION;
+		PositionsY[Slot] = UnrealTestSpatialHash::PADDING_POSITION;
+		PositionsZ[Slot] = UnrealTestSpatialHash::PADDING_POSITION;
+		Indices[Slot] = INDEX_NONE;
+	}
+
+	BucketCursors = BucketStarts;
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		const int32 Slot = BucketCursors[PointBuckets[Index]]++;
+		PositionsX[Slot] = float(Locations[Index].X);
+		PositionsY[Slot] = float(Locations[Index].Y);
+		PositionsZ[Slot] = float(Locations[Index].Z);
+		Indices[Slot] = Index;
+	}
+}
+
+int32 FUnrealTestSpatialHash::QueryRadius(const FVector& Center, float Radius, TArrayView<int32> OutIndices) const
+{
+	return Query<false>(Center, Radius, FVector::ForwardVector, -1.f, OutIndices);
+}
+
+int32 FUnrealTestSpatialHash::QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArrayView<int32> OutIndices) const
+{
+	const float CosAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.f, 180.f)));
+	return Query<true>(Origin, Range, Direction.GetSafeNormal(), CosAngle, OutIndices);
+}
+
+template<bool bCone>
+int32 FUnrealTestSpatialHash::Query(const FVector& Center, float Radius, const FVector& Direction, float CosAngle, TArrayView<int32> OutIndices) const
+{
+	if (NumPoints == 0 || OutIndices.Num() == 0)
+	{
+		return 0;
+	}
+
+	const int32 MinX = FMath::FloorToInt((Center.X - Radius) * InvCellSize);
+	const int32 MaxX = FMath::FloorToInt((Center.X + Radius) * InvCellSize);
+	const int32 MinY = FMath::FloorToInt((Center.Y - Radius) * InvCellSize);
+	const int32 MaxY = FMath::FloorToInt((Center.Y + Radius) * InvCellSize);
+
+	// Queries covering more cells than there are buckets test everything in one go
+	if (int64(MaxX - MinX + 1) * int64(MaxY - MinY + 1) >= NUM_BUCKETS)
+	{
+		return TestRange<bCone>(0, BucketStarts[NUM_BUCKETS], Center, Radius, Direction, CosAngle, OutIndices, 0);
+	}
+
+	// Different cells can share a bucket, which must only be tested once
+	uint32 VisitedBuckets[NUM_BUCKETS / 32] = {};
+	int32 NumFound = 0;
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			const uint32 Bucket = GetBucket(CellX, CellY);
+			const uint32 VisitedBit = 1u << (Bucket & 31);
+			if (VisitedBuckets[Bucket >> 5] & VisitedBit)
+			{
+				continue;
+			}
+			VisitedBuckets[Bucket >> 5] |= VisitedBit;
+
+			NumFound = TestRange<bCone>(BucketStarts[Bucket], BucketStarts[Bucket + 1], Center, Radius, Direction, CosAngle, OutIndices, NumFound);
+			if (NumFound == OutIndices.Num())
+			{
+				return NumFound;
+			}
+		}
+	}
+
+	return NumFound;
+}
+
+template<bool bCone>
+int32 FUnrealTestSpatialHash::TestRange(int32 Begin, int32 End, const FVector& Center, float Radius, const FVector& Direction, float CosAngle, TArrayView<int32> OutIndices, int32 NumFound) const
+{
+	const int32 NumSlots = End - Begin;
+	const TArrayView<const float> X(PositionsX.GetData() + Begin, NumSlots);
+	const TArrayView<const float> Y(PositionsY.GetData() + Begin, NumSlots);
+	const TArrayView<const float> Z(PositionsZ.GetData() + Begin, NumSlots);
+	const TArrayView<int32> Hits = OutIndices.Slice(NumFound, OutIndices.Num() - NumFound);
+
+	const int32 NumHits = bCone
+		? FUnrealTestBatchMath::CullCone(X, Y, Z, Center, Direction, CosAngle, Radius, Hits)
+		: FUnrealTestBatchMath::CullSphere(X, Y, Z, Center, Radius, Hits);
+
+	// The kernels return slots of the range, turned into point indices in place. Padding never hits arena sized queries
+	for (int32 Hit = 0; Hit < NumHits; ++Hit)
+	{
+		const int32 Index = Indices[Begin + Hits[Hit]];
+		if (Index != INDEX_NONE)
+		{
+			OutIndices[NumFound++] = Index;
+		}
+	}
+
+	return NumFound;
+}
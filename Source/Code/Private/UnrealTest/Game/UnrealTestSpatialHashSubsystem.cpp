@@ -0,0 +1,165 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "UnrealTest/Game/UnrealTestPlayerState.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spatial Hash Build"), STAT_UnrealTest_SpatialHashBuild, STATGROUP_UnrealTest);
+DECLARE_CYCLE_STAT(TEXT("Spatial Hash Query"), STAT_UnrealTest_SpatialHashQuery, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spatial Hash Pawns"), STAT_UnrealTest_SpatialHashPawns, STATGROUP_UnrealTest);
+
+UUnrealTestSpatialHashSubsystem::UUnrealTestSpatialHashSubsystem()
+{
+	CellSize = CELL_SIZE;
+}
+
+TStatId UUnrealTestSpatialHashSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUnrealTestSpatialHashSubsystem, STATGROUP_Tickables);
+}
+
+void UUnrealTestSpatialHashSubsystem::RegisterPawn(APawn* Pawn)
+{
+	RegisteredPawns.AddUnique(Pawn);
+}
+
+void UUnrealTestSpatialHashSubsystem::UnregisterPawn(APawn* Pawn)
+{
+	RegisteredPawns.RemoveSingleSwap(Pawn);
+}
+
+void UUnrealTestSpatialHashSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_SpatialHashBuild);
+
+	// Tickables run after the actors, so this is where movement left everybody this frame
+	Pawns.Reset();
+	Locations.Reset();
+	Teams.Reset();
+	for (int32 Index = RegisteredPawns.Num() - 1; Index >= 0; --Index)
+	{
+		const APawn* Pawn = RegisteredPawns[Index].Get();
+		if (Pawn == nullptr)
+		{
+			RegisteredPawns.RemoveAtSwap(Index);
+			continue;
+		}
+
+		const AUnrealTestPlayerState* State = Pawn->GetPlayerState<AUnrealTestPlayerState>();
+		Pawns.Add(RegisteredPawns[Index]);
+		Locations.Add(Pawn->GetActorLocation());
+		Teams.Add(State ? State->GetTeamId() : AUnrealTestPlayerState::NO_TEAM);
+	}
+
+	Hash.SetCellSize(CellSize);
+	Hash.Build(Locations);
+	SET_DWORD_STAT(STAT_UnrealTest_SpatialHashPawns, Pawns.Num());
+}
+
+int32 UUnrealTestSpatialHashSubsystem::QueryRadius(const FVector& Center, float Radius, TArrayView<int32> OutIndices) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_SpatialHashQuery);
+	return Hash.QueryRadius(Center, Radius, OutIndices);
+}
+
+int32 UUnrealTestSpatialHashSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArrayView<int32> OutIndices) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_SpatialHashQuery);
+	return Hash.QueryCone(Origin, Direction, HalfAngleDegrees, Range, OutIndices);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static FAutoConsoleCommandWithArgs SpatialHashBenchmarkCommand(
+	TEXT("UnrealTest.SpatialHash.Benchmark"),
+	TEXT("Builds a spatial hash of N random points in an arena and runs M radius and cone queries against it and against a scalar loop over every point. Usage: UnrealTest.SpatialHash.Benchmark [Points] [Queries]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const int32 NumPoints = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+		const int32 NumQueries = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1000;
+		const float ArenaHalfSize = 10000.f;
+		const float QueryRadius = 600.f;
+		const float ConeHalfAngle = 30.f;
+
+		FRandomStream Random(NumPoints);
+		TArray<FVector> Points;
+		Points.SetNumUninitialized(NumPoints);
+		for (FVector& Point : Points)
+		{
+			Point = FVector(Random.FRandRange(-ArenaHalfSize, ArenaHalfSize), Random.FRandRange(-ArenaHalfSize, ArenaHalfSize), Random.FRandRange(0.f, 500.f));
+		}
+
+		TArray<FVector> Centers;
+		TArray<FVector> Directions;
+		Centers.SetNumUninitialized(NumQueries);
+		Directions.SetNumUninitialized(NumQueries);
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			Centers[Query] = FVector(Random.FRandRange(-ArenaHalfSize, ArenaHalfSize), Random.FRandRange(-ArenaHalfSize, ArenaHalfSize), 250.f);
+			Directions[Query] = Random.GetUnitVector();
+		}
+
+		TArray<int32> Results;
+		Results.SetNumUninitialized(NumPoints);
+
+		FUnrealTestSpatialHash Hash(GetDefault<UUnrealTestSpatialHashSubsystem>()->CellSize);
+		double StartTime = FPlatformTime::Seconds();
+		Hash.Build(Points);
+		const double BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+		int64 HashRadiusFound = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			HashRadiusFound += Hash.QueryRadius(Centers[Query], QueryRadius, Results);
+		}
+		const double HashRadiusSeconds = FPlatformTime::Seconds() - StartTime;
+
+		int64 HashConeFound = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			HashConeFound += Hash.QueryCone(Centers[Query], Directions[Query], ConeHalfAngle, QueryRadius, Results);
+		}
+		const double HashConeSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// What every effect would do without a broadphase
+		const float CosConeHalfAngle = FMath::Cos(FMath::DegreesToRadians(ConeHalfAngle));
+		int64 ScalarRadiusFound = 0;
+		int64 ScalarConeFound = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			for (const FVector& Point : Points)
+			{
+				ScalarRadiusFound += FVector::DistSquared(Point, Centers[Query]) <= FMath::Square(QueryRadius) ? 1 : 0;
+			}
+		}
+		const double ScalarRadiusSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Query = 0; Query < NumQueries; ++Query)
+		{
+			for (const FVector& Point : Points)
+			{
+				const FVector Delta = Point - Centers[Query];
+				const float Distance = Delta.Size();
+				ScalarConeFound += (Distance <= QueryRadius && FVector::DotProduct(Delta, Directions[Query]) >= CosConeHalfAngle * Distance) ? 1 : 0;
+			}
+		}
+		const double ScalarConeSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogUnrealTest, Display, TEXT("Spatial hash benchmark, %d points, %d queries of radius %.0f:"), NumPoints, NumQueries, QueryRadius);
+		UE_LOG(LogUnrealTest, Display, TEXT("  Build:  %.3f ms"), BuildSeconds * 1000.0);
+		UE_LOG(LogUnrealTest, Display, TEXT("  Radius: hash %.3f ms, scalar %.3f ms (%lld / %lld found)"),
+			HashRadiusSeconds * 1000.0, ScalarRadiusSeconds * 1000.0, HashRadiusFound, ScalarRadiusFound);
+		UE_LOG(LogUnrealTest, Display, TEXT("  Cone:   hash %.3f ms, scalar %.3f ms (%lld / %lld found)"),
+			HashConeSeconds * 1000.0, ScalarConeSeconds * 1000.0, HashConeFound, ScalarConeFound);
+	}));
@@ -0,0 +1,137 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestSpawnCoverage.h"
+#include "UnrealTest/Game/UnrealTestVisibilityGrid.h"
+#include "UnrealTest/Game/UnrealTestVisibilitySubsystem.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+
+void FUnrealTestSpawnCoverage::Bake(UWorld* World, float InCellSize, float Margin, float EyeHeight)
+{
+	SpawnPoints.Reset();
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		SpawnPoints.Add(*It);
+	}
+
+	FBox2D Bounds(ForceInit);
+	for (const APlayerStart* SpawnPoint : SpawnPoints)
+	{
+		Bounds += FVector2D(SpawnPoint->GetActorLocation());
+	}
+
+	if (SpawnPoints.Num() == 0)
+	{
+		VisibilityBits.Reset();
+		VisibleCellCounts.Reset();
+		GridSizeX = GridSizeY = WordsPerSpawn = 0;
+		return;
+	}
+
+	// Cells grow rather than the grid when the arena is too large for the cell size
+	Bounds = Bounds.ExpandBy(Margin);
+	const FVector2D BoundsSize = Bounds.GetSize();
+	CellSize = FMath::Max3(InCellSize, float(BoundsSize.X) / MAX_GRID_SIZE, float(BoundsSize.Y) / MAX_GRID_SIZE);
+	GridOrigin = Bounds.Min;
+	GridSizeX = FMath::Clamp(FMath::CeilToInt(BoundsSize.X / CellSize), 1, MAX_GRID_SIZE);
+	GridSizeY = FMath::Clamp(FMath::CeilToInt(BoundsSize.Y / CellSize), 1, MAX_GRID_SIZE);
+	WordsPerSpawn = FMath::DivideAndRoundUp(GetNumCells(), 64);
+
+	VisibilityBits.Reset();
+	VisibilityBits.SetNumZeroed(SpawnPoints.Num() * WordsPerSpawn);
+	VisibleCellCounts.Reset();
+	VisibleCellCounts.SetNumZeroed(SpawnPoints.Num());
+
+	// Cells are probed at the spawn point's eye height, arenas are mostly flat.
+	// The visibility subsystem traces, unless a grid is loaded and both ends fall in it. Without it, every cell is traced
+	const UUnrealTestVisibilitySubsystem* Visibility = World->GetSubsystem<UUnrealTestVisibilitySubsystem>();
+	for (int32 SpawnIndex = 0; SpawnIndex < SpawnPoints.Num(); ++SpawnIndex)
+	{
+		const FVector Eye = SpawnPoints[SpawnIndex]->GetActorLocation() + FVector(0.f, 0.f, EyeHeight);
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(UnrealTestSpawnCoverage), false, SpawnPoints[SpawnIndex]);
+
+		for (int32 Cell = 0; Cell < GetNumCells(); ++Cell)
+		{
+			const FVector CellCenter(
+				GridOrigin.X + ((Cell % GridSizeX) + 0.5f) * CellSize,
+				GridOrigin.Y + ((Cell / GridSizeX) + 0.5f) * CellSize,
+				Eye.Z);
+
+			const bool bVisible = Visibility ? Visibility->HasLineOfSight(Eye, CellCenter, SpawnPoints[SpawnIndex])
+				: !World->LineTraceTestByChannel(Eye, CellCenter, ECC_Visibility, QueryParams);
+			if (bVisible)
+			{
+				VisibilityBits[SpawnIndex * WordsPerSpawn + (Cell >> 6)] |= uint64(1) << (Cell & 63);
+				VisibleCellCounts[SpawnIndex]++;
+			}
+		}
+	}
+}
+
+bool FUnrealTestSpawnCoverage::CopyFromVisibilityGrid(UWorld* World, const FUnrealTestVisibilityGrid& Grid)
+{
+	static_assert(MAX_GRID_SIZE == FUnrealTestVisibilityGrid::MAX_GRID_SIZE, "Spawn coverage has to fit any visibility grid");
+
+	if (!Grid.IsLoaded())
+	{
+		return false;
+	}
+
+	// A spawn point outside the grid was moved since the grid was baked
+	TArray<int32> SpawnCells;
+	SpawnPoints.Reset();
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		const int32 Cell = Grid.GetCell(It->GetActorLocation());
+		if (Cell == INDEX_NONE)
+		{
+			SpawnPoints.Reset();
+			return false;
+		}
+
+		SpawnPoints.Add(*It);
+		SpawnCells.Add(Cell);
+	}
+
+	GridOrigin = Grid.GetOrigin();
+	CellSize = Grid.GetCellSize();
+	GridSizeX = Grid.GetGridSizeX();
+	GridSizeY = Grid.GetGridSizeY();
+	WordsPerSpawn = FMath::DivideAndRoundUp(GetNumCells(), 64);
+
+	VisibilityBits.Reset();
+	VisibilityBits.SetNumZeroed(SpawnPoints.Num() * WordsPerSpawn);
+	VisibleCellCounts.Reset();
+	VisibleCellCounts.SetNumZeroed(SpawnPoints.Num());
+
+	for (int32 SpawnIndex = 0; SpawnIndex < SpawnPoints.Num(); ++SpawnIndex)
+	{
+		for (int32 Cell = 0; Cell < GetNumCells(); ++Cell)
+		{
+			if (Grid.IsCellVisible(SpawnCells[SpawnIndex], Cell))
+			{
+				VisibilityBits[SpawnIndex * WordsPerSpawn + (Cell >> 6)] |= uint64(1) << (Cell & 63);
+				VisibleCellCounts[SpawnIndex]++;
+			}
+		}
+	}
+
+	return SpawnPoints.Num() > 0;
+}
+
+int32 FUnrealTestSpawnCoverage::GetCell(const FVector& Location) const
+{
+	if (CellSize <= 0.f)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 X = FMath::FloorToInt((Location.X - GridOrigin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt((Location.Y - GridOrigin.Y) / CellSize);
+	if (X < 0 || Y < 0 || X >= GridSizeX || Y >= GridSizeY)
+	{
+		return INDEX_NONE;
+	}
+	return Y * GridSizeX + X;
+}
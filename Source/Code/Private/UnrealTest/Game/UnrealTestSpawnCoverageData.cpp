@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestSpawnCoverageData.h"
+#include "UnrealTest/UnrealTestLog.h"
+
+AUnrealTestSpawnCoverageData::AUnrealTestSpawnCoverageData()
+{
+	CellSize = CELL_SIZE;
+	Margin = MARGIN;
+	EyeHeight = EYE_HEIGHT;
+}
+
+void AUnrealTestSpawnCoverageData::Bake()
+{
+	Modify();
+
+	const double StartTime = FPlatformTime::Seconds();
+	Coverage.Bake(GetWorld(), CellSize, Margin, EyeHeight);
+
+	UE_LOG(LogUnrealTest, Log, TEXT("Baked spawn coverage of %d spawn points over %dx%d cells in %.1f ms"),
+		Coverage.SpawnPoints.Num(), Coverage.GridSizeX, Coverage.GridSizeY, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
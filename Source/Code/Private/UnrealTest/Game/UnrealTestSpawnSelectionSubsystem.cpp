@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestSpawnSelectionSubsystem.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Combat/UnrealTestHealthComponent.h"
+#include "UnrealTest/Game/UnrealTestPlayerState.h"
+#include "UnrealTest/Game/UnrealTestSpawnCoverageData.h"
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "UnrealTest/Game/UnrealTestVisibilitySubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Selection"), STAT_UnrealTest_SpawnSelection, STATGROUP_UnrealTest);
+
+UUnrealTestSpawnSelectionSubsystem::UUnrealTestSpawnSelectionSubsystem()
+{
+	VisibleEnemyPenalty = VISIBLE_ENEMY_PENALTY;
+	NearEnemyDistance = NEAR_ENEMY_DISTANCE;
+	NearEnemyPenalty = NEAR_ENEMY_PENALTY;
+	ExposurePenalty = EXPOSURE_PENALTY;
+	RecentUseSeconds = RECENT_USE_SECONDS;
+	RecentUsePenalty = RECENT_USE_PENALTY;
+
+	EnemyGridFrame = 0;
+}
+
+void UUnrealTestSpawnSelectionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	for (TActorIterator<AUnrealTestSpawnCoverageData> It(&InWorld); It; ++It)
+	{
+		Coverage = It->Coverage;
+		break;
+	}
+
+	// The visibility grid baked for the map already knows what every spawn point's cell sees
+	UUnrealTestVisibilitySubsystem* Visibility = InWorld.GetSubsystem<UUnrealTestVisibilitySubsystem>();
+	if (!Coverage.IsBaked() && Visibility)
+	{
+		Visibility->LoadGrid();
+		Coverage.CopyFromVisibilityGrid(&InWorld, Visibility->GetGrid());
+	}
+
+	// Better late than never, but this is worth baking in the level
+	if (!Coverage.IsBaked())
+	{
+		const AUnrealTestSpawnCoverageData* Defaults = GetDefault<AUnrealTestSpawnCoverageData>();
+		const double StartTime = FPlatformTime::Seconds();
+		Coverage.Bake(&InWorld, Defaults->CellSize, Defaults->Margin, Defaults->EyeHeight);
+
+		UE_LOG(LogUnrealTest, Warning, TEXT("%s has no baked spawn coverage, baking it took %.1f ms"),
+			*InWorld.GetMapName(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	LastUseTimes.Init(-FLT_MAX, Coverage.SpawnPoints.Num());
+}
+
+AActor* UUnrealTestSpawnSelectionSubsystem::ChooseSpawnPoint(AController* Player)
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_SpawnSelection);
+
+	if (!Coverage.IsBaked())
+	{
+		return nullptr;
+	}
+
+	UpdateEnemyGrid();
+
+	const AUnrealTestPlayerState* State = Player ? Player->GetPlayerState<AUnrealTestPlayerState>() : nullptr;
+	const int32 Team = State ? State->GetTeamId() : AUnrealTestPlayerState::NO_TEAM;
+	const APawn* OwnPawn = Player ? Player->GetPawn() : nullptr;
+
+	int32 BestIndex = INDEX_NONE;
+	float BestScore = -FLT_MAX;
+	for (int32 SpawnIndex = 0; SpawnIndex < Coverage.SpawnPoints.Num(); ++SpawnIndex)
+	{
+		if (Coverage.SpawnPoints[SpawnIndex] == nullptr)
+		{
+			continue;
+		}
+
+		const float Score = ScoreSpawnPoint(SpawnIndex, Team, OwnPawn);
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestIndex = SpawnIndex;
+		}
+	}
+
+	if (BestIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	LastUseTimes[BestIndex] = GetWorld()->GetTimeSeconds();
+	return Coverage.SpawnPoints[BestIndex];
+}
+
+void UUnrealTestSpawnSelectionSubsystem::UpdateEnemyGrid()
+{
+	if (EnemyGridFrame == GFrameCounter)
+	{
+		return;
+	}
+	EnemyGridFrame = GFrameCounter;
+
+	PawnLocations.Reset();
+	PawnCells.Reset();
+	PawnTeams.Reset();
+	Pawns.Reset();
+
+	// The spatial hash already holds the living pawns of the frame
+	const UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>();
+	if (SpatialHash == nullptr)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < SpatialHash->GetNumPawns(); ++Index)
+	{
+		const APawn* Pawn = SpatialHash->GetPawn(Index);
+		const AUnrealTestCharacter* Character = Cast<AUnrealTestCharacter>(Pawn);
+		if (Pawn == nullptr || (Character && Character->GetHealth()->IsDead()))
+		{
+			continue;
+		}
+
+		// NPCs have no player state and no team, everybody's enemy. Teams are read from the player state
+		// rather than the hash, which keeps those of its last build and misses a rebalance earlier this frame
+		const AUnrealTestPlayerState* PawnState = Pawn->GetPlayerState<AUnrealTestPlayerState>();
+		const FVector& Location = SpatialHash->GetLocation(Index);
+		PawnLocations.Add(Location);
+		PawnCells.Add(Coverage.GetCell(Location));
+		PawnTeams.Add(PawnState ? PawnState->GetTeamId() : AUnrealTestPlayerState::NO_TEAM);
+		Pawns.Add(Pawn);
+	}
+}
+
+float UUnrealTestSpawnSelectionSubsystem::ScoreSpawnPoint(int32 SpawnIndex, int32 Team, const APawn* Ignored) const
+{
+	const FVector SpawnLocation = Coverage.SpawnPoints[SpawnIndex]->GetActorLocation();
+	const float NearDistanceSquared = FMath::Square(NearEnemyDistance);
+
+	float Score = -ExposurePenalty * Coverage.VisibleCellCounts[SpawnIndex] / FMath::Max(Coverage.GetNumCells(), 1);
+
+	const float SinceLastUse = GetWorld()->GetTimeSeconds() - LastUseTimes[SpawnIndex];
+	if (SinceLastUse < RecentUseSeconds)
+	{
+		Score -= RecentUsePenalty * (1.f - SinceLastUse / RecentUseSeconds);
+	}
+
+	for (int32 PawnIndex = 0; PawnIndex < Pawns.Num(); ++PawnIndex)
+	{
+		const int32 PawnTeam = PawnTeams[PawnIndex];
+		const bool bEnemy = Pawns[PawnIndex] != Ignored && (Team == AUnrealTestPlayerState::NO_TEAM || PawnTeam != Team);
+		if (!bEnemy)
+		{
+			continue;
+		}
+
+		const int32 Cell = PawnCells[PawnIndex];
+		if (Cell != INDEX_NONE && Coverage.IsCellVisible(SpawnIndex, Cell))
+		{
+			Score -= VisibleEnemyPenalty;
+		}
+
+		// Squared falloff, no square root per enemy
+		const float DistanceSquared = FVector::DistSquared2D(SpawnLocation, PawnLocations[PawnIndex]);
+		if (DistanceSquared < NearDistanceSquared)
+		{
+			Score -= NearEnemyPenalty * (1.f - DistanceSquared / NearDistanceSquared);
+		}
+	}
+
+	return Score;
+}
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestTeamSolver.h"
+#include "Algo/BinarySearch.h"
+
+FUnrealTestTeamSolver::FUnrealTestTeamSolver(const FUnrealTestTeamSolverSettings& InSettings)
+	: Settings(InSettings)
+{
+}
+
+void FUnrealTestTeamSolver::Reset()
+{
+	Teams.Reset();
+	PlayerToTeam.Reset();
+}
+
+int32 FUnrealTestTeamSolver::ComputeNumTeams(int32 NumPlayers) const
+{
+	if (NumPlayers <= 1)
+	{
+		return 1;
+	}
+
+	// At least two teams as soon as two players are around, more when teams would overflow,
+	// but never so many that teams drop below the minimum size
+	const int32 NeededTeams = FMath::DivideAndRoundUp(NumPlayers, FMath::Max(Settings.MaxTeamSize, 1));
+	const int32 AllowedTeams = FMath::Max(2, NumPlayers / FMath::Max(Settings.MinTeamSize, 1));
+	return FMath::Clamp(NeededTeams, 2, FMath::Min(AllowedTeams, Settings.MaxTeams));
+}
+
+void FUnrealTestTeamSolver::Solve(TArrayView<const FUnrealTestMatchmakingPlayer> Players)
+{
+	Reset();
+
+	const int32 NumTeams = ComputeNumTeams(Players.Num());
+	Teams.SetNum(NumTeams);
+	PlayerToTeam.Reserve(Players.Num());
+
+	TArray<FUnrealTestMatchmakingPlayer> Sorted(Players.GetData(), Players.Num());
+	Sorted.Sort([](const FUnrealTestMatchmakingPlayer& A, const FUnrealTestMatchmakingPlayer& B) { return A.Skill > B.Skill; });
+
+	const int32 Capacity = FMath::DivideAndRoundUp(FMath::Max(Players.Num(), 1), NumTeams);
+	for (FTeam& Team : Teams)
+	{
+		Team.Members.Reserve(Capacity);
+	}
+
+	// Weakest team with room first: a min heap on total skill keeps this O(N log T)
+	TArray<int32> OpenTeams;
+	OpenTeams.Reserve(NumTeams);
+	for (int32 TeamIndex = 0; TeamIndex < NumTeams; ++TeamIndex)
+	{
+		OpenTeams.Add(TeamIndex);
+	}
+
+	auto IsWeaker = [this](int32 A, int32 B) { return Teams[A].TotalSkill < Teams[B].TotalSkill; };
+	OpenTeams.Heapify(IsWeaker);
+
+	for (const FUnrealTestMatchmakingPlayer& Player : Sorted)
+	{
+		int32 TeamIndex;
+		OpenTeams.HeapPop(TeamIndex, IsWeaker, false);
+
+		FTeam& Team = Teams[TeamIndex];
+		Team.Members.Add(Player);
+		Team.TotalSkill += Player.Skill;
+
+		if (Team.Members.Num() < Capacity)
+		{
+			OpenTeams.HeapPush(TeamIndex, IsWeaker);
+		}
+	}
+
+	for (int32 Pass = 0; Pass < Settings.MaxRefinementPasses && NumTeams > 1; ++Pass)
+	{
+		int32 StrongTeam = 0;
+		int32 WeakTeam = 0;
+		for (int32 TeamIndex = 1; TeamIndex < NumTeams; ++TeamIndex)
+		{
+			StrongTeam = Teams[TeamIndex].TotalSkill > Teams[StrongTeam].TotalSkill ? TeamIndex : StrongTeam;
+			WeakTeam = Teams[TeamIndex].TotalSkill < Teams[WeakTeam].TotalSkill ? TeamIndex : WeakTeam;
+		}
+
+		if (StrongTeam == WeakTeam || !RefineTeams(StrongTeam, WeakTeam))
+		{
+			break;
+		}
+	}
+
+	for (int32 TeamIndex = 0; TeamIndex < NumTeams; ++TeamIndex)
+	{
+		for (const FUnrealTestMatchmakingPlayer& Member : Teams[TeamIndex].Members)
+		{
+			PlayerToTeam.Add(Member.PlayerId, TeamIndex);
+		}
+	}
+}
+
+bool FUnrealTestTeamSolver::RefineTeams(int32 StrongTeam, int32 WeakTeam)
+{
+	FTeam& Strong = Teams[StrongTeam];
+	FTeam& Weak = Teams[WeakTeam];
+	const float Difference = Strong.TotalSkill - Weak.TotalSkill;
+
+	// Swapping A from the strong team with B from the weak one changes the difference by 2 * (A - B),
+	// so the best partner for A has the skill closest to A - Difference / 2. Weak members are sorted
+	// by skill descending from the greedy pass, which lets us binary search for it.
+	Weak.Members.Sort([](const FUnrealTestMatchmakingPlayer& A, const FUnrealTestMatchmakingPlayer& B) { return A.Skill > B.Skill; });
+
+	int32 BestStrong = INDEX_NONE;
+	int32 BestWeak = INDEX_NONE;
+	float BestDifference = Difference;
+
+	for (int32 StrongIndex = 0; StrongIndex < Strong.Members.Num(); ++StrongIndex)
+	{
+		const float Target = Strong.Members[StrongIndex].Skill - Difference * 0.5f;
+		const int32 Found = Algo::LowerBound(Weak.Members, Target, [](const FUnrealTestMatchmakingPlayer& Member, float Value) { return Member.Skill > Value; });
+
+		for (int32 WeakIndex = FMath::Max(Found - 1, 0); WeakIndex <= FMath::Min(Found, Weak.Members.Num() - 1); ++WeakIndex)
+		{
+			const float Delta = Strong.Members[StrongIndex].Skill - Weak.Members[WeakIndex].Skill;
+			const float NewDifference = FMath::Abs(Difference - 2.f * Delta);
+			if (NewDifference < BestDifference)
+			{
+				BestDifference = NewDifference;
+				BestStrong = StrongIndex;
+				BestWeak = WeakIndex;
+			}
+		}
+	}
+
+	if (BestStrong == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const float Delta = Strong.Members[BestStrong].Skill - Weak.Members[BestWeak].Skill;
+	Swap(Strong.Members[BestStrong], Weak.Members[BestWeak]);
+	Strong.TotalSkill -= Delta;
+	Weak.TotalSkill += Delta;
+	return true;
+}
+
+int32 FUnrealTestTeamSolver::AddPlayer(const FUnrealTestMatchmakingPlayer& Player)
+{
+	if (const int32* ExistingTeam = PlayerToTeam.Find(Player.PlayerId))
+	{
+		return *ExistingTeam;
+	}
+
+	// Open a new team only once every team is full, or to get the second team going
+	const bool bAllTeamsFull = !Teams.ContainsByPredicate([this](const FTeam& Team) { return Team.Members.Num() < Settings.MaxTeamSize; });
+	const bool bNeedsSecondTeam = Teams.Num() < 2 && PlayerToTeam.Num() > 0;
+	if (bNeedsSecondTeam || (bAllTeamsFull && Teams.Num() < Settings.MaxTeams))
+	{
+		Teams.AddDefaulted();
+	}
+
+	int32 BestTeam = 0;
+	for (int32 TeamIndex = 1; TeamIndex < Teams.Num(); ++TeamIndex)
+	{
+		const FTeam& Candidate = Teams[TeamIndex];
+		const FTeam& Best = Teams[BestTeam];
+		if (Candidate.Members.Num() < Best.Members.Num()
+			|| (Candidate.Members.Num() == Best.Members.Num() && Candidate.TotalSkill < Best.TotalSkill))
+		{
+			BestTeam = TeamIndex;
+		}
+	}
+
+	FTeam& Team = Teams[BestTeam];
+	Team.Members.Add(Player);
+	Team.TotalSkill += Player.Skill;
+	PlayerToTeam.Add(Player.PlayerId, BestTeam);
+	return BestTeam;
+}
+
+void FUnrealTestTeamSolver::RemovePlayer(int32 PlayerId)
+{
+	int32 TeamIndex;
+	if (!PlayerToTeam.RemoveAndCopyValue(PlayerId, TeamIndex))
+	{
+		return;
+	}
+
+	FTeam& Team = Teams[TeamIndex];
+	const int32 MemberIndex = Team.Members.IndexOfByPredicate([PlayerId](const FUnrealTestMatchmakingPlayer& Member) { return Member.PlayerId == PlayerId; });
+	if (MemberIndex != INDEX_NONE)
+	{
+		Team.TotalSkill -= Team.Members[MemberIndex].Skill;
+		Team.Members.RemoveAtSwap(MemberIndex);
+	}
+}
+
+int32 FUnrealTestTeamSolver::GetTeamOf(int32 PlayerId) const
+{
+	const int32* TeamIndex = PlayerToTeam.Find(PlayerId);
+	return TeamIndex ? *TeamIndex : INDEX_NONE;
+}
+
+float FUnrealTestTeamSolver::GetSkillSpread() const
+{
+	if (Teams.Num() == 0)
+	{
+		return 0.f;
+	}
+
+	float MinSkill = Teams[0].TotalSkill;
+	float MaxSkill = Teams[0].TotalSkill;
+	for (const FTeam& Team : Teams)
+	{
+		MinSkill = FMath::Min(MinSkill, Team.TotalSkill);
+		MaxSkill = FMath::Max(MaxSkill, Team.TotalSkill);
+	}
+	return MaxSkill - MinSkill;
+}
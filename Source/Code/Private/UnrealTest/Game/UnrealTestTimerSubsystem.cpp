@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestTimerSubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay Timers Advance"), STAT_UnrealTest_TimersAdvance, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Timers Pending"), STAT_UnrealTest_TimersPending, STATGROUP_UnrealTest);
+
+void UUnrealTestTimerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_TimersAdvance);
+	Timers.Advance(GetWorld()->GetTimeSeconds());
+	SET_DWORD_STAT(STAT_UnrealTest_TimersPending, Timers.GetNumPending());
+}
+
+TStatId UUnrealTestTimerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUnrealTestTimerSubsystem, STATGROUP_Tickables);
+}
+
+FUnrealTestTimerHandle UUnrealTestTimerSubsystem::Schedule(float Delay, FSimpleDelegate&& Callback)
+{
+	return Timers.Schedule(Delay, MoveTemp(Callback));
+}
+
+void UUnrealTestTimerSubsystem::Cancel(FUnrealTestTimerHandle& Handle)
+{
+	Timers.Cancel(Handle);
+}
+
+bool UUnrealTestTimerSubsystem::IsPending(const FUnrealTestTimerHandle& Handle) const
+{
+	return Timers.IsPending(Handle);
+}
+
+float UUnrealTestTimerSubsystem::GetRemaining(const FUnrealTestTimerHandle& Handle) const
+{
+	return Timers.GetRemaining(Handle);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+namespace UnrealTestTimerBenchmark
+{
+	static int32 NumFired = 0;
+
+	static void OnFired()
+	{
+		++NumFired;
+	}
+}
+
+static FAutoConsoleCommandWithArgs TimersBenchmarkCommand(
+	TEXT("UnrealTest.Timers.Benchmark"),
+	TEXT("Schedules, cancels and fires N timers on a timing wheel and on a timer manager and reports the time taken. Usage: UnrealTest.Timers.Benchmark [Timers]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const int32 NumTimers = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+		const float MaxDelay = 10.f;
+
+		// Same delays for both, half of the timers are cancelled before they fire
+		FRandomStream Random(NumTimers);
+		TArray<float> Delays;
+		Delays.SetNumUninitialized(NumTimers);
+		for (float& Delay : Delays)
+		{
+			Delay = Random.FRandRange(0.01f, MaxDelay);
+		}
+
+		UnrealTestTimerBenchmark::NumFired = 0;
+		FUnrealTestTimingWheel Wheel;
+		TArray<FUnrealTestTimerHandle> WheelHandles;
+		WheelHandles.SetNumUninitialized(NumTimers);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumTimers; ++Index)
+		{
+			WheelHandles[Index] = Wheel.Schedule(Delays[Index], FSimpleDelegate::CreateStatic(&UnrealTestTimerBenchmark::OnFired));
+		}
+		const double WheelScheduleSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumTimers; Index += 2)
+		{
+			Wheel.Cancel(WheelHandles[Index]);
+		}
+		const double WheelCancelSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		Wheel.Advance(MaxDelay + 1.f);
+		const double WheelFireSeconds = FPlatformTime::Seconds() - StartTime;
+		const int32 WheelFired = UnrealTestTimerBenchmark::NumFired;
+
+		// The timer manager only ticks once per engine frame, so everything fires from a single tick
+		UnrealTestTimerBenchmark::NumFired = 0;
+		FTimerManager TimerManager;
+		TArray<FTimerHandle> ManagerHandles;
+		ManagerHandles.SetNum(NumTimers);
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumTimers; ++Index)
+		{
+			TimerManager.SetTimer(ManagerHandles[Index], FTimerDelegate::CreateStatic(&UnrealTestTimerBenchmark::OnFired), Delays[Index], false);
+		}
+		const double ManagerScheduleSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumTimers; Index += 2)
+		{
+			TimerManager.ClearTimer(ManagerHandles[Index]);
+		}
+		const double ManagerCancelSeconds = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		TimerManager.Tick(MaxDelay + 1.f);
+		const double ManagerFireSeconds = FPlatformTime::Seconds() - StartTime;
+		const int32 ManagerFired = UnrealTestTimerBenchmark::NumFired;
+
+		UE_LOG(LogUnrealTest, Display, TEXT("Timers benchmark, %d timers:"), NumTimers);
+		UE_LOG(LogUnrealTest, Display, TEXT("  Timing wheel:  schedule %.2f ms, cancel %.2f ms, fire %.2f ms (%d fired)"),
+			WheelScheduleSeconds * 1000.0, WheelCancelSeconds * 1000.0, WheelFireSeconds * 1000.0, WheelFired);
+		UE_LOG(LogUnrealTest, Display, TEXT("  Timer manager: schedule %.2f ms, cancel %.2f ms, fire %.2f ms (%d fired)"),
+			ManagerScheduleSeconds * 1000.0, ManagerCancelSeconds * 1000.0, ManagerFireSeconds * 1000.0, ManagerFired);
+	}));
@@ -0,0 +1,223 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
+
+FUnrealTestTimingWheel::FUnrealTestTimingWheel(float InSlotSeconds)
+	: SlotSeconds(FMath::Max(InSlotSeconds, KINDA_SMALL_NUMBER))
+	, FreeHead(INDEX_NONE)
+	, NumPending(0)
+	, CurrentTick(0)
+{
+	for (int32& Head : SlotHeads)
+	{
+		Head = INDEX_NONE;
+	}
+}
+
+FUnrealTestTimerHandle FUnrealTestTimingWheel::Schedule(float Delay, FSimpleDelegate&& Callback)
+{
+	if (!Callback.IsBound())
+	{
+		return FUnrealTestTimerHandle();
+	}
+
+	int32 NodeIndex = FreeHead;
+	if (NodeIndex != INDEX_NONE)
+	{
+		FreeHead = Nodes[NodeIndex].Next;
+	}
+	else
+	{
+		NodeIndex = Nodes.AddDefaulted();
+	}
+
+	// Never due in the tick being processed, so timers scheduled from a callback wait for the next advance
+	const uint64 DelayTicks = FMath::Clamp<uint64>(uint64(FMath::CeilToDouble(FMath::Max(Delay, 0.f) / SlotSeconds)), 1, MAX_DELAY_TICKS);
+
+	FNode& Node = Nodes[NodeIndex];
+	Node.Callback = MoveTemp(Callback);
+	Node.DueTick = CurrentTick + DelayTicks;
+	Link(NodeIndex);
+	++NumPending;
+
+	FUnrealTestTimerHandle Handle;
+	Handle.Index = NodeIndex;
+	Handle.Serial = Node.Serial;
+	return Handle;
+}
+
+void FUnrealTestTimingWheel::Cancel(FUnrealTestTimerHandle& Handle)
+{
+	if (IsPending(Handle))
+	{
+		Unlink(Handle.Index);
+		Free(Handle.Index);
+	}
+	Handle.Invalidate();
+}
+
+bool FUnrealTestTimingWheel::IsPending(const FUnrealTestTimerHandle& Handle) const
+{
+	return Nodes.IsValidIndex(Handle.Index) && Nodes[Handle.Index].Serial == Handle.Serial && Nodes[Handle.Index].Callback.IsBound();
+}
+
+float FUnrealTestTimingWheel::GetRemaining(const FUnrealTestTimerHandle& Handle) const
+{
+	return IsPending(Handle) ? float((Nodes[Handle.Index].DueTick - FMath::Min(Nodes[Handle.Index].DueTick, CurrentTick)) * SlotSeconds) : 0.f;
+}
+
+double FUnrealTestTimingWheel::GetMaxDelay() const
+{
+	return MAX_DELAY_TICKS * SlotSeconds;
+}
+
+void FUnrealTestTimingWheel::Advance(double Time)
+{
+	const uint64 TargetTick = uint64(FMath::Max(Time, 0.0) / SlotSeconds);
+
+	// Collect first and call afterwards, so callbacks can freely schedule and cancel timers
+	DueTimers.Reset();
+	while (CurrentTick < TargetTick)
+	{
+		++CurrentTick;
+
+		// Every time a level wraps around, the next slot of the level above is spread over the levels below
+		int32 LevelShift = FIRST_LEVEL_BITS;
+		for (int32 Level = 1; Level < NUM_LEVELS; ++Level)
+		{
+			if ((CurrentTick & ((uint64(1) << LevelShift) - 1)) != 0)
+			{
+				break;
+			}
+
+			const int32 LevelSlot = int32((CurrentTick >> LevelShift) & (LEVEL_SLOTS - 1));
+			Cascade(FIRST_LEVEL_SLOTS + (Level - 1) * LEVEL_SLOTS + LevelSlot);
+			LevelShift += LEVEL_BITS;
+		}
+
+		const int32 Slot = int32(CurrentTick & (FIRST_LEVEL_SLOTS - 1));
+		int32 NodeIndex = SlotHeads[Slot];
+		SlotHeads[Slot] = INDEX_NONE;
+		while (NodeIndex != INDEX_NONE)
+		{
+			FNode& Node = Nodes[NodeIndex];
+			const int32 NextIndex = Node.Next;
+			Node.Prev = INDEX_NONE;
+			Node.Next = INDEX_NONE;
+			Node.Slot = INDEX_NONE;
+
+			FUnrealTestTimerHandle& Due = DueTimers.AddDefaulted_GetRef();
+			Due.Index = NodeIndex;
+			Due.Serial = Node.Serial;
+
+			NodeIndex = NextIndex;
+		}
+	}
+
+	for (const FUnrealTestTimerHandle& Due : DueTimers)
+	{
+		// A callback earlier in the batch may have cancelled this one
+		if (!IsPending(Due))
+		{
+			continue;
+		}
+
+		FSimpleDelegate Callback = MoveTemp(Nodes[Due.Index].Callback);
+		Free(Due.Index);
+		Callback.ExecuteIfBound();
+	}
+}
+
+void FUnrealTestTimingWheel::Reset()
+{
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		if (Nodes[NodeIndex].Callback.IsBound())
+		{
+			Unlink(NodeIndex);
+			Free(NodeIndex);
+		}
+	}
+}
+
+void FUnrealTestTimingWheel::Link(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	const uint64 Delta = Node.DueTick - FMath::Min(Node.DueTick, CurrentTick);
+
+	// The level is picked from how far away the timer is, the slot within it from the due tick itself
+	if (Delta < FIRST_LEVEL_SLOTS)
+	{
+		Node.Slot = int32(Node.DueTick & (FIRST_LEVEL_SLOTS - 1));
+	}
+	else
+	{
+		int32 Level = 1;
+		int32 LevelShift = FIRST_LEVEL_BITS;
+		while (Level < NUM_LEVELS - 1 && Delta >= (uint64(1) << (LevelShift + LEVEL_BITS)))
+		{
+			++Level;
+			LevelShift += LEVEL_BITS;
+		}
+		Node.Slot = FIRST_LEVEL_SLOTS + (Level - 1) * LEVEL_SLOTS + int32((Node.DueTick >> LevelShift) & (LEVEL_SLOTS - 1));
+	}
+
+	int32& Head = SlotHeads[Node.Slot];
+	Node.Prev = INDEX_NONE;
+	Node.Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		Nodes[Head].Prev = NodeIndex;
+	}
+	Head = NodeIndex;
+}
+
+void FUnrealTestTimingWheel::Unlink(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	if (Node.Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (Node.Prev != INDEX_NONE)
+	{
+		Nodes[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		SlotHeads[Node.Slot] = Node.Next;
+	}
+
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = Node.Prev;
+	}
+
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+	Node.Slot = INDEX_NONE;
+}
+
+void FUnrealTestTimingWheel::Free(int32 NodeIndex)
+{
+	// Bumping the serial turns every handle to this node stale
+	FNode& Node = Nodes[NodeIndex];
+	Node.Callback.Unbind();
+	Node.Serial++;
+	Node.Next = FreeHead;
+	FreeHead = NodeIndex;
+	--NumPending;
+}
+
+void FUnrealTestTimingWheel::Cascade(int32 Slot)
+{
+	int32 NodeIndex = SlotHeads[Slot];
+	SlotHeads[Slot] = INDEX_NONE;
+	while (NodeIndex != INDEX_NONE)
+	{
+		const int32 NextIndex = Nodes[NodeIndex].Next;
+		Link(NodeIndex);
+		NodeIndex = NextIndex;
+	}
+}
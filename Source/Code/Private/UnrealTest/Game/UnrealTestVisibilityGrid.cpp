@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestVisibilityGrid.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+void FUnrealTestVisibilityGrid::Bake(UWorld* World, float InCellSize, float Margin, float InEyeHeight)
+{
+	Reset();
+
+	FBox Bounds(ForceInit);
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		Bounds += It->GetActorLocation();
+	}
+
+	if (!Bounds.IsValid)
+	{
+		return;
+	}
+
+	// Cells grow rather than the grid when the arena is too large for the cell size
+	Bounds = Bounds.ExpandBy(Margin);
+	const FVector BoundsSize = Bounds.GetSize();
+	const float CellSize = FMath::Max3(InCellSize, float(BoundsSize.X) / MAX_GRID_SIZE, float(BoundsSize.Y) / MAX_GRID_SIZE);
+	const int32 GridSizeX = FMath::Clamp(FMath::CeilToInt(float(BoundsSize.X) / CellSize), 1, MAX_GRID_SIZE);
+	const int32 GridSizeY = FMath::Clamp(FMath::CeilToInt(float(BoundsSize.Y) / CellSize), 1, MAX_GRID_SIZE);
+	const int32 NumCells = GridSizeX * GridSizeY;
+	const int32 WordsPerCell = FMath::DivideAndRoundUp(NumCells, 64);
+
+	// Built in place in the layout of the file
+	Storage.SetNumZeroed(GetBitsOffset(NumCells) + int64(NumCells) * WordsPerCell * sizeof(uint64));
+	FUnrealTestVisibilityGridHeader* NewHeader = reinterpret_cast<FUnrealTestVisibilityGridHeader*>(Storage.GetData());
+	float* NewEyeHeights = reinterpret_cast<float*>(Storage.GetData() + sizeof(FUnrealTestVisibilityGridHeader));
+	uint64* NewBits = reinterpret_cast<uint64*>(Storage.GetData() + GetBitsOffset(NumCells));
+
+	NewHeader->Magic = FUnrealTestVisibilityGridHeader::MAGIC;
+	NewHeader->Version = FUnrealTestVisibilityGridHeader::VERSION;
+	NewHeader->OriginX = float(Bounds.Min.X);
+	NewHeader->OriginY = float(Bounds.Min.Y);
+	NewHeader->CellSize = CellSize;
+	NewHeader->EyeHeight = InEyeHeight;
+	NewHeader->GridSizeX = GridSizeX;
+	NewHeader->GridSizeY = GridSizeY;
+	NewHeader->WordsPerCell = WordsPerCell;
+
+	// One floor per cell, arenas are mostly flat and open to the sky
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(UnrealTestVisibilityGrid), false);
+	for (int32 Cell = 0; Cell < NumCells; ++Cell)
+	{
+		const float X = NewHeader->OriginX + ((Cell % GridSizeX) + 0.5f) * CellSize;
+		const float Y = NewHeader->OriginY + ((Cell / GridSizeX) + 0.5f) * CellSize;
+
+		FHitResult Floor;
+		const bool bHasFloor = World->LineTraceSingleByChannel(Floor, FVector(X, Y, Bounds.Max.Z), FVector(X, Y, Bounds.Min.Z), ECC_Visibility, QueryParams);
+		NewEyeHeights[Cell] = bHasFloor ? float(Floor.ImpactPoint.Z) + InEyeHeight : NO_FLOOR;
+	}
+
+	// Lines of sight go both ways, every pair is traced once
+	int32 NumVisiblePairs = 0;
+	for (int32 FromCell = 0; FromCell < NumCells; ++FromCell)
+	{
+		if (NewEyeHeights[FromCell] == NO_FLOOR)
+		{
+			continue;
+		}
+
+		const FVector FromEye(NewHeader->OriginX + ((FromCell % GridSizeX) + 0.5f) * CellSize, NewHeader->OriginY + ((FromCell / GridSizeX) + 0.5f) * CellSize, NewEyeHeights[FromCell]);
+		NewBits[FromCell * WordsPerCell + (FromCell >> 6)] |= uint64(1) << (FromCell & 63);
+
+		for (int32 ToCell = FromCell + 1; ToCell < NumCells; ++ToCell)
+		{
+			if (NewEyeHeights[ToCell] == NO_FLOOR)
+			{
+				continue;
+			}
+
+			const FVector ToEye(NewHeader->OriginX + ((ToCell % GridSizeX) + 0.5f) * CellSize, NewHeader->OriginY + ((ToCell / GridSizeX) + 0.5f) * CellSize, NewEyeHeights[ToCell]);
+			if (!World->LineTraceTestByChannel(FromEye, ToEye, ECC_Visibility, QueryParams))
+			{
+				NewBits[FromCell * WordsPerCell + (ToCell >> 6)] |= uint64(1) << (ToCell & 63);
+				NewBits[ToCell * WordsPerCell + (FromCell >> 6)] |= uint64(1) << (FromCell & 63);
+				++NumVisiblePairs;
+			}
+		}
+
+		if ((FromCell + 1) % GridSizeX == 0)
+		{
+			UE_LOG(LogUnrealTest, Display, TEXT("Baked visibility of row %d/%d"), (FromCell + 1) / GridSizeX, GridSizeY);
+		}
+	}
+
+	Bind(Storage.GetData(), Storage.Num());
+
+	UE_LOG(LogUnrealTest, Display, TEXT("Baked a %dx%d visibility grid of %.0f cm cells, %d visible pairs, %lld bytes"),
+		GridSizeX, GridSizeY, CellSize, NumVisiblePairs, DataSize);
+}
+
+bool FUnrealTestVisibilityGrid::Save(const FString& Filename) const
+{
+	if (!IsLoaded())
+	{
+		return false;
+	}
+
+	return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Header), DataSize), *Filename);
+}
+
+bool FUnrealTestVisibilityGrid::Load(const FString& Filename)
+{
+	Reset();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Filename))
+	{
+		return false;
+	}
+
+	// Pages of the bits are only read from disk once tested
+	MappedFile.Reset(PlatformFile.OpenMapped(*Filename));
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	const bool bLoaded = MappedRegion.IsValid()
+		? Bind(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize())
+		: FFileHelper::LoadFileToArray(Storage, *Filename) && Bind(Storage.GetData(), Storage.Num());
+
+	if (!bLoaded)
+	{
+		UE_LOG(LogUnrealTest, Warning, TEXT("%s is not a visibility grid of version %u, bake it again"), *Filename, FUnrealTestVisibilityGridHeader::VERSION);
+		Reset();
+	}
+	return bLoaded;
+}
+
+void FUnrealTestVisibilityGrid::Reset()
+{
+	Header = nullptr;
+	EyeHeights = nullptr;
+	Bits = nullptr;
+	DataSize = 0;
+
+	Storage.Empty();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool FUnrealTestVisibilityGrid::Bind(const uint8* Data, int64 Size)
+{
+	if (Data == nullptr || Size < int64(sizeof(FUnrealTestVisibilityGridHeader)))
+	{
+		return false;
+	}
+
+	const FUnrealTestVisibilityGridHeader* NewHeader = reinterpret_cast<const FUnrealTestVisibilityGridHeader*>(Data);
+	if (NewHeader->Magic != FUnrealTestVisibilityGridHeader::MAGIC || NewHeader->Version != FUnrealTestVisibilityGridHeader::VERSION
+		|| NewHeader->GridSizeX < 1 || NewHeader->GridSizeX > MAX_GRID_SIZE || NewHeader->GridSizeY < 1 || NewHeader->GridSizeY > MAX_GRID_SIZE
+		|| NewHeader->CellSize <= 0.f)
+	{
+		return false;
+	}
+
+	const int32 NumCells = NewHeader->GridSizeX * NewHeader->GridSizeY;
+	if (NewHeader->WordsPerCell != FMath::DivideAndRoundUp(NumCells, 64)
+		|| Size != GetBitsOffset(NumCells) + int64(NumCells) * NewHeader->WordsPerCell * sizeof(uint64))
+	{
+		return false;
+	}
+
+	Header = NewHeader;
+	EyeHeights = reinterpret_cast<const float*>(Data + sizeof(FUnrealTestVisibilityGridHeader));
+	Bits = reinterpret_cast<const uint64*>(Data + GetBitsOffset(NumCells));
+	DataSize = Size;
+	return true;
+}
+
+int64 FUnrealTestVisibilityGrid::GetBitsOffset(int32 NumCells)
+{
+	return Align(int64(sizeof(FUnrealTestVisibilityGridHeader)) + int64(NumCells) * sizeof(float), 16);
+}
+
+int32 FUnrealTestVisibilityGrid::GetCell(const FVector& Location) const
+{
+	if (Header == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 X = FMath::FloorToInt((float(Location.X) - Header->OriginX) / Header->CellSize);
+	const int32 Y = FMath::FloorToInt((float(Location.Y) - Header->OriginY) / Header->CellSize);
+	if (X < 0 || Y < 0 || X >= Header->GridSizeX || Y >= Header->GridSizeY)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Cell = Y * Header->GridSizeX + X;
+	return EyeHeights[Cell] != NO_FLOOR ? Cell : INDEX_NONE;
+}
+
+FString FUnrealTestVisibilityGrid::GetFilename(const FString& MapName)
+{
+	return FPaths::ProjectContentDir() / TEXT("Visibility") / UWorld::RemovePIEPrefix(MapName) + TEXT(".utvis");
+}
@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestVisibilitySubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Bit Tests"), STAT_UnrealTest_LineOfSightBitTests, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Traces"), STAT_UnrealTest_LineOfSightTraces, STATGROUP_UnrealTest);
+
+UUnrealTestVisibilitySubsystem::UUnrealTestVisibilitySubsystem()
+{
+	CloseRangeDistance = CLOSE_RANGE_DISTANCE;
+
+	bGridLoadAttempted = false;
+}
+
+void UUnrealTestVisibilitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() != NM_Client)
+	{
+		LoadGrid();
+	}
+}
+
+void UUnrealTestVisibilitySubsystem::LoadGrid()
+{
+	if (bGridLoadAttempted)
+	{
+		return;
+	}
+	bGridLoadAttempted = true;
+
+	const FString Filename = FUnrealTestVisibilityGrid::GetFilename(GetWorld()->GetMapName());
+	if (!Grid.Load(Filename))
+	{
+		UE_LOG(LogUnrealTest, Log, TEXT("%s has no baked visibility grid, lines of sight are traced. Run the UnrealTestBakeVisibility commandlet"), *GetWorld()->GetMapName());
+		return;
+	}
+
+	UE_LOG(LogUnrealTest, Log, TEXT("Loaded the %dx%d visibility grid of %s, %lld bytes %s"), Grid.GetGridSizeX(), Grid.GetGridSizeY(),
+		*GetWorld()->GetMapName(), Grid.GetDataSize(), Grid.IsMapped() ? TEXT("mapped") : TEXT("read"));
+}
+
+bool UUnrealTestVisibilitySubsystem::HasLineOfSight(const FVector& From, const FVector& To, const AActor* IgnoredActor) const
+{
+	if (FVector::DistSquared(From, To) > FMath::Square(CloseRangeDistance))
+	{
+		const int32 FromCell = Grid.GetCell(From);
+		const int32 ToCell = Grid.GetCell(To);
+		if (FromCell != INDEX_NONE && ToCell != INDEX_NONE)
+		{
+			INC_DWORD_STAT(STAT_UnrealTest_LineOfSightBitTests);
+			return Grid.IsCellVisible(FromCell, ToCell);
+		}
+	}
+
+	INC_DWORD_STAT(STAT_UnrealTest_LineOfSightTraces);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(UnrealTestLineOfSight), false, IgnoredActor);
+	return !GetWorld()->LineTraceTestByChannel(From, To, ECC_Visibility, QueryParams);
+}
+
+bool UUnrealTestVisibilitySubsystem::IsPotentiallyVisible(const FVector& From, const FVector& To) const
+{
+	const int32 FromCell = Grid.GetCell(From);
+	const int32 ToCell = Grid.GetCell(To);
+	if (FromCell == INDEX_NONE || ToCell == INDEX_NONE)
+	{
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_UnrealTest_LineOfSightBitTests);
+	return Grid.IsCellVisible(FromCell, ToCell);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static FAutoConsoleCommandWithWorldAndArgs VisibilityBenchmarkCommand(
+	TEXT("UnrealTest.Visibility.Benchmark"),
+	TEXT("Times line of sight queries between random points of the visibility grid, as bit tests and as traces, and how often they disagree. Usage: UnrealTest.Visibility.Benchmark [Queries]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		const UUnrealTestVisibilitySubsystem* Visibility = World ? World->GetSubsystem<UUnrealTestVisibilitySubsystem>() : nullptr;
+		if (Visibility == nullptr || !Visibility->GetGrid().IsLoaded())
+		{
+			UE_LOG(LogUnrealTest, Warning, TEXT("UnrealTest.Visibility.Benchmark needs a baked visibility grid, loaded on the server"));
+			return;
+		}
+
+		const FUnrealTestVisibilityGrid& Grid = Visibility->GetGrid();
+		const int32 NumQueries = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+
+		// Random points on the floor of random cells, at eye height
+		TArray<FVector> From;
+		TArray<FVector> To;
+		FRandomStream Random(NumQueries);
+		const FVector2D Origin = Grid.GetOrigin();
+		const FVector2D Size = FVector2D(Grid.GetGridSizeX(), Grid.GetGridSizeY()) * Grid.GetCellSize();
+		FCollisionQueryParams FloorParams(SCENE_QUERY_STAT(UnrealTestVisibilityBenchmark), false);
+		for (int32 Attempt = 0; Attempt < NumQueries * 4 && From.Num() < NumQueries; ++Attempt)
+		{
+			FVector Points[2];
+			bool bOnFloor = true;
+			for (FVector& Point : Points)
+			{
+				const FVector Top(Origin.X + Random.FRand() * Size.X, Origin.Y + Random.FRand() * Size.Y, HALF_WORLD_MAX);
+				FHitResult Floor;
+				bOnFloor &= World->LineTraceSingleByChannel(Floor, Top, FVector(Top.X, Top.Y, -HALF_WORLD_MAX), ECC_Visibility, FloorParams);
+				Point = Floor.ImpactPoint + FVector(0.f, 0.f, Grid.GetEyeHeight());
+			}
+
+			if (bOnFloor && Grid.GetCell(Points[0]) != INDEX_NONE && Grid.GetCell(Points[1]) != INDEX_NONE)
+			{
+				From.Add(Points[0]);
+				To.Add(Points[1]);
+			}
+		}
+
+		TArray<bool> BitResults;
+		BitResults.SetNumUninitialized(From.Num());
+		int32 NumVisibleBits = 0;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < From.Num(); ++Index)
+		{
+			BitResults[Index] = Grid.IsCellVisible(Grid.GetCell(From[Index]), Grid.GetCell(To[Index]));
+			NumVisibleBits += BitResults[Index] ? 1 : 0;
+		}
+		const double BitSeconds = FPlatformTime::Seconds() - StartTime;
+
+		int32 NumVisibleTraces = 0;
+		int32 NumDisagreements = 0;
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(UnrealTestVisibilityBenchmark), false);
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < From.Num(); ++Index)
+		{
+			const bool bVisible = !World->LineTraceTestByChannel(From[Index], To[Index], ECC_Visibility, QueryParams);
+			NumVisibleTraces += bVisible ? 1 : 0;
+			NumDisagreements += bVisible != BitResults[Index] ? 1 : 0;
+		}
+		const double TraceSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogUnrealTest, Display, TEXT("Visibility benchmark, %d queries: bit tests %.3f ms (%d visible), traces %.3f ms (%d visible), %.1f%% disagree"),
+			From.Num(), BitSeconds * 1000.0, NumVisibleBits, TraceSeconds * 1000.0, NumVisibleTraces,
+			From.Num() > 0 ? 100.f * NumDisagreements / From.Num() : 0.f);
+	}));
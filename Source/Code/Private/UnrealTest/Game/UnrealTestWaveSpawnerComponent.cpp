@@ -0,0 +1,209 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestWaveSpawnerComponent.h"
+#include "UnrealTest/Combat/UnrealTestHealthComponent.h"
+#include "UnrealTest/Game/UnrealTestActorPoolSubsystem.h"
+#include "UnrealTest/Game/UnrealTestGameMode.h"
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "UnrealTest/Game/UnrealTestSpawnSelectionSubsystem.h"
+#include "UnrealTest/Game/UnrealTestTimerSubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "GameFramework/PlayerStart.h"
+
+UUnrealTestWaveSpawnerComponent::UUnrealTestWaveSpawnerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	FirstWaveDelaySeconds = FIRST_WAVE_DELAY_SECONDS;
+	WaveIntervalSeconds = WAVE_INTERVAL_SECONDS;
+	NpcsPerWave = NPCS_PER_WAVE;
+	MaxAliveNpcs = MAX_ALIVE_NPCS;
+}
+
+void UUnrealTestWaveSpawnerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (AUnrealTestGameMode* GameMode = GetOwner<AUnrealTestGameMode>())
+	{
+		GameMode->RegisterRoundResettable(this);
+	}
+}
+
+void UUnrealTestWaveSpawnerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopWaves();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UUnrealTestWaveSpawnerComponent::ResetForNewRound()
+{
+	StopWaves();
+
+	// NPCs go back to the actor pool with their AI controller parked, the next waves hand both out again
+	UUnrealTestActorPoolSubsystem* ActorPool = GetWorld()->GetSubsystem<UUnrealTestActorPoolSubsystem>();
+	UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>();
+	for (const TWeakObjectPtr<APawn>& Npc : SpawnedNpcs)
+	{
+		APawn* NpcPawn = Npc.Get();
+		if (NpcPawn == nullptr)
+		{
+			continue;
+		}
+
+		if (AController* NpcController = NpcPawn->GetController())
+		{
+			NpcController->UnPossess();
+			NpcController->SetActorTickEnabled(false);
+			IdleControllers.Add(NpcController);
+		}
+		if (UPawnMovementComponent* Movement = NpcPawn->GetMovementComponent())
+		{
+			Movement->StopMovementImmediately();
+		}
+
+		// Revive dead NPCs now rather than with their own reset, which may come later in the round reset
+		// and would put them back in the spatial hash while parked
+		UUnrealTestHealthComponent* Health = NpcPawn->FindComponentByClass<UUnrealTestHealthComponent>();
+		if (Health && Health->IsDead())
+		{
+			Health->ResetForNewRound();
+		}
+
+		ActorPool->ReleaseActor(NpcPawn);
+		SpatialHash->UnregisterPawn(NpcPawn);
+	}
+	SpawnedNpcs.Reset();
+}
+
+void UUnrealTestWaveSpawnerComponent::StartWaves()
+{
+	if (NpcClass == nullptr)
+	{
+		return;
+	}
+
+	UUnrealTestTimerSubsystem* Timers = GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>();
+	Timers->Cancel(WaveTimerHandle);
+	WaveTimerHandle = Timers->Schedule(FirstWaveDelaySeconds, FSimpleDelegate::CreateUObject(this, &UUnrealTestWaveSpawnerComponent::SpawnWave));
+}
+
+void UUnrealTestWaveSpawnerComponent::StopWaves()
+{
+	if (UUnrealTestTimerSubsystem* Timers = GetWorld() ? GetWorld()->GetSubsystem<UUnrealTestTimerSubsystem>() : nullptr)
+	{
+		Timers->Cancel(WaveTimerHandle);
+	}
+}
+
+void UUnrealTestWaveSpawnerComponent::SpawnWave()
+{
+	UWorld* World = GetWorld();
+	WaveTimerHandle = World->GetSubsystem<UUnrealTestTimerSubsystem>()->Schedule(WaveIntervalSeconds, FSimpleDelegate::CreateUObject(this, &UUnrealTestWaveSpawnerComponent::SpawnWave));
+
+	if (SpawnPoints.Num() == 0)
+	{
+		for (TActorIterator<APlayerStart> It(World); It; ++It)
+		{
+			SpawnPoints.Add(*It);
+		}
+	}
+
+	SpawnedNpcs.RemoveAllSwap([](const TWeakObjectPtr<APawn>& Npc) { return !Npc.IsValid(); });
+	const int32 NumAlive = GetNumAliveNpcs();
+	const int32 NumToSpawn = FMath::Min(NpcsPerWave, MaxAliveNpcs - NumAlive);
+	if (NumToSpawn <= 0 || SpawnPoints.Num() == 0)
+	{
+		return;
+	}
+
+	UUnrealTestActorPoolSubsystem* ActorPool = World->GetSubsystem<UUnrealTestActorPoolSubsystem>();
+	UUnrealTestSpatialHashSubsystem* SpatialHash = World->GetSubsystem<UUnrealTestSpatialHashSubsystem>();
+	UUnrealTestSpawnSelectionSubsystem* SpawnSelection = World->GetSubsystem<UUnrealTestSpawnSelectionSubsystem>();
+	for (int32 Index = 0; Index < NumToSpawn; ++Index)
+	{
+		// Away from the players like respawns, NPCs without a team count everybody as an enemy.
+		// Spawn points used by this wave already are avoided, maps without coverage pick at random
+		const AActor* SpawnPoint = SpawnSelection ? SpawnSelection->ChooseSpawnPoint(nullptr) : nullptr;
+		if (SpawnPoint == nullptr)
+		{
+			SpawnPoint = SpawnPoints[FMath::RandRange(0, SpawnPoints.Num() - 1)].Get();
+		}
+		if (SpawnPoint == nullptr)
+		{
+			continue;
+		}
+
+		APawn* Npc = ActorPool->AcquireActor<APawn>(NpcClass, SpawnPoint->GetActorTransform(), nullptr, nullptr);
+		if (Npc == nullptr)
+		{
+			continue;
+		}
+
+		// Out of the way of whoever already stands on the spot
+		Npc->TeleportTo(SpawnPoint->GetActorLocation(), SpawnPoint->GetActorRotation());
+		Npc->SetActorTickEnabled(true);
+
+		// Pawns set to be possessed when spawned come with their AI controller the first time,
+		// reused ones get back a parked controller, which starts its logic over
+		if (Npc->GetController() == nullptr)
+		{
+			AController* NpcController = nullptr;
+			while (NpcController == nullptr && IdleControllers.Num() > 0)
+			{
+				NpcController = IdleControllers.Pop(false).Get();
+			}
+
+			if (NpcController)
+			{
+				NpcController->SetActorTickEnabled(true);
+				NpcController->Possess(Npc);
+			}
+			else
+			{
+				Npc->SpawnDefaultController();
+			}
+		}
+
+		// Explosions, lag compensation and spawn selection find NPCs through the spatial hash, until they die or go back to the pool
+		SpatialHash->RegisterPawn(Npc);
+		UUnrealTestHealthComponent* Health = Npc->FindComponentByClass<UUnrealTestHealthComponent>();
+		if (Health && !Health->OnDeath.IsBoundToObject(this))
+		{
+			Health->OnDeath.AddUObject(this, &UUnrealTestWaveSpawnerComponent::HandleNpcDeath);
+		}
+
+		SpawnedNpcs.Add(Npc);
+	}
+
+	UE_LOG(LogUnrealTest, Verbose, TEXT("Wave spawned, %d NPCs alive"), GetNumAliveNpcs());
+}
+
+int32 UUnrealTestWaveSpawnerComponent::GetNumAliveNpcs() const
+{
+	// Dead NPCs stay in SpawnedNpcs until the round reset puts them back in the pool
+	int32 NumAlive = 0;
+	for (const TWeakObjectPtr<APawn>& Npc : SpawnedNpcs)
+	{
+		const UUnrealTestHealthComponent* Health = Npc.IsValid() ? Npc->FindComponentByClass<UUnrealTestHealthComponent>() : nullptr;
+		if (Npc.IsValid() && (Health == nullptr || !Health->IsDead()))
+		{
+			++NumAlive;
+		}
+	}
+	return NumAlive;
+}
+
+void UUnrealTestWaveSpawnerComponent::HandleNpcDeath(UUnrealTestHealthComponent* DeadHealth, AController* Killer)
+{
+	if (UUnrealTestSpatialHashSubsystem* SpatialHash = GetWorld()->GetSubsystem<UUnrealTestSpatialHashSubsystem>())
+	{
+		SpatialHash->UnregisterPawn(DeadHealth->GetOwner<APawn>());
+	}
+}
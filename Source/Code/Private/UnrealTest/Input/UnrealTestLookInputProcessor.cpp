@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Input/UnrealTestLookInputProcessor.h"
+
+FVector2D FUnrealTestLookInputProcessor::ApplyResponse(const FUnrealTestLookInputSettings& Settings, const FVector2D& Stick)
+{
+	// Radial dead zone keeps diagonals as responsive as the main axes
+	const float Magnitude = Stick.Size();
+	if (Magnitude <= Settings.InnerDeadZone)
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	const float Range = FMath::Max(Settings.OuterDeadZone - Settings.InnerDeadZone, KINDA_SMALL_NUMBER);
+	const float Scaled = FMath::Clamp((Magnitude - Settings.InnerDeadZone) / Range, 0.f, 1.f);
+	const float Curved = FMath::Pow(Scaled, Settings.ResponseExponent);
+
+	return Stick / Magnitude * Curved;
+}
+
+float FUnrealTestLookInputProcessor::GetAccelerationMultiplier(const FUnrealTestLookInputSettings& Settings) const
+{
+	const float Ramp = Settings.AccelerationRampTime > 0.f
+		? FMath::Clamp((AccelerationHoldSeconds - Settings.AccelerationDelay) / Settings.AccelerationRampTime, 0.f, 1.f)
+		: (AccelerationHoldSeconds >= Settings.AccelerationDelay ? 1.f : 0.f);
+
+	return FMath::Lerp(1.f, Settings.MaxAccelerationMultiplier, Ramp);
+}
+
+FVector2D FUnrealTestLookInputProcessor::Process(const FUnrealTestLookInputSettings& Settings, const FVector2D& Stick, float DeltaSeconds, float TurnRate)
+{
+	const float FrameSeconds = FMath::Clamp(DeltaSeconds, 0.f, Settings.MaxFrameSeconds);
+	const float Step = Settings.IntegrationStepSeconds;
+
+	// Steps that end inside this frame, the rest of the frame waits for the next one
+	const float StartSeconds = PendingSeconds;
+	const float TotalSeconds = PendingSeconds + FrameSeconds;
+	const int32 NumSteps = FMath::FloorToInt(TotalSeconds / Step);
+
+	FVector2D Delta = FVector2D::ZeroVector;
+	for (int32 StepIndex = 1; StepIndex <= NumSteps; ++StepIndex)
+	{
+		// The stick is assumed to move linearly from last frame's sample to this one
+		const float StepEnd = StepIndex * Step;
+		const float Alpha = FrameSeconds > 0.f ? FMath::Clamp((StepEnd - StartSeconds) / FrameSeconds, 0.f, 1.f) : 1.f;
+		const FVector2D Response = ApplyResponse(Settings, FMath::Lerp(PreviousStick, Stick, Alpha));
+
+		if (Response.Size() >= Settings.AccelerationThreshold)
+		{
+			AccelerationHoldSeconds += Step;
+		}
+		else
+		{
+			AccelerationHoldSeconds = 0.f;
+		}
+
+		Delta += Response * (TurnRate * GetAccelerationMultiplier(Settings) * Step);
+	}
+
+	// Less than a step is carried over, integrating it now would tie the trajectory to the frame rate
+	PendingSeconds = TotalSeconds - NumSteps * Step;
+	PreviousStick = Stick;
+	return Delta;
+}
+
+void FUnrealTestLookInputProcessor::Reset()
+{
+	PreviousStick = FVector2D::ZeroVector;
+	PendingSeconds = 0.f;
+	AccelerationHoldSeconds = 0.f;
+}
@@ -0,0 +1,38 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Input/UnrealTestMouseAimInputProcessor.h"
+
+#if !UE_SERVER
+#include "Input/Events.h"
+
+void FUnrealTestMouseAimInputProcessor::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
+{
+}
+
+bool FUnrealTestMouseAimInputProcessor::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	FrameDelta += MouseEvent.GetCursorDelta();
+	++NumFrameSamples;
+	return false;
+}
+
+bool FUnrealTestMouseAimInputProcessor::HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	if (!bHasClick && MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton)
+	{
+		bHasClick = true;
+		DeltaBeforeClick = FrameDelta;
+		ClickTimestamp = FPlatformTime::Seconds();
+	}
+	return false;
+}
+
+void FUnrealTestMouseAimInputProcessor::BeginFrame()
+{
+	FrameDelta = FVector2D::ZeroVector;
+	DeltaBeforeClick = FVector2D::ZeroVector;
+	ClickTimestamp = 0.0;
+	NumFrameSamples = 0;
+	bHasClick = false;
+}
+#endif
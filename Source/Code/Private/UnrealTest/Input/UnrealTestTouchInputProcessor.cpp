@@ -0,0 +1,179 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Input/UnrealTestTouchInputProcessor.h"
+
+#if !UE_SERVER
+#include "UnrealTest/UnrealTestStats.h"
+#include "Input/Events.h"
+
+DECLARE_CYCLE_STAT(TEXT("Touch Gesture Classification"), STAT_UnrealTest_TouchClassification, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Touch Events Per Frame"), STAT_UnrealTest_TouchEvents, STATGROUP_UnrealTest);
+
+FUnrealTestTouchInputProcessor::FUnrealTestTouchInputProcessor(const FUnrealTestTouchInputSettings& InSettings)
+	: Settings(InSettings)
+{
+}
+
+FUnrealTestTouchInputProcessor::~FUnrealTestTouchInputProcessor()
+{
+	// The task works on our members
+	ClassifyTask.Wait();
+}
+
+void FUnrealTestTouchInputProcessor::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
+{
+	SET_DWORD_STAT(STAT_UnrealTest_TouchEvents, PendingEvents.Num());
+
+	// A held move stick keeps its command without new events
+	if (PendingEvents.Num() == 0)
+	{
+		return;
+	}
+
+	// Nobody collected the previous batch, so it is merged with this one rather than raced
+	ClassifyTask.Wait();
+
+	Swap(BatchEvents, PendingEvents);
+	PendingEvents.Reset();
+	BatchViewportSize = ViewportSize;
+
+	ClassifyTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]() { ClassifyBatch(); });
+}
+
+bool FUnrealTestTouchInputProcessor::HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	QueueEvent(MouseEvent, ETouchEventType::Down);
+	return false;
+}
+
+bool FUnrealTestTouchInputProcessor::HandleMouseButtonUpEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	QueueEvent(MouseEvent, ETouchEventType::Up);
+	return false;
+}
+
+bool FUnrealTestTouchInputProcessor::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	QueueEvent(MouseEvent, ETouchEventType::Move);
+	return false;
+}
+
+void FUnrealTestTouchInputProcessor::QueueEvent(const FPointerEvent& MouseEvent, ETouchEventType Type)
+{
+	// Touches come through the mouse handlers, real mouse events are left to the mouse aim processor
+	if (!MouseEvent.IsTouchEvent() || MouseEvent.GetPointerIndex() >= ETouchIndex::MAX_TOUCHES)
+	{
+		return;
+	}
+
+	FTouchEvent& Event = PendingEvents.AddDefaulted_GetRef();
+	Event.Position = MouseEvent.GetScreenSpacePosition();
+	Event.PlatformTime = FPlatformTime::Seconds();
+	Event.PointerIndex = MouseEvent.GetPointerIndex();
+	Event.Type = Type;
+}
+
+void FUnrealTestTouchInputProcessor::SetViewportSize(const FVector2D& InViewportSize)
+{
+	ViewportSize = InViewportSize;
+}
+
+FUnrealTestInputCommandFrame FUnrealTestTouchInputProcessor::ConsumeCommand()
+{
+	ClassifyTask.Wait();
+
+	// The move stick is a state, looks, taps and jumps happen once
+	FUnrealTestInputCommandFrame Result = Command;
+	Command.Look = FVector2D::ZeroVector;
+	Command.bFire = false;
+	Command.bJump = false;
+	return Result;
+}
+
+void FUnrealTestTouchInputProcessor::ClassifyBatch()
+{
+	SCOPE_CYCLE_COUNTER(STAT_UnrealTest_TouchClassification);
+
+	// Touch devices run the game full screen, so screen space is viewport space
+	const float ScreenHeight = FMath::Max(float(BatchViewportSize.Y), 1.f);
+	const float MoveAreaRight = BatchViewportSize.X * Settings.MoveAreaWidth;
+	const float TapMaxDistanceSquared = FMath::Square(Settings.TapMaxDistance * ScreenHeight);
+
+	for (const FTouchEvent& Event : BatchEvents)
+	{
+		FFinger& Finger = Fingers[Event.PointerIndex];
+		switch (Event.Type)
+		{
+		case ETouchEventType::Down:
+			Finger = FFinger();
+			Finger.Start = Event.Position;
+			Finger.Last = Event.Position;
+			Finger.StartTime = Event.PlatformTime;
+			Finger.bDown = true;
+
+			// The first finger on the left drives the stick, any other one aims
+			if (MoveFinger == INDEX_NONE && Event.Position.X < MoveAreaRight)
+			{
+				MoveFinger = Event.PointerIndex;
+				Finger.bMoveStick = true;
+			}
+			break;
+
+		case ETouchEventType::Move:
+			if (!Finger.bDown)
+			{
+				break;
+			}
+
+			if (!Finger.bMoveStick)
+			{
+				// Dragging up looks up, which takes negative pitch input
+				Command.Look += FVector2D(Event.Position - Finger.Last) * (Settings.LookSensitivity / ScreenHeight);
+			}
+			Finger.Last = Event.Position;
+			Finger.MaxTravelSquared = FMath::Max(Finger.MaxTravelSquared, float(FVector2D::DistSquared(Event.Position, Finger.Start)));
+			break;
+
+		case ETouchEventType::Up:
+		{
+			if (!Finger.bDown)
+			{
+				break;
+			}
+
+			const bool bTap = Event.PlatformTime - Finger.StartTime <= Settings.TapMaxSeconds && Finger.MaxTravelSquared <= TapMaxDistanceSquared;
+			if (Finger.bMoveStick)
+			{
+				// Tapping the stick area jumps
+				MoveFinger = INDEX_NONE;
+				Command.bJump |= bTap;
+			}
+			else if (bTap && !Command.bFire)
+			{
+				Command.bFire = true;
+				Command.FirePlatformTime = Event.PlatformTime;
+			}
+			Finger.bDown = false;
+			break;
+		}
+		}
+	}
+
+	BatchEvents.Reset();
+
+	Command.Move = FVector2D::ZeroVector;
+	if (MoveFinger != INDEX_NONE)
+	{
+		const FFinger& Finger = Fingers[MoveFinger];
+		const FVector2D Stick = (Finger.Last - Finger.Start) / (Settings.MoveStickRadius * ScreenHeight);
+		const float Deflection = FMath::Min(float(Stick.Size()), 1.f);
+		if (Deflection > Settings.MoveDeadZone)
+		{
+			// Rescale past the dead zone so the stick still goes from 0 to 1, screen up is forward
+			const float Scaled = (Deflection - Settings.MoveDeadZone) / FMath::Max(1.f - Settings.MoveDeadZone, KINDA_SMALL_NUMBER);
+			const FVector2D Direction = Stick.GetSafeNormal();
+			Command.Move = FVector2D(-Direction.Y, Direction.X) * Scaled;
+		}
+	}
+}
+#endif
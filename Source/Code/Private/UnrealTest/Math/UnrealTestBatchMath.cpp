@@ -0,0 +1,380 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Math/UnrealTestBatchMath.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/VectorRegister.h"
+
+namespace UnrealTestBatchMath
+{
+	/** Number of elements handled by the SIMD loops, the rest goes through the scalar tail */
+	FORCEINLINE int32 GetVectorCount(int32 Num)
+	{
+		return Num & ~3;
+	}
+
+	/** Writes the lanes set in Bits as indices from Base, returns the new count */
+	FORCEINLINE int32 AppendLanes(int32 Bits, int32 Base, TArrayView<int32> OutIndices, int32 NumFound)
+	{
+		while (Bits != 0 && NumFound < OutIndices.Num())
+		{
+			OutIndices[NumFound++] = Base + FMath::CountTrailingZeros(uint32(Bits));
+			Bits &= Bits - 1;
+		}
+		return NumFound;
+	}
+}
+
+void FUnrealTestBatchMath::YawToDirections(TArrayView<const float> YawDegrees, TArrayView<float> OutForwardX, TArrayView<float> OutForwardY)
+{
+	check(OutForwardX.Num() == YawDegrees.Num() && OutForwardY.Num() == YawDegrees.Num());
+
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(YawDegrees.Num());
+	const VectorRegister4Float DegreesToRadians = VectorSetFloat1(PI / 180.f);
+	for (int32 Index = 0; Index < VectorCount; Index += 4)
+	{
+		const VectorRegister4Float Radians = VectorMultiply(VectorLoad(&YawDegrees[Index]), DegreesToRadians);
+		VectorRegister4Float Sin;
+		VectorRegister4Float Cos;
+		VectorSinCos(&Sin, &Cos, &Radians);
+		VectorStore(Cos, &OutForwardX[Index]);
+		VectorStore(Sin, &OutForwardY[Index]);
+	}
+
+	for (int32 Index = VectorCount; Index < YawDegrees.Num(); ++Index)
+	{
+		FMath::SinCos(&OutForwardY[Index], &OutForwardX[Index], FMath::DegreesToRadians(YawDegrees[Index]));
+	}
+}
+
+void FUnrealTestBatchMath::DistanceSquared(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Center, TArrayView<float> OutDistanceSquared)
+{
+	check(Y.Num() == X.Num() && Z.Num() == X.Num() && OutDistanceSquared.Num() == X.Num());
+
+	const VectorRegister4Float CenterX = VectorSetFloat1(float(Center.X));
+	const VectorRegister4Float CenterY = VectorSetFloat1(float(Center.Y));
+	const VectorRegister4Float CenterZ = VectorSetFloat1(float(Center.Z));
+
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(X.Num());
+	for (int32 Index = 0; Index < VectorCount; Index += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&X[Index]), CenterX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&Y[Index]), CenterY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&Z[Index]), CenterZ);
+		VectorStore(VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ))), &OutDistanceSquared[Index]);
+	}
+
+	for (int32 Index = VectorCount; Index < X.Num(); ++Index)
+	{
+		OutDistanceSquared[Index] = FMath::Square(X[Index] - float(Center.X)) + FMath::Square(Y[Index] - float(Center.Y)) + FMath::Square(Z[Index] - float(Center.Z));
+	}
+}
+
+int32 FUnrealTestBatchMath::CullSphere(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Center, float Radius, TArrayView<int32> OutIndices)
+{
+	check(Y.Num() == X.Num() && Z.Num() == X.Num());
+
+	const float RadiusSquared = FMath::Square(Radius);
+	const VectorRegister4Float CenterX = VectorSetFloat1(float(Center.X));
+	const VectorRegister4Float CenterY = VectorSetFloat1(float(Center.Y));
+	const VectorRegister4Float CenterZ = VectorSetFloat1(float(Center.Z));
+	const VectorRegister4Float MaxDistanceSquared = VectorSetFloat1(RadiusSquared);
+
+	int32 NumFound = 0;
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(X.Num());
+	for (int32 Index = 0; Index < VectorCount && NumFound < OutIndices.Num(); Index += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&X[Index]), CenterX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&Y[Index]), CenterY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&Z[Index]), CenterZ);
+		const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+		NumFound = UnrealTestBatchMath::AppendLanes(VectorMaskBits(VectorCompareLE(DistanceSquared, MaxDistanceSquared)), Index, OutIndices, NumFound);
+	}
+
+	for (int32 Index = VectorCount; Index < X.Num() && NumFound < OutIndices.Num(); ++Index)
+	{
+		const float DistanceSquared = FMath::Square(X[Index] - float(Center.X)) + FMath::Square(Y[Index] - float(Center.Y)) + FMath::Square(Z[Index] - float(Center.Z));
+		if (DistanceSquared <= RadiusSquared)
+		{
+			OutIndices[NumFound++] = Index;
+		}
+	}
+
+	return NumFound;
+}
+
+int32 FUnrealTestBatchMath::CullCone(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Origin, const FVector& Direction, float CosHalfAngle, float Range, TArrayView<int32> OutIndices)
+{
+	check(Y.Num() == X.Num() && Z.Num() == X.Num());
+
+	// Dot >= Cos * Distance without a square root, the signed squares keep the test right for wide cones too
+	const float RangeSquared = FMath::Square(Range);
+	const float SignedCosSquared = CosHalfAngle * FMath::Abs(CosHalfAngle);
+	const VectorRegister4Float OriginX = VectorSetFloat1(float(Origin.X));
+	const VectorRegister4Float OriginY = VectorSetFloat1(float(Origin.Y));
+	const VectorRegister4Float OriginZ = VectorSetFloat1(float(Origin.Z));
+	const VectorRegister4Float DirectionX = VectorSetFloat1(float(Direction.X));
+	const VectorRegister4Float DirectionY = VectorSetFloat1(float(Direction.Y));
+	const VectorRegister4Float DirectionZ = VectorSetFloat1(float(Direction.Z));
+	const VectorRegister4Float MaxDistanceSquared = VectorSetFloat1(RangeSquared);
+	const VectorRegister4Float ConeLimit = VectorSetFloat1(SignedCosSquared);
+
+	int32 NumFound = 0;
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(X.Num());
+	for (int32 Index = 0; Index < VectorCount && NumFound < OutIndices.Num(); Index += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&X[Index]), OriginX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&Y[Index]), OriginY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&Z[Index]), OriginZ);
+		const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+		const VectorRegister4Float Dot = VectorMultiplyAdd(DeltaX, DirectionX, VectorMultiplyAdd(DeltaY, DirectionY, VectorMultiply(DeltaZ, DirectionZ)));
+		const VectorRegister4Float InRange = VectorCompareLE(DistanceSquared, MaxDistanceSquared);
+		const VectorRegister4Float InCone = VectorCompareGE(VectorMultiply(Dot, VectorAbs(Dot)), VectorMultiply(ConeLimit, DistanceSquared));
+		NumFound = UnrealTestBatchMath::AppendLanes(VectorMaskBits(VectorBitwiseAnd(InRange, InCone)), Index, OutIndices, NumFound);
+	}
+
+	for (int32 Index = VectorCount; Index < X.Num() && NumFound < OutIndices.Num(); ++Index)
+	{
+		const FVector3f Delta(X[Index] - float(Origin.X), Y[Index] - float(Origin.Y), Z[Index] - float(Origin.Z));
+		const float DistanceSquared = Delta.SizeSquared();
+		const float Dot = Delta.X * float(Direction.X) + Delta.Y * float(Direction.Y) + Delta.Z * float(Direction.Z);
+		if (DistanceSquared <= RangeSquared && Dot * FMath::Abs(Dot) >= SignedCosSquared * DistanceSquared)
+		{
+			OutIndices[NumFound++] = Index;
+		}
+	}
+
+	return NumFound;
+}
+
+void FUnrealTestBatchMath::DistanceFalloff(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Center, float MaxDistance, TArrayView<float> OutValues)
+{
+	check(Y.Num() == X.Num() && Z.Num() == X.Num() && OutValues.Num() == X.Num());
+
+	const float InvMaxDistance = 1.f / FMath::Max(MaxDistance, KINDA_SMALL_NUMBER);
+	const VectorRegister4Float CenterX = VectorSetFloat1(float(Center.X));
+	const VectorRegister4Float CenterY = VectorSetFloat1(float(Center.Y));
+	const VectorRegister4Float CenterZ = VectorSetFloat1(float(Center.Z));
+	const VectorRegister4Float InvMax = VectorSetFloat1(InvMaxDistance);
+	const VectorRegister4Float MinDistanceSquared = VectorSetFloat1(SMALL_NUMBER);
+
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(X.Num());
+	for (int32 Index = 0; Index < VectorCount; Index += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&X[Index]), CenterX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&Y[Index]), CenterY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&Z[Index]), CenterZ);
+		const VectorRegister4Float DistanceSquared = VectorMax(VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ))), MinDistanceSquared);
+
+		// Distance as DistanceSquared / Distance, through the reciprocal square root
+		const VectorRegister4Float Distance = VectorMultiply(DistanceSquared, VectorReciprocalSqrt(DistanceSquared));
+		const VectorRegister4Float Falloff = VectorSubtract(VectorOneFloat(), VectorMin(VectorMultiply(Distance, InvMax), VectorOneFloat()));
+		VectorStore(Falloff, &OutValues[Index]);
+	}
+
+	for (int32 Index = VectorCount; Index < X.Num(); ++Index)
+	{
+		const float Distance = FMath::Sqrt(FMath::Square(X[Index] - float(Center.X)) + FMath::Square(Y[Index] - float(Center.Y)) + FMath::Square(Z[Index] - float(Center.Z)));
+		OutValues[Index] = 1.f - FMath::Min(Distance * InvMaxDistance, 1.f);
+	}
+}
+
+void FUnrealTestBatchMath::ScaleOutsideCone2D(TArrayView<const float> X, TArrayView<const float> Y, const FVector& Origin, const FVector& Direction, float CosHalfAngle, float OutsideScale, TArrayView<float> InOutValues)
+{
+	check(Y.Num() == X.Num() && InOutValues.Num() == X.Num());
+
+	const float SignedCosSquared = CosHalfAngle * FMath::Abs(CosHalfAngle);
+	const VectorRegister4Float OriginX = VectorSetFloat1(float(Origin.X));
+	const VectorRegister4Float OriginY = VectorSetFloat1(float(Origin.Y));
+	const VectorRegister4Float DirectionX = VectorSetFloat1(float(Direction.X));
+	const VectorRegister4Float DirectionY = VectorSetFloat1(float(Direction.Y));
+	const VectorRegister4Float ConeLimit = VectorSetFloat1(SignedCosSquared);
+	const VectorRegister4Float Outside = VectorSetFloat1(OutsideScale);
+
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(X.Num());
+	for (int32 Index = 0; Index < VectorCount; Index += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&X[Index]), OriginX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&Y[Index]), OriginY);
+		const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+		const VectorRegister4Float Dot = VectorMultiplyAdd(DeltaX, DirectionX, VectorMultiply(DeltaY, DirectionY));
+
+		// Points on the origin count as in view
+		const VectorRegister4Float InCone = VectorCompareGE(VectorMultiply(Dot, VectorAbs(Dot)), VectorMultiply(ConeLimit, DistanceSquared));
+		const VectorRegister4Float Scale = VectorSelect(InCone, VectorOneFloat(), Outside);
+		VectorStore(VectorMultiply(VectorLoad(&InOutValues[Index]), Scale), &InOutValues[Index]);
+	}
+
+	for (int32 Index = VectorCount; Index < X.Num(); ++Index)
+	{
+		const float DeltaX = X[Index] - float(Origin.X);
+		const float DeltaY = Y[Index] - float(Origin.Y);
+		const float Dot = DeltaX * float(Direction.X) + DeltaY * float(Direction.Y);
+		if (Dot * FMath::Abs(Dot) < SignedCosSquared * (DeltaX * DeltaX + DeltaY * DeltaY))
+		{
+			InOutValues[Index] *= OutsideScale;
+		}
+	}
+}
+
+void FUnrealTestBatchMath::Interpolate(TArrayView<float> InOutValues, TArrayView<const float> Targets, float Alpha)
+{
+	check(Targets.Num() == InOutValues.Num());
+
+	const VectorRegister4Float VectorAlpha = VectorSetFloat1(Alpha);
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(InOutValues.Num());
+	for (int32 Index = 0; Index < VectorCount; Index += 4)
+	{
+		const VectorRegister4Float Value = VectorLoad(&InOutValues[Index]);
+		VectorStore(VectorMultiplyAdd(VectorSubtract(VectorLoad(&Targets[Index]), Value), VectorAlpha, Value), &InOutValues[Index]);
+	}
+
+	for (int32 Index = VectorCount; Index < InOutValues.Num(); ++Index)
+	{
+		InOutValues[Index] = FMath::Lerp(InOutValues[Index], Targets[Index], Alpha);
+	}
+}
+
+void FUnrealTestBatchMath::Max(TArrayView<float> InOutValues, TArrayView<const float> Others)
+{
+	check(Others.Num() == InOutValues.Num());
+
+	const int32 VectorCount = UnrealTestBatchMath::GetVectorCount(InOutValues.Num());
+	for (int32 Index = 0; Index < VectorCount; Index += 4)
+	{
+		VectorStore(VectorMax(VectorLoad(&InOutValues[Index]), VectorLoad(&Others[Index])), &InOutValues[Index]);
+	}
+
+	for (int32 Index = VectorCount; Index < InOutValues.Num(); ++Index)
+	{
+		InOutValues[Index] = FMath::Max(InOutValues[Index], Others[Index]);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static FAutoConsoleCommandWithArgs MathBenchmarkCommand(
+	TEXT("UnrealTest.Math.Benchmark"),
+	TEXT("Runs the batch math kernels and the equivalent scalar FMath code over N random characters and reports time and largest difference. Usage: UnrealTest.Math.Benchmark [Characters] [Repeats]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const int32 Num = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+		const int32 NumRepeats = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1000;
+		const float ArenaHalfSize = 10000.f;
+
+		FRandomStream Random(Num);
+		TArray<float> X, Y, Z, Yaw, Targets;
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			X.Add(Random.FRandRange(-ArenaHalfSize, ArenaHalfSize));
+			Y.Add(Random.FRandRange(-ArenaHalfSize, ArenaHalfSize));
+			Z.Add(Random.FRandRange(0.f, 500.f));
+			Yaw.Add(Random.FRandRange(-180.f, 180.f));
+			Targets.Add(Random.FRand());
+		}
+
+		TArray<float> OutA, OutB, ScalarA, ScalarB, Values;
+		OutA.SetNumZeroed(Num);
+		OutB.SetNumZeroed(Num);
+		ScalarA.SetNumZeroed(Num);
+		ScalarB.SetNumZeroed(Num);
+		Values.SetNumZeroed(Num);
+		TArray<int32> Indices;
+		Indices.SetNumUninitialized(Num);
+
+		const FVector Center(0.f, 0.f, 250.f);
+		const FVector Direction(1.f, 0.f, 0.f);
+		const float Radius = 3000.f;
+		const float CosHalfAngle = 0.5f;
+
+		auto MaxDifference = [Num](const TArray<float>& A, const TArray<float>& B)
+		{
+			float Difference = 0.f;
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Difference = FMath::Max(Difference, FMath::Abs(A[Index] - B[Index]));
+			}
+			return Difference;
+		};
+
+		auto Time = [NumRepeats](TFunctionRef<void()> Function)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+			{
+				Function();
+			}
+			return (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumRepeats;
+		};
+
+		UE_LOG(LogUnrealTest, Display, TEXT("Batch math benchmark, %d characters, average of %d runs:"), Num, NumRepeats);
+
+		const double YawBatch = Time([&]() { FUnrealTestBatchMath::YawToDirections(Yaw, OutA, OutB); });
+		const double YawScalar = Time([&]()
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				const FVector Forward = FRotationMatrix(FRotator(0.f, Yaw[Index], 0.f)).GetUnitAxis(EAxis::X);
+				ScalarA[Index] = Forward.X;
+				ScalarB[Index] = Forward.Y;
+			}
+		});
+		UE_LOG(LogUnrealTest, Display, TEXT("  Yaw to directions: batch %.4f ms, rotation matrix %.4f ms, max difference %g"),
+			YawBatch, YawScalar, FMath::Max(MaxDifference(OutA, ScalarA), MaxDifference(OutB, ScalarB)));
+
+		const double DistanceBatch = Time([&]() { FUnrealTestBatchMath::DistanceSquared(X, Y, Z, Center, OutA); });
+		const double DistanceScalar = Time([&]()
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				ScalarA[Index] = FVector::DistSquared(FVector(X[Index], Y[Index], Z[Index]), Center);
+			}
+		});
+		UE_LOG(LogUnrealTest, Display, TEXT("  Distance squared:  batch %.4f ms, scalar %.4f ms, max relative difference %g"),
+			DistanceBatch, DistanceScalar, MaxDifference(OutA, ScalarA) / FMath::Square(ArenaHalfSize));
+
+		int32 BatchFound = 0;
+		int32 ScalarFound = 0;
+		const double CullBatch = Time([&]() { BatchFound = FUnrealTestBatchMath::CullCone(X, Y, Z, Center, Direction, CosHalfAngle, Radius, Indices); });
+		const double CullScalar = Time([&]()
+		{
+			ScalarFound = 0;
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				const FVector Delta = FVector(X[Index], Y[Index], Z[Index]) - Center;
+				if (Delta.Size() <= Radius && FVector::DotProduct(Delta.GetSafeNormal(), Direction) >= CosHalfAngle)
+				{
+					Indices[ScalarFound++] = Index;
+				}
+			}
+		});
+		UE_LOG(LogUnrealTest, Display, TEXT("  Cone cull:         batch %.4f ms, scalar %.4f ms, found %d / %d"), CullBatch, CullScalar, BatchFound, ScalarFound);
+
+		const double FalloffBatch = Time([&]()
+		{
+			FUnrealTestBatchMath::DistanceFalloff(X, Y, Z, Center, Radius, OutA);
+			FUnrealTestBatchMath::ScaleOutsideCone2D(X, Y, Center, Direction, CosHalfAngle, 0.3f, OutA);
+		});
+		const double FalloffScalar = Time([&]()
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				const FVector Delta = FVector(X[Index], Y[Index], Z[Index]) - Center;
+				const bool bInView = FVector::DotProduct(Delta.GetSafeNormal2D(), Direction) >= CosHalfAngle;
+				ScalarA[Index] = (1.f - FMath::Clamp(Delta.Size() / Radius, 0.f, 1.f)) * (bInView ? 1.f : 0.3f);
+			}
+		});
+		UE_LOG(LogUnrealTest, Display, TEXT("  Relevancy score:   batch %.4f ms, scalar %.4f ms, max difference %g"),
+			FalloffBatch, FalloffScalar, MaxDifference(OutA, ScalarA));
+
+		const double LerpBatch = Time([&]() { FUnrealTestBatchMath::Interpolate(Values, Targets, 0.1f); });
+		const double LerpScalar = Time([&]()
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				ScalarA[Index] = FMath::Lerp(ScalarA[Index], Targets[Index], 0.1f);
+			}
+		});
+		UE_LOG(LogUnrealTest, Display, TEXT("  Interpolation:     batch %.4f ms, scalar %.4f ms"), LerpBatch, LerpScalar);
+	}));
@@ -0,0 +1,194 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Memory/UnrealTestFrameArena.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame Arena Allocations"), STAT_UnrealTest_FrameArenaAllocations, STATGROUP_UnrealTest);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frame Arena Heap Allocations"), STAT_UnrealTest_FrameArenaHeapAllocations, STATGROUP_UnrealTest);
+DECLARE_MEMORY_STAT(TEXT("Frame Arena Used"), STAT_UnrealTest_FrameArenaUsed, STATGROUP_UnrealTest);
+DECLARE_MEMORY_STAT(TEXT("Frame Arena Capacity"), STAT_UnrealTest_FrameArenaCapacity, STATGROUP_UnrealTest);
+
+FUnrealTestFrameArena& FUnrealTestFrameArena::Get()
+{
+	check(IsInGameThread());
+
+	static FUnrealTestFrameArena Arena;
+	static const FDelegateHandle ResetHandle = FCoreDelegates::OnEndFrame.AddRaw(&Arena, &FUnrealTestFrameArena::Reset);
+	return Arena;
+}
+
+FUnrealTestFrameArena::FUnrealTestFrameArena()
+	: CurrentBlock(INDEX_NONE)
+	, Cursor(0)
+	, End(0)
+	, LastAllocation(nullptr)
+	, Frame(0)
+	, NumAllocations(0)
+	, NumHeapAllocations(0)
+	, ReportFramesLeft(0)
+	, ReportFrames(0)
+	, ReportAllocations(0)
+	, ReportHeapAllocations(0)
+	, ReportPeakBytes(0)
+{
+}
+
+FUnrealTestFrameArena::~FUnrealTestFrameArena()
+{
+	for (const FBlock& Block : Blocks)
+	{
+		FMemory::Free(Block.Memory);
+	}
+}
+
+void* FUnrealTestFrameArena::Allocate(SIZE_T Size, uint32 Alignment)
+{
+	UPTRINT Result = Align(Cursor, Alignment);
+	if (CurrentBlock == INDEX_NONE || Result + Size > End)
+	{
+		NextBlock(Size + Alignment);
+		Result = Align(Cursor, Alignment);
+	}
+
+	Cursor = Result + Size;
+	LastAllocation = (void*)Result;
+	++NumAllocations;
+	INC_DWORD_STAT(STAT_UnrealTest_FrameArenaAllocations);
+	return LastAllocation;
+}
+
+void* FUnrealTestFrameArena::Reallocate(void* Ptr, SIZE_T NumBytesToKeep, SIZE_T NewSize, uint32 Alignment)
+{
+	// Arrays usually grow while nothing else is allocated, the latest allocation just moves the cursor
+	if (Ptr != nullptr && Ptr == LastAllocation && UPTRINT(Ptr) + NewSize <= End)
+	{
+		Cursor = UPTRINT(Ptr) + NewSize;
+		return Ptr;
+	}
+
+	void* Result = Allocate(NewSize, Alignment);
+	if (Ptr != nullptr && NumBytesToKeep > 0)
+	{
+		FMemory::Memcpy(Result, Ptr, FMath::Min(NumBytesToKeep, NewSize));
+	}
+	return Result;
+}
+
+void FUnrealTestFrameArena::NextBlock(SIZE_T MinSize)
+{
+	// Blocks after the current one were left by a frame that needed more, reuse them before allocating
+	const int32 NextIndex = CurrentBlock + 1;
+	if (!Blocks.IsValidIndex(NextIndex) || Blocks[NextIndex].Size < MinSize)
+	{
+		FBlock Block;
+		Block.Size = FMath::Max(MinSize, DEFAULT_BLOCK_SIZE);
+		Block.Memory = (uint8*)FMemory::Malloc(Block.Size, MIN_ALIGNMENT);
+		Blocks.Insert(Block, NextIndex);
+
+		++NumHeapAllocations;
+		INC_DWORD_STAT(STAT_UnrealTest_FrameArenaHeapAllocations);
+		INC_MEMORY_STAT_BY(STAT_UnrealTest_FrameArenaCapacity, Block.Size);
+	}
+
+	CurrentBlock = NextIndex;
+	Cursor = UPTRINT(Blocks[CurrentBlock].Memory);
+	End = Cursor + Blocks[CurrentBlock].Size;
+}
+
+SIZE_T FUnrealTestFrameArena::GetUsedBytes() const
+{
+	if (CurrentBlock == INDEX_NONE)
+	{
+		return 0;
+	}
+
+	SIZE_T UsedBytes = Cursor - UPTRINT(Blocks[CurrentBlock].Memory);
+	for (int32 BlockIndex = 0; BlockIndex < CurrentBlock; ++BlockIndex)
+	{
+		UsedBytes += Blocks[BlockIndex].Size;
+	}
+	return UsedBytes;
+}
+
+SIZE_T FUnrealTestFrameArena::GetCapacity() const
+{
+	SIZE_T Capacity = 0;
+	for (const FBlock& Block : Blocks)
+	{
+		Capacity += Block.Size;
+	}
+	return Capacity;
+}
+
+void FUnrealTestFrameArena::Reset()
+{
+	const SIZE_T UsedBytes = GetUsedBytes();
+	SET_MEMORY_STAT(STAT_UnrealTest_FrameArenaUsed, UsedBytes);
+
+	if (ReportFramesLeft > 0)
+	{
+		ReportAllocations += NumAllocations;
+		ReportHeapAllocations += NumHeapAllocations;
+		ReportPeakBytes = FMath::Max(ReportPeakBytes, UsedBytes);
+
+		if (--ReportFramesLeft == 0)
+		{
+			UE_LOG(LogUnrealTest, Display, TEXT("Frame arena over %d frames: %.1f allocations per frame served by the arena, %lld heap allocations, %llu bytes at peak"),
+				ReportFrames, double(ReportAllocations) / ReportFrames, ReportHeapAllocations, uint64(ReportPeakBytes));
+		}
+	}
+
+	// A frame that needed several blocks gets them as one for the next frames
+	if (Blocks.Num() > 1)
+	{
+		SIZE_T TotalSize = 0;
+		for (const FBlock& Block : Blocks)
+		{
+			TotalSize += Block.Size;
+			FMemory::Free(Block.Memory);
+		}
+
+		FBlock Merged;
+		Merged.Size = TotalSize;
+		Merged.Memory = (uint8*)FMemory::Malloc(TotalSize, MIN_ALIGNMENT);
+		Blocks.Reset();
+		Blocks.Add(Merged);
+		SET_MEMORY_STAT(STAT_UnrealTest_FrameArenaCapacity, TotalSize);
+	}
+
+	if (Blocks.Num() > 0)
+	{
+		CurrentBlock = 0;
+		Cursor = UPTRINT(Blocks[0].Memory);
+		End = Cursor + Blocks[0].Size;
+	}
+
+	LastAllocation = nullptr;
+	NumAllocations = 0;
+	NumHeapAllocations = 0;
+	++Frame;
+}
+
+void FUnrealTestFrameArena::StartReport(int32 NumFrames)
+{
+	ReportFrames = FMath::Max(NumFrames, 1);
+	ReportFramesLeft = ReportFrames;
+	ReportAllocations = 0;
+	ReportHeapAllocations = 0;
+	ReportPeakBytes = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static FAutoConsoleCommandWithArgs FrameArenaReportCommand(
+	TEXT("UnrealTest.FrameArena.Report"),
+	TEXT("Counts the allocations of gameplay queries over N frames and how many of them still reached the heap. Run it during a bot match, after warm up the heap count should be 0. Usage: UnrealTest.FrameArena.Report [Frames]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		const int32 NumFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 600;
+		FUnrealTestFrameArena::Get().StartReport(NumFrames);
+	}));
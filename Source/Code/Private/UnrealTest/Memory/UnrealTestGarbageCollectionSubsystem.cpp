@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Memory/UnrealTestGarbageCollectionSubsystem.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("GC Last Pause (ms)"), STAT_UnrealTest_GCLastPause, STATGROUP_UnrealTest);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("GC Longest Pause (ms)"), STAT_UnrealTest_GCLongestPause, STATGROUP_UnrealTest);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("GC Collections"), STAT_UnrealTest_GCCollections, STATGROUP_UnrealTest);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("GC Collections During Rounds"), STAT_UnrealTest_GCCollectionsDuringRounds, STATGROUP_UnrealTest);
+
+static const TCHAR* TimeBetweenCollectionsName = TEXT("gc.TimeBetweenPurgingPendingKillObjects");
+
+float UUnrealTestGarbageCollectionSubsystem::DefaultSecondsBetweenCollections = 0.f;
+int32 UUnrealTestGarbageCollectionSubsystem::NumDeferringWorlds = 0;
+
+UUnrealTestGarbageCollectionSubsystem::UUnrealTestGarbageCollectionSubsystem()
+{
+	CollectOnPhases = { EUnrealTestMatchPhase::WaitingForPlayers, EUnrealTestMatchPhase::RoundEnd };
+	bFullPurge = false;
+	bDeferDuringRounds = true;
+	RoundSecondsBetweenCollections = ROUND_SECONDS_BETWEEN_COLLECTIONS;
+
+	MatchPhase = EUnrealTestMatchPhase::WaitingForPlayers;
+	bIsDeferring = false;
+	CollectionStartTime = 0.0;
+	NumCollections = 0;
+	NumCollectionsDuringRounds = 0;
+	LongestPauseMs = 0.f;
+	TotalPauseMs = 0.f;
+}
+
+void UUnrealTestGarbageCollectionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (GetWorld()->IsGameWorld())
+	{
+		PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UUnrealTestGarbageCollectionSubsystem::OnPreGarbageCollect);
+		PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UUnrealTestGarbageCollectionSubsystem::OnPostGarbageCollect);
+	}
+}
+
+void UUnrealTestGarbageCollectionSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	SetDeferred(false);
+
+	Super::Deinitialize();
+}
+
+void UUnrealTestGarbageCollectionSubsystem::OnMatchPhaseChanged(EUnrealTestMatchPhase NewPhase)
+{
+	if (NewPhase == MatchPhase)
+	{
+		return;
+	}
+	MatchPhase = NewPhase;
+
+	SetDeferred(bDeferDuringRounds && NewPhase == EUnrealTestMatchPhase::InProgress);
+
+	// Reachability runs at the end of this frame, the purge then takes a slice of every frame until it is done
+	if (CollectOnPhases.Contains(NewPhase) && GEngine != nullptr)
+	{
+		GEngine->ForceGarbageCollection(bFullPurge);
+	}
+}
+
+void UUnrealTestGarbageCollectionSubsystem::SetDeferred(bool bDeferred)
+{
+	if (bDeferred == bIsDeferring)
+	{
+		return;
+	}
+
+	IConsoleVariable* TimeBetweenCollections = IConsoleManager::Get().FindConsoleVariable(TimeBetweenCollectionsName);
+	if (TimeBetweenCollections == nullptr)
+	{
+		return;
+	}
+	bIsDeferring = bDeferred;
+
+	// Listen servers and play in editor run several worlds, the first one in remembers the engine setting
+	// and the last one out puts it back
+	if (bDeferred)
+	{
+		if (NumDeferringWorlds++ == 0)
+		{
+			DefaultSecondsBetweenCollections = TimeBetweenCollections->GetFloat();
+			TimeBetweenCollections->Set(RoundSecondsBetweenCollections, ECVF_SetByCode);
+		}
+	}
+	else if (--NumDeferringWorlds == 0)
+	{
+		TimeBetweenCollections->Set(DefaultSecondsBetweenCollections, ECVF_SetByCode);
+	}
+}
+
+void UUnrealTestGarbageCollectionSubsystem::OnPreGarbageCollect()
+{
+	CollectionStartTime = FPlatformTime::Seconds();
+}
+
+void UUnrealTestGarbageCollectionSubsystem::OnPostGarbageCollect()
+{
+	const float PauseMs = float((FPlatformTime::Seconds() - CollectionStartTime) * 1000.0);
+	const bool bDuringRound = MatchPhase == EUnrealTestMatchPhase::InProgress;
+
+	++NumCollections;
+	NumCollectionsDuringRounds += bDuringRound ? 1 : 0;
+	LongestPauseMs = FMath::Max(LongestPauseMs, PauseMs);
+	TotalPauseMs += PauseMs;
+
+	SET_FLOAT_STAT(STAT_UnrealTest_GCLastPause, PauseMs);
+	SET_FLOAT_STAT(STAT_UnrealTest_GCLongestPause, LongestPauseMs);
+	SET_DWORD_STAT(STAT_UnrealTest_GCCollections, NumCollections);
+	SET_DWORD_STAT(STAT_UnrealTest_GCCollectionsDuringRounds, NumCollectionsDuringRounds);
+
+	if (bDuringRound)
+	{
+		UE_LOG(LogUnrealTest, Log, TEXT("%s: garbage collected during a round, paused %.2f ms"), *GetWorld()->GetMapName(), PauseMs);
+	}
+	else
+	{
+		UE_LOG(LogUnrealTest, Verbose, TEXT("%s: garbage collected, paused %.2f ms"), *GetWorld()->GetMapName(), PauseMs);
+	}
+}
+
+void UUnrealTestGarbageCollectionSubsystem::DumpStats() const
+{
+	UE_LOG(LogUnrealTest, Display, TEXT("Garbage collection of %s: %d collections, %d during rounds, longest pause %.2f ms, average %.2f ms, %s"),
+		*GetWorld()->GetMapName(), NumCollections, NumCollectionsDuringRounds, LongestPauseMs,
+		NumCollections > 0 ? TotalPauseMs / NumCollections : 0.f, bIsDeferring ? TEXT("deferred") : TEXT("not deferred"));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Debug
+
+static FAutoConsoleCommandWithWorld GarbageCollectionReportCommand(
+	TEXT("UnrealTest.GC.Report"),
+	TEXT("Logs how many garbage collections ran, how many of them during rounds, and their longest and average pauses."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		if (const UUnrealTestGarbageCollectionSubsystem* GarbageCollection = World ? World->GetSubsystem<UUnrealTestGarbageCollectionSubsystem>() : nullptr)
+		{
+			GarbageCollection->DumpStats();
+		}
+	}));
@@ -0,0 +1,257 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Net/UnrealTestNetPrioritizerSubsystem.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Game/UnrealTestVisibilitySubsystem.h"
+#include "UnrealTest/Math/UnrealTestBatchMath.h"
+#include "UnrealTest/Memory/UnrealTestFrameArena.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+UUnrealTestNetPrioritizerSubsystem::UUnrealTestNetPrioritizerSubsystem()
+{
+	CellSize = CELL_SIZE;
+	MaxRelevantDistance = MAX_RELEVANT_DISTANCE;
+	ViewConeCosine = VIEW_CONE_COSINE;
+	OutOfViewScale = OUT_OF_VIEW_SCALE;
+	OccludedScale = OCCLUDED_SCALE;
+	CombatMemorySeconds = COMBAT_MEMORY_SECONDS;
+	MinNetUpdateFrequency = MIN_NET_UPDATE_FREQUENCY;
+	MaxNetUpdateFrequency = MAX_NET_UPDATE_FREQUENCY;
+	FrequencyUpdateInterval = FREQUENCY_UPDATE_INTERVAL;
+
+	Visibility = nullptr;
+	SpatialScoreCacheFrame = 0;
+	TimeUntilFrequencyUpdate = 0.f;
+}
+
+void UUnrealTestNetPrioritizerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Visibility = Cast<UUnrealTestVisibilitySubsystem>(Collection.InitializeDependency(UUnrealTestVisibilitySubsystem::StaticClass()));
+}
+
+TStatId UUnrealTestNetPrioritizerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUnrealTestNetPrioritizerSubsystem, STATGROUP_Tickables);
+}
+
+void UUnrealTestNetPrioritizerSubsystem::RegisterCharacter(AUnrealTestCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UUnrealTestNetPrioritizerSubsystem::UnregisterCharacter(AUnrealTestCharacter* Character)
+{
+	Characters.RemoveSingleSwap(Character);
+}
+
+void UUnrealTestNetPrioritizerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	TimeUntilFrequencyUpdate -= DeltaTime;
+	if (TimeUntilFrequencyUpdate <= 0.f)
+	{
+		TimeUntilFrequencyUpdate = FrequencyUpdateInterval;
+		UpdateNetUpdateFrequencies();
+	}
+}
+
+FIntVector UUnrealTestNetPrioritizerSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+float UUnrealTestNetPrioritizerSubsystem::GetRelevancyScore(const AActor* Target, const FVector& ViewPos, const FVector& ViewDir, const AActor* ViewTarget)
+{
+	if (Target == ViewTarget)
+	{
+		return 1.f;
+	}
+
+	float SpatialScore = GetSpatialScore(GetCell(ViewPos), ViewDir, GetCell(Target->GetActorLocation()));
+	if (Visibility && !Visibility->IsPotentiallyVisible(ViewPos, Target->GetActorLocation()))
+	{
+		SpatialScore *= OccludedScale;
+	}
+	return FMath::Max(SpatialScore, GetCombatScore(Target, ViewTarget));
+}
+
+float UUnrealTestNetPrioritizerSubsystem::GetSpatialScore(const FIntVector& ViewCell, const FVector& ViewDir, const FIntVector& TargetCell)
+{
+	if (SpatialScoreCacheFrame != GFrameCounter)
+	{
+		SpatialScoreCacheFrame = GFrameCounter;
+		SpatialScoreCache.Reset();
+	}
+
+	// 10 bits per cell coordinate and 4 bits of view yaw fit the whole key in 64 bits
+	const int32 YawBucket = FMath::FloorToInt((FMath::Atan2(ViewDir.Y, ViewDir.X) + PI) / (2.f * PI) * VIEW_YAW_BUCKETS) % VIEW_YAW_BUCKETS;
+	auto Pack = [](int32 Value) { return uint64(Value & 0x3FF); };
+	const uint64 Key = Pack(ViewCell.X) | Pack(ViewCell.Y) << 10 | Pack(ViewCell.Z) << 20
+		| Pack(TargetCell.X) << 30 | Pack(TargetCell.Y) << 40 | Pack(TargetCell.Z) << 50
+		| uint64(YawBucket) << 60;
+
+	if (const float* CachedScore = SpatialScoreCache.Find(Key))
+	{
+		return *CachedScore;
+	}
+
+	// Evaluate between cell centers along the bucket direction, so every viewer sharing the key gets the same answer
+	const FVector ViewCenter = (FVector(ViewCell) + 0.5f) * CellSize;
+	const FVector TargetCenter = (FVector(TargetCell) + 0.5f) * CellSize;
+	const FVector ToTarget = TargetCenter - ViewCenter;
+	const float Distance = ToTarget.Size();
+
+	const float BucketYaw = (YawBucket + 0.5f) / VIEW_YAW_BUCKETS * 2.f * PI - PI;
+	const FVector BucketDir(FMath::Cos(BucketYaw), FMath::Sin(BucketYaw), 0.f);
+
+	const float DistanceScore = 1.f - FMath::Clamp(Distance / MaxRelevantDistance, 0.f, 1.f);
+	const bool bSameCell = Distance < KINDA_SMALL_NUMBER;
+	const bool bInView = bSameCell || FVector::DotProduct(BucketDir, ToTarget.GetSafeNormal2D()) >= ViewConeCosine;
+	const float Score = DistanceScore * (bInView ? 1.f : OutOfViewScale);
+
+	SpatialScoreCache.Add(Key, Score);
+	return Score;
+}
+
+float UUnrealTestNetPrioritizerSubsystem::GetCombatScore(const AActor* Target, const AActor* ViewTarget) const
+{
+	if (ViewTarget == nullptr || LastCombatTimes.Num() == 0)
+	{
+		return 0.f;
+	}
+
+	const FObjectKey TargetKey(Target);
+	const FObjectKey ViewTargetKey(ViewTarget);
+	const TPair<FObjectKey, FObjectKey> Pair = TargetKey < ViewTargetKey ? MakeTuple(TargetKey, ViewTargetKey) : MakeTuple(ViewTargetKey, TargetKey);
+
+	const float* LastCombatTime = LastCombatTimes.Find(Pair);
+	if (LastCombatTime == nullptr)
+	{
+		return 0.f;
+	}
+
+	const float Elapsed = GetWorld()->GetTimeSeconds() - *LastCombatTime;
+	return 1.f - FMath::Clamp(Elapsed / CombatMemorySeconds, 0.f, 1.f);
+}
+
+void UUnrealTestNetPrioritizerSubsystem::NotifyCombat(const AActor* Attacker, const AActor* Victim)
+{
+	if (Attacker == nullptr || Victim == nullptr || Attacker == Victim)
+	{
+		return;
+	}
+
+	const FObjectKey AttackerKey(Attacker);
+	const FObjectKey VictimKey(Victim);
+	const TPair<FObjectKey, FObjectKey> Pair = AttackerKey < VictimKey ? MakeTuple(AttackerKey, VictimKey) : MakeTuple(VictimKey, AttackerKey);
+	LastCombatTimes.Add(Pair, GetWorld()->GetTimeSeconds());
+}
+
+void UUnrealTestNetPrioritizerSubsystem::UpdateNetUpdateFrequencies()
+{
+	struct FViewer
+	{
+		FVector Location;
+		FVector Direction;
+		const AActor* ViewTarget;
+	};
+
+	TArray<FViewer, FUnrealTestFrameAllocator> Viewers;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr)
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		Viewers.Add({ ViewLocation, ViewRotation.Vector(), PlayerController->GetViewTarget() });
+	}
+
+	// Exact distance and view cone terms for every character at once, one batch per viewer
+	Characters.RemoveAllSwap([](const TWeakObjectPtr<AUnrealTestCharacter>& Character) { return !Character.IsValid(); });
+	const int32 NumCharacters = Characters.Num();
+	TArray<float, FUnrealTestFrameAllocator> PositionsX;
+	TArray<float, FUnrealTestFrameAllocator> PositionsY;
+	TArray<float, FUnrealTestFrameAllocator> PositionsZ;
+	TArray<float, FUnrealTestFrameAllocator> ViewerScores;
+	TArray<float, FUnrealTestFrameAllocator> BestScores;
+	TArray<int32, FUnrealTestFrameAllocator> VisibilityCells;
+	PositionsX.SetNumUninitialized(NumCharacters);
+	PositionsY.SetNumUninitialized(NumCharacters);
+	PositionsZ.SetNumUninitialized(NumCharacters);
+	ViewerScores.SetNumUninitialized(NumCharacters);
+	BestScores.SetNumZeroed(NumCharacters);
+	VisibilityCells.SetNumUninitialized(NumCharacters);
+	const FUnrealTestVisibilityGrid* VisibilityGrid = Visibility && Visibility->GetGrid().IsLoaded() ? &Visibility->GetGrid() : nullptr;
+	for (int32 Index = 0; Index < NumCharacters; ++Index)
+	{
+		const FVector Location = Characters[Index]->GetActorLocation();
+		PositionsX[Index] = float(Location.X);
+		PositionsY[Index] = float(Location.Y);
+		PositionsZ[Index] = float(Location.Z);
+		VisibilityCells[Index] = VisibilityGrid ? VisibilityGrid->GetCell(Location) : INDEX_NONE;
+	}
+
+	for (const FViewer& Viewer : Viewers)
+	{
+		FUnrealTestBatchMath::DistanceFalloff(PositionsX, PositionsY, PositionsZ, Viewer.Location, MaxRelevantDistance, ViewerScores);
+		FUnrealTestBatchMath::ScaleOutsideCone2D(PositionsX, PositionsY, Viewer.Location, Viewer.Direction.GetSafeNormal2D(), ViewConeCosine, OutOfViewScale, ViewerScores);
+
+		const int32 ViewerCell = VisibilityGrid ? VisibilityGrid->GetCell(Viewer.Location) : INDEX_NONE;
+		if (ViewerCell != INDEX_NONE)
+		{
+			for (int32 Index = 0; Index < NumCharacters; ++Index)
+			{
+				if (VisibilityCells[Index] != INDEX_NONE && !VisibilityGrid->IsCellVisible(ViewerCell, VisibilityCells[Index]))
+				{
+					ViewerScores[Index] *= OccludedScale;
+				}
+			}
+		}
+		FUnrealTestBatchMath::Max(BestScores, ViewerScores);
+	}
+
+	// A character only needs to replicate as often as its most interested viewer wants
+	for (int32 Index = 0; Index < NumCharacters; ++Index)
+	{
+		AUnrealTestCharacter* Character = Characters[Index].Get();
+
+		float BestScore = BestScores[Index];
+		for (const FViewer& Viewer : Viewers)
+		{
+			BestScore = Character == Viewer.ViewTarget ? 1.f : FMath::Max(BestScore, GetCombatScore(Character, Viewer.ViewTarget));
+			if (BestScore >= 1.f)
+			{
+				break;
+			}
+		}
+
+		Character->NetUpdateFrequency = FMath::Lerp(MinNetUpdateFrequency, MaxNetUpdateFrequency, BestScore);
+	}
+
+	// Forget fights nobody remembers anymore
+	const float OldestCombatTime = GetWorld()->GetTimeSeconds() - CombatMemorySeconds;
+	for (auto It = LastCombatTimes.CreateIterator(); It; ++It)
+	{
+		if (It->Value < OldestCombatTime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Player/UnrealTestClockFilter.h"
+
+void FUnrealTestClockFilter::AddSample(float RoundTripSeconds, double Offset)
+{
+	SampleHead = (SampleHead + 1) % SAMPLE_WINDOW;
+	Samples[SampleHead].RoundTripSeconds = RoundTripSeconds;
+	Samples[SampleHead].Offset = Offset;
+
+	// Queuing only ever adds delay, so the fastest round trip in the window has the most trustworthy offset
+	const FSample* Best = nullptr;
+	for (const FSample& Sample : Samples)
+	{
+		if (Sample.RoundTripSeconds > 0.f && (Best == nullptr || Sample.RoundTripSeconds < Best->RoundTripSeconds))
+		{
+			Best = &Sample;
+		}
+	}
+
+	if (Best == nullptr)
+	{
+		return;
+	}
+
+	TargetOffset = Best->Offset;
+	SmoothedRoundTripSeconds = bSynchronized ? FMath::Lerp(SmoothedRoundTripSeconds, RoundTripSeconds, ROUND_TRIP_SMOOTHING) : RoundTripSeconds;
+
+	if (!bSynchronized)
+	{
+		bSynchronized = true;
+		AppliedOffset = TargetOffset;
+	}
+}
+
+void FUnrealTestClockFilter::Advance(float DeltaSeconds, float MaxSlewRate, float StepThresholdSeconds)
+{
+	if (!bSynchronized)
+	{
+		return;
+	}
+
+	// Slew towards the filtered offset, large errors (e.g. after a hitch on the server) are stepped
+	const double Error = TargetOffset - AppliedOffset;
+	if (FMath::Abs(Error) > StepThresholdSeconds)
+	{
+		AppliedOffset = TargetOffset;
+	}
+	else
+	{
+		const double MaxCorrection = MaxSlewRate * DeltaSeconds;
+		AppliedOffset += FMath::Clamp(Error, -MaxCorrection, MaxCorrection);
+	}
+}
+
+void FUnrealTestClockFilter::Reset()
+{
+	*this = FUnrealTestClockFilter();
+}
@@ -0,0 +1,204 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Player/UnrealTestClockSyncComponent.h"
+#include "UnrealTest/UnrealTestStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Clock Sync Round Trip (ms)"), STAT_UnrealTest_ClockSyncRoundTrip, STATGROUP_UnrealTest);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Clock Sync Offset Error (ms)"), STAT_UnrealTest_ClockSyncOffsetError, STATGROUP_UnrealTest);
+
+UUnrealTestClockSyncComponent::UUnrealTestClockSyncComponent()
+{
+	// Moves are stamped while the movement component ticks, look at them afterwards
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+	SetIsReplicatedByDefault(true);
+
+	SampleInterval = SAMPLE_INTERVAL;
+	MaxSlewRate = MAX_SLEW_RATE;
+	StepThresholdSeconds = STEP_THRESHOLD_SECONDS;
+
+	TimeUntilNextSample = 0.f;
+	LastReceivedTimeStamp = -1.f;
+	SentTimeStampHead = INDEX_NONE;
+	LastSentTimeStamp = -1.f;
+	LastServerTime = 0.0;
+}
+
+void UUnrealTestClockSyncComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(UUnrealTestClockSyncComponent, ServerEcho, COND_OwnerOnly);
+}
+
+UCharacterMovementComponent* UUnrealTestClockSyncComponent::GetCharacterMovement() const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	const ACharacter* Character = PlayerController ? PlayerController->GetCharacter() : nullptr;
+	return Character ? Character->GetCharacterMovement() : nullptr;
+}
+
+bool UUnrealTestClockSyncComponent::IsLocalClient() const
+{
+	return GetOwnerRole() == ROLE_AutonomousProxy;
+}
+
+void UUnrealTestClockSyncComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		TimeUntilNextSample -= DeltaTime;
+		if (TimeUntilNextSample <= 0.f)
+		{
+			TimeUntilNextSample = SampleInterval;
+			TickServer();
+		}
+	}
+	else if (IsLocalClient())
+	{
+		TickClient(DeltaTime);
+	}
+}
+
+void UUnrealTestClockSyncComponent::TickServer()
+{
+	// Only remote players send moves, the host's own controller shares the server clock
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	UCharacterMovementComponent* CharacterMovement = GetCharacterMovement();
+	if (PlayerController == nullptr || PlayerController->IsLocalController() || CharacterMovement == nullptr || !CharacterMovement->HasPredictionData_Server())
+	{
+		return;
+	}
+
+	// Moves are received at the start of the frame, so this frame's time is when the latest one came in
+	const float ReceivedTimeStamp = CharacterMovement->GetPredictionData_Server_Character()->CurrentClientTimeStamp;
+	if (ReceivedTimeStamp != LastReceivedTimeStamp)
+	{
+		LastReceivedTimeStamp = ReceivedTimeStamp;
+		ServerEcho.ClientTimeStamp = ReceivedTimeStamp;
+		ServerEcho.ServerTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void UUnrealTestClockSyncComponent::TickClient(float DeltaTime)
+{
+	RecordSentMoves();
+	AdvanceClock(DeltaTime);
+}
+
+void UUnrealTestClockSyncComponent::RecordSentMoves()
+{
+	const UCharacterMovementComponent* CharacterMovement = GetCharacterMovement();
+	const FNetworkPredictionData_Client_Character* ClientData = CharacterMovement ? CharacterMovement->GetPredictionData_Client_Character() : nullptr;
+	if (ClientData == nullptr)
+	{
+		return;
+	}
+
+	// Timestamps start over now and then
+	if (ClientData->CurrentTimeStamp < LastSentTimeStamp)
+	{
+		LastSentTimeStamp = -1.f;
+	}
+
+	// Saved moves wait for their ack, the pending one is held back to be combined with a later move
+	// or sent along with it: it leaves in a later frame, and is recorded then
+	const float PendingTimeStamp = ClientData->PendingMove.IsValid() ? ClientData->PendingMove->TimeStamp : -1.f;
+	const double Now = FPlatformTime::Seconds();
+	for (const FSavedMovePtr& Move : ClientData->SavedMoves)
+	{
+		if (Move.IsValid() && Move->TimeStamp > LastSentTimeStamp && Move->TimeStamp != PendingTimeStamp)
+		{
+			RecordSentMove(Move->TimeStamp, Now);
+		}
+	}
+}
+
+void UUnrealTestClockSyncComponent::RecordSentMove(float TimeStamp, double PlatformTime)
+{
+	if (SentTimeStamps.Num() == 0)
+	{
+		SentTimeStamps.SetNum(SENT_TIMESTAMP_CAPACITY);
+	}
+
+	SentTimeStampHead = (SentTimeStampHead + 1) % SentTimeStamps.Num();
+	SentTimeStamps[SentTimeStampHead].TimeStamp = TimeStamp;
+	SentTimeStamps[SentTimeStampHead].PlatformTime = PlatformTime;
+	LastSentTimeStamp = FMath::Max(LastSentTimeStamp, TimeStamp);
+}
+
+void UUnrealTestClockSyncComponent::AdvanceClock(float DeltaTime)
+{
+	Filter.Advance(DeltaTime, MaxSlewRate, StepThresholdSeconds);
+}
+
+void UUnrealTestClockSyncComponent::OnRep_ServerEcho()
+{
+	ReceiveEcho(ServerEcho, FPlatformTime::Seconds());
+}
+
+void UUnrealTestClockSyncComponent::ReceiveEcho(const FUnrealTestClockSyncEcho& Echo, double ReceivedPlatformTime)
+{
+	if (SentTimeStampHead == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Find when the echoed move left, recent moves first. Timestamps reset now and then, old entries just stop matching
+	for (int32 Age = 0; Age < SentTimeStamps.Num(); ++Age)
+	{
+		const FSentTimeStamp& Sent = SentTimeStamps[(SentTimeStampHead - Age + SentTimeStamps.Num()) % SentTimeStamps.Num()];
+		if (Sent.TimeStamp == Echo.ClientTimeStamp && Sent.PlatformTime > 0.0)
+		{
+			const float RoundTripSeconds = ReceivedPlatformTime - Sent.PlatformTime;
+
+			// The server time sits halfway through the round trip
+			const double Offset = Echo.ServerTime - (Sent.PlatformTime + ReceivedPlatformTime) * 0.5;
+			Filter.AddSample(RoundTripSeconds, Offset);
+
+			SET_FLOAT_STAT(STAT_UnrealTest_ClockSyncRoundTrip, Filter.GetRoundTripSeconds() * 1000.f);
+			SET_FLOAT_STAT(STAT_UnrealTest_ClockSyncOffsetError, (Filter.GetTargetOffset() - Filter.GetAppliedOffset()) * 1000.0);
+			return;
+		}
+	}
+}
+
+double UUnrealTestClockSyncComponent::GetServerTime() const
+{
+	const double ServerTime = PlatformTimeToServerTime(FPlatformTime::Seconds());
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		return ServerTime;
+	}
+
+	// Slewing never runs the clock backwards, but a stepped offset can
+	LastServerTime = FMath::Max(ServerTime, LastServerTime);
+	return LastServerTime;
+}
+
+double UUnrealTestClockSyncComponent::PlatformTimeToServerTime(double PlatformTime) const
+{
+	const UWorld* World = GetWorld();
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		return World->GetTimeSeconds() - (FPlatformTime::Seconds() - PlatformTime);
+	}
+
+	if (!Filter.IsSynchronized())
+	{
+		// Until the first sample arrives the replicated game state time is the best guess
+		const AGameStateBase* GameState = World->GetGameState();
+		const double ServerTimeNow = GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+		return ServerTimeNow - (FPlatformTime::Seconds() - PlatformTime);
+	}
+
+	return PlatformTime + Filter.GetAppliedOffset();
+}
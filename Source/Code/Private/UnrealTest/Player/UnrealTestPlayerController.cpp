@@ -0,0 +1,143 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Player/UnrealTestPlayerController.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Input/UnrealTestMouseAimInputProcessor.h"
+#include "UnrealTest/Input/UnrealTestTouchInputProcessor.h"
+#include "UnrealTest/Player/UnrealTestClockSyncComponent.h"
+#include "Framework/Application/SlateApplication.h"
+#include "GameFramework/InputSettings.h"
+
+AUnrealTestPlayerController::AUnrealTestPlayerController()
+{
+	ClockSync = CreateDefaultSubobject<UUnrealTestClockSyncComponent>(TEXT("ClockSync"));
+
+#if !UE_SERVER
+	ClickAimRotation = FRotator::ZeroRotator;
+	ClickPlatformTime = 0.0;
+	bHasClickAimRotation = false;
+#endif
+}
+
+void AUnrealTestPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+#if !UE_SERVER
+	// Raw mouse events only exist where the local player sits
+	if (IsLocalController() && FSlateApplication::IsInitialized())
+	{
+		MouseAimProcessor = MakeShared<FUnrealTestMouseAimInputProcessor>();
+		FSlateApplication::Get().RegisterInputPreProcessor(MouseAimProcessor);
+
+		if (FPlatformMisc::SupportsTouchInput() || GetDefault<UInputSettings>()->bUseMouseForTouch)
+		{
+			TouchProcessor = MakeShared<FUnrealTestTouchInputProcessor>(TouchInputSettings);
+			FSlateApplication::Get().RegisterInputPreProcessor(TouchProcessor);
+		}
+	}
+#endif
+}
+
+void AUnrealTestPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+#if !UE_SERVER
+	if (MouseAimProcessor.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(MouseAimProcessor);
+	}
+	MouseAimProcessor.Reset();
+
+	if (TouchProcessor.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(TouchProcessor);
+	}
+	TouchProcessor.Reset();
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AUnrealTestPlayerController::ProcessPlayerInput(const float DeltaTime, const bool bGamePaused)
+{
+	Super::ProcessPlayerInput(DeltaTime, bGamePaused);
+
+#if !UE_SERVER
+	// Every device's input goes in after the bindings ran and before the rotation gets updated
+	AUnrealTestCharacter* UnrealTestCharacter = GetPawn<AUnrealTestCharacter>();
+	FUnrealTestInputCommandFrame Command;
+	if (UnrealTestCharacter != nullptr)
+	{
+		Command = UnrealTestCharacter->ConsumeInputCommand(DeltaTime);
+	}
+
+	if (TouchProcessor.IsValid())
+	{
+		// The touches of this frame were classified on a worker while the frame started
+		Command.Merge(TouchProcessor->ConsumeCommand());
+
+		int32 ViewportSizeX = 0;
+		int32 ViewportSizeY = 0;
+		GetViewportSize(ViewportSizeX, ViewportSizeY);
+		TouchProcessor->SetViewportSize(FVector2D(ViewportSizeX, ViewportSizeY));
+	}
+
+	if (UnrealTestCharacter != nullptr)
+	{
+		UnrealTestCharacter->ApplyInputCommand(Command);
+	}
+#endif
+}
+
+void AUnrealTestPlayerController::PlayerTick(float DeltaTime)
+{
+#if !UE_SERVER
+	const FRotator FrameStartRotation = GetControlRotation();
+#endif
+
+	Super::PlayerTick(DeltaTime);
+
+#if !UE_SERVER
+	UpdateClickAimRotation(FrameStartRotation);
+#endif
+}
+
+#if !UE_SERVER
+void AUnrealTestPlayerController::UpdateClickAimRotation(const FRotator& FrameStartRotation)
+{
+	bHasClickAimRotation = MouseAimProcessor.IsValid() && MouseAimProcessor->HasClick();
+	if (bHasClickAimRotation)
+	{
+		// Mouse input maps linearly to rotation, so the part of the frame's raw motion received before
+		// the click is the part of the frame's rotation that happened before it
+		const FVector2D& FrameDelta = MouseAimProcessor->GetFrameDelta();
+		const FVector2D& DeltaBeforeClick = MouseAimProcessor->GetDeltaBeforeClick();
+		const float YawAlpha = FMath::Abs(FrameDelta.X) > KINDA_SMALL_NUMBER ? FMath::Clamp(DeltaBeforeClick.X / FrameDelta.X, 0.f, 1.f) : 1.f;
+		const float PitchAlpha = FMath::Abs(FrameDelta.Y) > KINDA_SMALL_NUMBER ? FMath::Clamp(DeltaBeforeClick.Y / FrameDelta.Y, 0.f, 1.f) : 1.f;
+
+		const FRotator FrameRotation = (GetControlRotation() - FrameStartRotation).GetNormalized();
+		ClickAimRotation = FrameStartRotation + FRotator(FrameRotation.Pitch * PitchAlpha, FrameRotation.Yaw * YawAlpha, 0.f);
+		ClickPlatformTime = MouseAimProcessor->GetClickTimestamp();
+	}
+
+	if (MouseAimProcessor.IsValid())
+	{
+		MouseAimProcessor->BeginFrame();
+	}
+}
+
+bool AUnrealTestPlayerController::GetClickAim(FRotator& OutRotation, double& OutPlatformTime) const
+{
+	if (bHasClickAimRotation)
+	{
+		OutRotation = ClickAimRotation;
+		OutPlatformTime = ClickPlatformTime;
+	}
+	return bHasClickAimRotation;
+}
+#endif
+
+double AUnrealTestPlayerController::PlatformTimeToServerTime(double PlatformTime) const
+{
+	return ClockSync->PlatformTimeToServerTime(PlatformTime);
+}
@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestAliveTracker.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestAliveTrackerTests
+{
+	/** Stand-ins for the controllers, the tracker only keys on their identity */
+	TArray<UObject*> MakePlayers(int32 NumPlayers)
+	{
+		TArray<UObject*> Players;
+		for (int32 Index = 0; Index < NumPlayers; ++Index)
+		{
+			Players.Add(NewObject<UObject>(GetTransientPackage()));
+		}
+		return Players;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestAliveTrackerDoubleDeathTest, "UnrealTest.Match.AliveTracker.DoubleDeath",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestAliveTrackerDoubleDeathTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestAliveTrackerTests;
+	const TArray<UObject*> Players = MakePlayers(3);
+
+	FUnrealTestAliveTracker Tracker;
+	Tracker.MarkAlive(Players[0], 0);
+	Tracker.MarkAlive(Players[1], 0);
+	Tracker.MarkAlive(Players[2], 1);
+
+	// Dying and disconnecting in the same frame both report the player
+	TestFalse(TEXT("Losing one of two players doesn't eliminate the team"), Tracker.MarkDead(Players[0]));
+	TestFalse(TEXT("The second report of the same player is ignored"), Tracker.MarkDead(Players[0]));
+	TestFalse(TEXT("The dead player is no longer alive"), Tracker.IsAlive(Players[0]));
+	TestEqual(TEXT("The team counted the player once"), Tracker.GetAliveCount(0), 1);
+	TestEqual(TEXT("Both teams are still standing"), Tracker.GetNumAliveTeams(), 2);
+
+	TestTrue(TEXT("Losing the last player eliminates the team"), Tracker.MarkDead(Players[1]));
+	TestFalse(TEXT("A team is only eliminated once"), Tracker.MarkDead(Players[1]));
+	TestEqual(TEXT("The eliminated team has nobody alive"), Tracker.GetAliveCount(0), 0);
+	TestEqual(TEXT("The other team is the last standing"), Tracker.GetLastTeamStanding(), 1);
+
+	TestFalse(TEXT("Players never marked alive can't eliminate anything"), Tracker.MarkDead(MakePlayers(1)[0]));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestAliveTrackerTeamChangeTest, "UnrealTest.Match.AliveTracker.TeamChange",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestAliveTrackerTeamChangeTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestAliveTrackerTests;
+	const TArray<UObject*> Players = MakePlayers(2);
+
+	FUnrealTestAliveTracker Tracker;
+	Tracker.MarkAlive(Players[0], 0);
+	Tracker.MarkAlive(Players[1], 1);
+
+	Tracker.MarkAlive(Players[0], 0);
+	TestEqual(TEXT("Marking a player alive twice in the same team counts it once"), Tracker.GetAliveCount(0), 1);
+
+	// Rebalancing moves a living player to the other team
+	Tracker.MarkAlive(Players[0], 1);
+	TestEqual(TEXT("The player left its old team"), Tracker.GetAliveCount(0), 0);
+	TestEqual(TEXT("The player joined its new team"), Tracker.GetAliveCount(1), 2);
+	TestEqual(TEXT("The emptied team is no longer standing"), Tracker.GetNumAliveTeams(), 1);
+	TestEqual(TEXT("The new team is the last standing"), Tracker.GetLastTeamStanding(), 1);
+
+	TestFalse(TEXT("The moved player dies in its new team only"), Tracker.MarkDead(Players[0]));
+	TestEqual(TEXT("The new team lost the player"), Tracker.GetAliveCount(1), 1);
+	TestEqual(TEXT("The old team didn't go negative"), Tracker.GetAliveCount(0), 0);
+
+	// Team ids the mask can't hold take the player out instead
+	Tracker.MarkAlive(Players[1], FUnrealTestAliveTracker::MAX_TEAMS);
+	TestFalse(TEXT("Moving to an untracked team stops counting the player"), Tracker.IsAlive(Players[1]));
+	TestEqual(TEXT("No team is left standing"), Tracker.GetNumAliveTeams(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestAliveTrackerSameFrameTest, "UnrealTest.Match.AliveTracker.SameFrameElimination",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestAliveTrackerSameFrameTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestAliveTrackerTests;
+	const TArray<UObject*> Players = MakePlayers(3);
+
+	FUnrealTestAliveTracker Tracker;
+	Tracker.MarkAlive(Players[0], 0);
+	Tracker.MarkAlive(Players[1], 1);
+	Tracker.MarkAlive(Players[2], 2);
+
+	TestTrue(TEXT("The first team is eliminated"), Tracker.MarkDead(Players[0]));
+	TestEqual(TEXT("Two teams are left"), Tracker.GetNumAliveTeams(), 2);
+	TestEqual(TEXT("Two teams left have no last one standing"), Tracker.GetLastTeamStanding(), int32(INDEX_NONE));
+
+	// The game mode only checks for a winner at the end of the frame, after both of these
+	TestTrue(TEXT("The second team is eliminated"), Tracker.MarkDead(Players[1]));
+	TestTrue(TEXT("The third team is eliminated in the same frame"), Tracker.MarkDead(Players[2]));
+	TestEqual(TEXT("Nobody is left"), Tracker.GetNumAliveTeams(), 0);
+	TestEqual(TEXT("The last two teams dying together leave no winner"), Tracker.GetLastTeamStanding(), int32(INDEX_NONE));
+
+	Tracker.Reset();
+	Tracker.MarkAlive(Players[2], 2);
+	TestEqual(TEXT("The tracker counts again after a reset"), Tracker.GetLastTeamStanding(), 2);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Player/UnrealTestClockFilter.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestClockFilterTests
+{
+	// Same as the clock sync component defaults
+	constexpr float SAMPLE_INTERVAL = 0.1f;
+	constexpr float MAX_SLEW_RATE = 0.05f;
+	constexpr float STEP_THRESHOLD_SECONDS = 0.25f;
+
+	constexpr float FRAME_SECONDS = 1.f / 60.f;
+
+	/** Server clock ahead of the client one, far enough that float time would lose precision */
+	constexpr double SERVER_OFFSET = 100000.0;
+
+	/** One way delay of a sample, in seconds */
+	using FDelayFunction = TFunction<float(int32 /* SampleIndex */)>;
+
+	/** Offset error of the filter every frame, applied offset minus the true one */
+	struct FSimulation
+	{
+		TArray<double> Errors;
+		TArray<double> AppliedOffsets;
+	};
+
+	/**
+	 * Runs a client for the given time, sending a sample every SAMPLE_INTERVAL that reaches the server after
+	 * UpDelay and comes back after DownDelay, and advancing the filter every frame as the component does
+	 */
+	FSimulation Simulate(FUnrealTestClockFilter& Filter, float Seconds, const FDelayFunction& UpDelay, const FDelayFunction& DownDelay,
+		TFunctionRef<double(double /* ClientTime */)> TrueOffset = [](double) { return SERVER_OFFSET; })
+	{
+		struct FInFlight
+		{
+			double SentAt;
+			double ReceivedAt;
+			double ServerTime;
+		};
+		TArray<FInFlight> InFlight;
+
+		FSimulation Simulation;
+		int32 SampleIndex = 0;
+		double NextSampleTime = 0.0;
+		const int32 NumFrames = FMath::RoundToInt(Seconds / FRAME_SECONDS);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double Now = Frame * FRAME_SECONDS;
+			if (Now >= NextSampleTime)
+			{
+				NextSampleTime += SAMPLE_INTERVAL;
+				const float Up = UpDelay(SampleIndex);
+				const float Down = DownDelay(SampleIndex);
+				++SampleIndex;
+
+				const double ServerReceivedAt = Now + Up;
+				InFlight.Add({ Now, ServerReceivedAt + Down, ServerReceivedAt + TrueOffset(ServerReceivedAt) });
+			}
+
+			for (int32 Index = 0; Index < InFlight.Num(); ++Index)
+			{
+				if (InFlight[Index].ReceivedAt <= Now)
+				{
+					// Same estimate as the clock sync component: the server time sits halfway through the round trip
+					const FInFlight& Sample = InFlight[Index];
+					Filter.AddSample(Sample.ReceivedAt - Sample.SentAt, Sample.ServerTime - (Sample.SentAt + Sample.ReceivedAt) * 0.5);
+					InFlight.RemoveAt(Index--);
+				}
+			}
+
+			Filter.Advance(FRAME_SECONDS, MAX_SLEW_RATE, STEP_THRESHOLD_SECONDS);
+			Simulation.Errors.Add(Filter.IsSynchronized() ? Filter.GetAppliedOffset() - TrueOffset(Now) : 0.0);
+			Simulation.AppliedOffsets.Add(Filter.GetAppliedOffset());
+		}
+		return Simulation;
+	}
+
+	/** Largest error from the given time on */
+	double GetMaxError(const FSimulation& Simulation, float FromSeconds)
+	{
+		double MaxError = 0.0;
+		for (int32 Frame = FMath::RoundToInt(FromSeconds / FRAME_SECONDS); Frame < Simulation.Errors.Num(); ++Frame)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Simulation.Errors[Frame]));
+		}
+		return MaxError;
+	}
+
+	double GetMeanError(const FSimulation& Simulation, float FromSeconds)
+	{
+		const int32 FirstFrame = FMath::RoundToInt(FromSeconds / FRAME_SECONDS);
+		double TotalError = 0.0;
+		for (int32 Frame = FirstFrame; Frame < Simulation.Errors.Num(); ++Frame)
+		{
+			TotalError += FMath::Abs(Simulation.Errors[Frame]);
+		}
+		return TotalError / FMath::Max(Simulation.Errors.Num() - FirstFrame, 1);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestClockFilterJitterTest, "UnrealTest.ClockSync.Filter.Jitter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestClockFilterJitterTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestClockFilterTests;
+
+	// 30 ms each way plus up to 40 ms of jitter on each leg, so a single sample can be 20 ms off
+	constexpr float BaseDelay = 0.03f;
+	constexpr float MaxJitter = 0.04f;
+	FRandomStream Random(34);
+	const FDelayFunction JitteredDelay = [&Random](int32) { return BaseDelay + Random.FRandRange(0.f, MaxJitter); };
+
+	FUnrealTestClockFilter Filter;
+	const FSimulation Simulation = Simulate(Filter, 10.f, JitteredDelay, JitteredDelay);
+
+	TestTrue(TEXT("The first sample synchronizes the clock"), Filter.IsSynchronized());
+	TestTrue(TEXT("The offset stays within half the jitter once the window is full"), GetMaxError(Simulation, 3.f) <= MaxJitter * 0.5f);
+	TestTrue(FString::Printf(TEXT("The fastest samples keep the offset %.1f ms off on average, within a quarter of the jitter"), GetMeanError(Simulation, 3.f) * 1000.0),
+		GetMeanError(Simulation, 3.f) <= MaxJitter * 0.25f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestClockFilterAsymmetryTest, "UnrealTest.ClockSync.Filter.AsymmetricDelay",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestClockFilterAsymmetryTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestClockFilterTests;
+
+	// A round trip can't tell the legs apart: the estimate is off by half their difference, and no more
+	constexpr float UpDelay = 0.05f;
+	constexpr float DownDelay = 0.01f;
+
+	FUnrealTestClockFilter Filter;
+	const FSimulation Simulation = Simulate(Filter, 5.f, [](int32) { return UpDelay; }, [](int32) { return DownDelay; });
+
+	TestEqual(TEXT("The offset settles half the asymmetry away"), Simulation.Errors.Last(), double(UpDelay - DownDelay) * 0.5, 1.e-3);
+	TestEqual(TEXT("The round trip is both legs"), Filter.GetRoundTripSeconds(), UpDelay + DownDelay, 1.e-3f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestClockFilterSpikeTest, "UnrealTest.ClockSync.Filter.Spikes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestClockFilterSpikeTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestClockFilterTests;
+
+	// Every fifth sample is held up for half a second on the way to the server, which alone would put it 250 ms off
+	FRandomStream Random(35);
+	const FDelayFunction SpikyDelay = [&Random](int32 SampleIndex) { return 0.03f + (SampleIndex % 5 == 4 ? 0.5f : Random.FRandRange(0.f, 0.005f)); };
+	const FDelayFunction SteadyDelay = [&Random](int32) { return 0.03f + Random.FRandRange(0.f, 0.005f); };
+
+	FUnrealTestClockFilter Filter;
+	const FSimulation Simulation = Simulate(Filter, 10.f, SpikyDelay, SteadyDelay);
+
+	TestTrue(TEXT("Spikes never move the offset"), GetMaxError(Simulation, 0.5f) <= 0.003);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestClockFilterSlewTest, "UnrealTest.ClockSync.Filter.Slew",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestClockFilterSlewTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestClockFilterTests;
+	const FDelayFunction Delay = [](int32) { return 0.03f; };
+
+	// The server clock jumps 100 ms ahead after 3 s, under the step threshold
+	FUnrealTestClockFilter SlewFilter;
+	const FSimulation Slewed = Simulate(SlewFilter, 10.f, Delay, Delay, [](double Time) { return SERVER_OFFSET + (Time > 3.0 ? 0.1 : 0.0); });
+
+	double LargestCorrection = 0.0;
+	for (int32 Frame = 1; Frame < Slewed.AppliedOffsets.Num(); ++Frame)
+	{
+		LargestCorrection = FMath::Max(LargestCorrection, FMath::Abs(Slewed.AppliedOffsets[Frame] - Slewed.AppliedOffsets[Frame - 1]));
+	}
+	TestTrue(TEXT("Small corrections are slewed at MaxSlewRate"), LargestCorrection <= MAX_SLEW_RATE * FRAME_SECONDS + 1.e-9);
+	TestTrue(TEXT("The slewed offset catches up within the window and the slew time"), GetMaxError(Slewed, 3.f + FUnrealTestClockFilter::SAMPLE_WINDOW * SAMPLE_INTERVAL + 0.1f / MAX_SLEW_RATE + 0.5f) <= 1.e-3);
+
+	// A one second jump is beyond the threshold
+	FUnrealTestClockFilter StepFilter;
+	const FSimulation Stepped = Simulate(StepFilter, 10.f, Delay, Delay, [](double Time) { return SERVER_OFFSET + (Time > 3.0 ? 1.0 : 0.0); });
+	TestTrue(TEXT("Large errors are stepped as soon as the old samples leave the window"),
+		GetMaxError(Stepped, 3.f + FUnrealTestClockFilter::SAMPLE_WINDOW * SAMPLE_INTERVAL + 0.5f) <= 1.e-3);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
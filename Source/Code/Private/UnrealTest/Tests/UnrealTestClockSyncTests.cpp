@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Player/UnrealTestClockSyncComponent.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestClockSyncTests
+{
+	constexpr float FRAME_SECONDS = 1.f / 120.f;
+
+	/** Server clock ahead of the client one, far enough that float time would lose precision */
+	constexpr double SERVER_OFFSET = 100000.0;
+
+	/** One way delay of a packet, in seconds */
+	using FDelayFunction = TFunction<float(int32 /* PacketIndex */)>;
+
+	/**
+	 * Runs a client and a server on the same frame grid for the given time, the client clock SERVER_OFFSET behind.
+	 * Every frame the client stamps a move, which leaves HoldFrames later as a combined or delayed move would,
+	 * and reaches the server after UpDelay. Every SampleInterval the server echoes the newest timestamp it got
+	 * with its frame time, which reaches the client after DownDelay. Packets are handled on the frame they arrive by,
+	 * like the movement RPCs and the echo replication.
+	 * @return error of the synchronized server time every frame, zero until the first sample
+	 */
+	TArray<double> Simulate(UUnrealTestClockSyncComponent* ClockSync, float Seconds, int32 HoldFrames, const FDelayFunction& UpDelay, const FDelayFunction& DownDelay)
+	{
+		struct FPacket
+		{
+			double ArrivesAt;
+			FUnrealTestClockSyncEcho Echo;
+		};
+		TArray<FPacket> ToServer;
+		TArray<FPacket> ToClient;
+
+		FUnrealTestClockSyncEcho Received;
+		bool bReceivedAny = false;
+		const int32 FramesPerSample = FMath::Max(FMath::RoundToInt(ClockSync->SampleInterval / FRAME_SECONDS), 1);
+		int32 NumPackets = 0;
+
+		TArray<double> Errors;
+		const int32 NumFrames = FMath::RoundToInt(Seconds / FRAME_SECONDS);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double Now = Frame * FRAME_SECONDS;
+
+			// The move stamped HoldFrames ago leaves now, and only now is its send time known
+			if (Frame >= HoldFrames)
+			{
+				FPacket& Packet = ToServer.AddDefaulted_GetRef();
+				Packet.Echo.ClientTimeStamp = float((Frame - HoldFrames) * FRAME_SECONDS) + 1.f;
+				Packet.ArrivesAt = Now + UpDelay(NumPackets++);
+				ClockSync->RecordSentMove(Packet.Echo.ClientTimeStamp, Now);
+			}
+
+			// Out of order moves are dropped by the server, it keeps the newest timestamp
+			for (int32 Index = ToServer.Num() - 1; Index >= 0; --Index)
+			{
+				if (ToServer[Index].ArrivesAt <= Now)
+				{
+					if (!bReceivedAny || ToServer[Index].Echo.ClientTimeStamp > Received.ClientTimeStamp)
+					{
+						Received.ClientTimeStamp = ToServer[Index].Echo.ClientTimeStamp;
+						Received.ServerTime = Now + SERVER_OFFSET;
+						bReceivedAny = true;
+					}
+					ToServer.RemoveAtSwap(Index);
+				}
+			}
+
+			if (bReceivedAny && Frame % FramesPerSample == 0)
+			{
+				ToClient.Add({ Now + DownDelay(NumPackets++), Received });
+			}
+
+			for (int32 Index = ToClient.Num() - 1; Index >= 0; --Index)
+			{
+				if (ToClient[Index].ArrivesAt <= Now)
+				{
+					ClockSync->ReceiveEcho(ToClient[Index].Echo, Now);
+					ToClient.RemoveAtSwap(Index);
+				}
+			}
+
+			ClockSync->AdvanceClock(FRAME_SECONDS);
+			Errors.Add(ClockSync->IsSynchronized() ? ClockSync->PlatformTimeToServerTime(Now) - (Now + SERVER_OFFSET) : 0.0);
+		}
+		return Errors;
+	}
+
+	/** Largest error from the given time on */
+	double GetMaxError(const TArray<double>& Errors, float FromSeconds)
+	{
+		double MaxError = 0.0;
+		for (int32 Frame = FMath::RoundToInt(FromSeconds / FRAME_SECONDS); Frame < Errors.Num(); ++Frame)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Errors[Frame]));
+		}
+		return MaxError;
+	}
+
+	UUnrealTestClockSyncComponent* MakeClockSync()
+	{
+		return NewObject<UUnrealTestClockSyncComponent>(GetTransientPackage());
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestClockSyncHeldMovesTest, "UnrealTest.ClockSync.Component.HeldMoves",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestClockSyncHeldMovesTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestClockSyncTests;
+
+	// Moves leave 4 frames after they were stamped: paired with the frame they were stamped in,
+	// the round trip would look 33 ms longer and the offset would be 17 ms off
+	constexpr int32 HoldFrames = 4;
+	constexpr float Delay = 0.035f;
+
+	UUnrealTestClockSyncComponent* ClockSync = MakeClockSync();
+	const TArray<double> Errors = Simulate(ClockSync, 5.f, HoldFrames, [](int32) { return Delay; }, [](int32) { return Delay; });
+
+	TestTrue(TEXT("Echoes synchronize the clock"), ClockSync->IsSynchronized());
+	TestTrue(FString::Printf(TEXT("Samples pair with the time their move left, %.2f ms off"), GetMaxError(Errors, 1.f) * 1000.0),
+		GetMaxError(Errors, 1.f) <= FRAME_SECONDS * 0.5f);
+	TestEqual(TEXT("The round trip is both legs, give or take the frames packets wait for"), ClockSync->GetRoundTripSeconds(), Delay * 2.f, FRAME_SECONDS * 2.f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestClockSyncJitterTest, "UnrealTest.ClockSync.Component.Jitter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestClockSyncJitterTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestClockSyncTests;
+
+	// 40 ms each way plus up to 60 ms of jitter on each leg, enough for moves to arrive out of order
+	constexpr float BaseDelay = 0.04f;
+	constexpr float MaxJitter = 0.06f;
+	FRandomStream Random(36);
+	const FDelayFunction JitteredDelay = [&Random](int32) { return BaseDelay + Random.FRandRange(0.f, MaxJitter); };
+
+	UUnrealTestClockSyncComponent* ClockSync = MakeClockSync();
+	const TArray<double> Errors = Simulate(ClockSync, 10.f, 2, JitteredDelay, JitteredDelay);
+
+	const float SettledSeconds = 3.f;
+	AddInfo(FString::Printf(TEXT("Largest synchronized time error after %.0f s: %.2f ms"), SettledSeconds, GetMaxError(Errors, SettledSeconds) * 1000.0));
+	TestTrue(TEXT("The synchronized time stays within half the jitter once the window is full"), GetMaxError(Errors, SettledSeconds) <= MaxJitter * 0.5f);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
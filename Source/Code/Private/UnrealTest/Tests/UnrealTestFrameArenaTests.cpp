@@ -0,0 +1,206 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Memory/UnrealTestFrameArena.h"
+#include "UnrealTest/Combat/UnrealTestLagCompensationSubsystem.h"
+#include "UnrealTest/Game/UnrealTestSpatialHashSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestFrameArenaTests
+{
+	constexpr uint32 ALIGNMENT = FUnrealTestFrameArena::MIN_ALIGNMENT;
+
+	void FillPattern(void* Ptr, SIZE_T Size)
+	{
+		for (SIZE_T Index = 0; Index < Size; ++Index)
+		{
+			static_cast<uint8*>(Ptr)[Index] = uint8(Index * 7 + 3);
+		}
+	}
+
+	bool HasPattern(const void* Ptr, SIZE_T Size)
+	{
+		for (SIZE_T Index = 0; Index < Size; ++Index)
+		{
+			if (static_cast<const uint8*>(Ptr)[Index] != uint8(Index * 7 + 3))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Frames played before the arena is expected to have grown to the peak load */
+	constexpr int32 WARMUP_FRAMES = 10;
+	constexpr int32 NUM_FRAMES = 120;
+
+	/**
+	 * Runs the queries gameplay serves from the frame arena around every pawn of the running world, once per frame,
+	 * on top of what the world itself does, and counts the arena blocks that still came from the heap after warm up
+	 */
+	class FArenaQueriesCommand : public IAutomationLatentCommand
+	{
+	public:
+		explicit FArenaQueriesCommand(FAutomationTestBase* InTest)
+			: Test(InTest)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			UWorld* World = AutomationCommon::GetAnyGameWorld();
+			const UUnrealTestSpatialHashSubsystem* SpatialHash = World ? World->GetSubsystem<UUnrealTestSpatialHashSubsystem>() : nullptr;
+			const UUnrealTestLagCompensationSubsystem* LagCompensation = World ? World->GetSubsystem<UUnrealTestLagCompensationSubsystem>() : nullptr;
+			if (SpatialHash == nullptr || LagCompensation == nullptr)
+			{
+				Test->AddError(TEXT("The test needs a game world, start it with -game"));
+				return true;
+			}
+
+			// Same shapes as the explosions and melee swings, at a few sizes so the load changes between frames
+			const float Radius = 300.f * (1 + NumFrames % 4);
+			for (int32 Index = 0; Index < SpatialHash->GetNumPawns(); ++Index)
+			{
+				const APawn* Pawn = SpatialHash->GetPawn(Index);
+				if (Pawn == nullptr)
+				{
+					continue;
+				}
+
+				TArray<int32, FUnrealTestFrameAllocator> Victims;
+				Victims.SetNumUninitialized(FMath::Max(SpatialHash->GetNumPawns(), 1));
+				Victims.SetNum(SpatialHash->QueryRadius(Pawn->GetActorLocation(), Radius, Victims), false);
+
+				TArray<FUnrealTestRewoundHitbox, FUnrealTestFrameAllocator> Candidates;
+				LagCompensation->GatherHitboxesRewound(Pawn->GetActorLocation(), Radius, World->GetTimeSeconds() - 0.1, Pawn, Candidates);
+			}
+
+			// The world ticked earlier this frame, so the count covers its queries as well
+			const FUnrealTestFrameArena& Arena = FUnrealTestFrameArena::Get();
+			if (++NumFrames > WARMUP_FRAMES)
+			{
+				HeapAllocations += Arena.GetNumHeapAllocations();
+				Allocations += Arena.GetNumAllocations();
+			}
+
+			if (NumFrames < WARMUP_FRAMES + NUM_FRAMES)
+			{
+				return false;
+			}
+
+			Test->AddInfo(FString::Printf(TEXT("%lld arena allocations over %d frames"), Allocations, NUM_FRAMES));
+			Test->TestTrue(TEXT("Gameplay queries allocated from the arena"), Allocations > 0);
+			Test->TestEqual(TEXT("No arena block comes from the heap once the arena is warm"), HeapAllocations, int64(0));
+			return true;
+		}
+
+	private:
+		FAutomationTestBase* Test;
+		int32 NumFrames = 0;
+		int64 Allocations = 0;
+		int64 HeapAllocations = 0;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestFrameArenaReallocateTest, "UnrealTest.Memory.FrameArena.Reallocate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestFrameArenaReallocateTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestFrameArenaTests;
+	FUnrealTestFrameArena Arena;
+
+	void* Array = Arena.Allocate(64, ALIGNMENT);
+	FillPattern(Array, 64);
+	TestEqual(TEXT("The first allocation takes a block from the heap"), Arena.GetNumHeapAllocations(), 1);
+
+	TestTrue(TEXT("The latest allocation grows in place"), Arena.Reallocate(Array, 64, 256, ALIGNMENT) == Array);
+	TestTrue(TEXT("The latest allocation shrinks in place"), Arena.Reallocate(Array, 256, 128, ALIGNMENT) == Array);
+
+	// Anything allocated after it pins the array where it is
+	void* Other = Arena.Allocate(32, ALIGNMENT);
+	void* Moved = Arena.Reallocate(Array, 64, 512, ALIGNMENT);
+	TestTrue(TEXT("An array that is no longer the latest allocation moves"), Moved != Array);
+	TestTrue(TEXT("A moved array sits after the allocation that pinned it"), UPTRINT(Moved) >= UPTRINT(Other) + 32);
+	TestTrue(TEXT("A moved array keeps its elements"), HasPattern(Moved, 64));
+	TestEqual(TEXT("Moving within the block doesn't reach the heap"), Arena.GetNumHeapAllocations(), 1);
+	TestTrue(TEXT("The moved array is the latest allocation and grows in place again"), Arena.Reallocate(Moved, 64, 1024, ALIGNMENT) == Moved);
+
+	// Even the latest allocation moves once it doesn't fit what is left of the block
+	void* NextBlock = Arena.Reallocate(Moved, 64, FUnrealTestFrameArena::DEFAULT_BLOCK_SIZE, ALIGNMENT);
+	TestTrue(TEXT("Growing past the end of the block moves the array"), NextBlock != Moved);
+	TestTrue(TEXT("An array moved to the next block keeps its elements"), HasPattern(NextBlock, 64));
+	TestEqual(TEXT("The next block comes from the heap"), Arena.GetNumHeapAllocations(), 2);
+	TestEqual(TEXT("The arena chains the blocks"), Arena.GetNumBlocks(), 2);
+
+	TestTrue(TEXT("Allocations are aligned"), IsAligned(Arena.Allocate(3, 64), 64) && IsAligned(Arena.Allocate(5, ALIGNMENT), ALIGNMENT));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestFrameArenaBlockMergeTest, "UnrealTest.Memory.FrameArena.BlockMerge",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestFrameArenaBlockMergeTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestFrameArenaTests;
+	FUnrealTestFrameArena Arena;
+
+	// Two of these never share a default block
+	const SIZE_T LargeSize = FUnrealTestFrameArena::DEFAULT_BLOCK_SIZE * 5 / 8;
+	const auto AllocatePeakFrame = [&Arena, LargeSize](TArray<void*>& OutAllocations)
+	{
+		OutAllocations.Reset();
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			OutAllocations.Add(Arena.Allocate(LargeSize, ALIGNMENT));
+		}
+	};
+
+	TArray<void*> Allocations;
+	AllocatePeakFrame(Allocations);
+	TestEqual(TEXT("A frame outgrowing its block chains new ones"), Arena.GetNumBlocks(), 3);
+	TestEqual(TEXT("Every chained block comes from the heap"), Arena.GetNumHeapAllocations(), 3);
+	const SIZE_T PeakCapacity = Arena.GetCapacity();
+
+	Arena.Reset();
+	TestEqual(TEXT("The reset merges the blocks into one"), Arena.GetNumBlocks(), 1);
+	TestTrue(TEXT("The merged block is as large as the blocks together"), Arena.GetCapacity() == PeakCapacity);
+	TestEqual(TEXT("The reset starts the frame counters over"), Arena.GetNumHeapAllocations(), 0);
+
+	AllocatePeakFrame(Allocations);
+	TestEqual(TEXT("The same load fits the merged block"), Arena.GetNumBlocks(), 1);
+	TestEqual(TEXT("The same load no longer reaches the heap"), Arena.GetNumHeapAllocations(), 0);
+	TestTrue(TEXT("The allocations of the frame are contiguous"), UPTRINT(Allocations.Last()) + LargeSize - UPTRINT(Allocations[0]) <= PeakCapacity);
+
+	// A heavier frame grows the arena again, the next reset merges that too
+	Arena.Allocate(PeakCapacity, ALIGNMENT);
+	TestEqual(TEXT("A heavier frame takes a new block from the heap"), Arena.GetNumHeapAllocations(), 1);
+	const SIZE_T GrownCapacity = Arena.GetCapacity();
+	Arena.Reset();
+	TestEqual(TEXT("The grown arena is merged again"), Arena.GetNumBlocks(), 1);
+	TestTrue(TEXT("The grown arena keeps all its capacity"), Arena.GetCapacity() == GrownCapacity);
+
+	// A frame without a peak is served by the single block, and the reset leaves it alone
+	Arena.Allocate(64, ALIGNMENT);
+	Arena.Reset();
+	TestTrue(TEXT("A single block isn't reallocated by the reset"), Arena.GetCapacity() == GrownCapacity);
+
+	return true;
+}
+
+// Needs a running game world, ideally with bots: UnrealEditor UnrealTest.uproject /Game/ThirdPerson/Maps/ThirdPersonMap -game -ExecCmds="Automation RunTests UnrealTest.Memory.FrameArena.Queries"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestFrameArenaQueriesTest, "UnrealTest.Memory.FrameArena.Queries",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestFrameArenaQueriesTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(UnrealTestFrameArenaTests::FArenaQueriesCommand(this));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
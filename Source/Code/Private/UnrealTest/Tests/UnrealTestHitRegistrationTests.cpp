@@ -0,0 +1,196 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Combat/UnrealTestAttackTypes.h"
+#include "UnrealTest/Player/UnrealTestClockSyncComponent.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestHitRegistrationTests
+{
+	constexpr float FRAME_SECONDS = 1.f / 60.f;
+
+	/** Server clock ahead of the client one, far enough that float time would lose precision */
+	constexpr double SERVER_OFFSET = 100000.0;
+
+	/** Same as the character movement defaults, to put the errors in centimeters */
+	constexpr float RUN_SPEED = 600.f;
+
+	/** Time the shots start at, once the clock sync window is full */
+	constexpr float SETTLED_SECONDS = 3.f;
+
+	/** Click to hit decision errors of every shot, the server rewind target minus the server time of the click */
+	struct FShotErrors
+	{
+		TArray<double> Stamped;
+		TArray<double> HalfRoundTrip;
+
+		static double GetMean(const TArray<double>& Errors)
+		{
+			double Total = 0.0;
+			for (const double Error : Errors)
+			{
+				Total += FMath::Abs(Error);
+			}
+			return Total / FMath::Max(Errors.Num(), 1);
+		}
+
+		static double GetMax(const TArray<double>& Errors)
+		{
+			double MaxError = 0.0;
+			for (const double Error : Errors)
+			{
+				MaxError = FMath::Max(MaxError, FMath::Abs(Error));
+			}
+			return MaxError;
+		}
+	};
+
+	/**
+	 * Plays a client and a server on the same frame grid, the client clock SERVER_OFFSET behind, every packet
+	 * delayed by Delay plus up to Jitter. The client synchronizes its clock through the clock sync component,
+	 * then clicks at a random time every few frames. The click is fired on the next frame with the fire time
+	 * the character sends, and resolved on the frame the server gets it, with the rewind the server uses.
+	 */
+	FShotErrors Simulate(float Seconds, float Delay, float Jitter, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+		UUnrealTestClockSyncComponent* ClockSync = NewObject<UUnrealTestClockSyncComponent>(GetTransientPackage());
+		const int32 FramesPerSample = FMath::Max(FMath::RoundToInt(ClockSync->SampleInterval / FRAME_SECONDS), 1);
+
+		struct FPacket
+		{
+			double ArrivesAt;
+			FUnrealTestClockSyncEcho Echo;
+		};
+		TArray<FPacket> Moves;
+		TArray<FPacket> Echoes;
+		FUnrealTestClockSyncEcho Received;
+		bool bReceivedAny = false;
+
+		struct FShot
+		{
+			double ArrivesAt;
+			double ClickServerTime;
+			FUnrealTestAttackRequest Request;
+		};
+		TArray<FShot> Shots;
+
+		FShotErrors Errors;
+		const int32 NumFrames = FMath::RoundToInt(Seconds / FRAME_SECONDS);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double Now = Frame * FRAME_SECONDS;
+			const double ServerNow = Now + SERVER_OFFSET;
+
+			// Clock sync, a move every frame and an echo every sample interval
+			FPacket& Move = Moves.AddDefaulted_GetRef();
+			Move.ArrivesAt = Now + Delay + Random.FRandRange(0.f, Jitter);
+			Move.Echo.ClientTimeStamp = float(Now) + 1.f;
+			ClockSync->RecordSentMove(Move.Echo.ClientTimeStamp, Now);
+
+			for (int32 Index = Moves.Num() - 1; Index >= 0; --Index)
+			{
+				if (Moves[Index].ArrivesAt <= Now)
+				{
+					if (!bReceivedAny || Moves[Index].Echo.ClientTimeStamp > Received.ClientTimeStamp)
+					{
+						Received.ClientTimeStamp = Moves[Index].Echo.ClientTimeStamp;
+						Received.ServerTime = ServerNow;
+						bReceivedAny = true;
+					}
+					Moves.RemoveAtSwap(Index);
+				}
+			}
+
+			if (bReceivedAny && Frame % FramesPerSample == 0)
+			{
+				Echoes.Add({ Now + Delay + Random.FRandRange(0.f, Jitter), Received });
+			}
+
+			for (int32 Index = Echoes.Num() - 1; Index >= 0; --Index)
+			{
+				if (Echoes[Index].ArrivesAt <= Now)
+				{
+					ClockSync->ReceiveEcho(Echoes[Index].Echo, Now);
+					Echoes.RemoveAtSwap(Index);
+				}
+			}
+
+			ClockSync->AdvanceClock(FRAME_SECONDS);
+
+			// The click was delivered during the last frame, the attack goes out with this one
+			if (Now >= SETTLED_SECONDS && Frame % 7 == 0)
+			{
+				const double ClickPlatformTime = Now - Random.FRandRange(0.f, FRAME_SECONDS);
+
+				FShot& Shot = Shots.AddDefaulted_GetRef();
+				Shot.ArrivesAt = Now + Delay + Random.FRandRange(0.f, Jitter);
+				Shot.ClickServerTime = ClickPlatformTime + SERVER_OFFSET;
+				Shot.Request.ClientFireTime = ClockSync->PlatformTimeToServerTime(ClickPlatformTime);
+			}
+
+			// Resolved on the first server frame after the request arrived, the ping stands in for the round trip
+			const float HalfRoundTripSeconds = ClockSync->GetRoundTripSeconds() * 0.5f;
+			for (int32 Index = Shots.Num() - 1; Index >= 0; --Index)
+			{
+				const FShot& Shot = Shots[Index];
+				if (Shot.ArrivesAt <= Now)
+				{
+					const float RewindSeconds = AUnrealTestCharacter::GetRewindSeconds(Shot.Request, ServerNow, HalfRoundTripSeconds);
+					Errors.Stamped.Add(ServerNow - RewindSeconds - Shot.ClickServerTime);
+
+					const float UnstampedRewindSeconds = AUnrealTestCharacter::GetRewindSeconds(FUnrealTestAttackRequest(), ServerNow, HalfRoundTripSeconds);
+					Errors.HalfRoundTrip.Add(ServerNow - UnstampedRewindSeconds - Shot.ClickServerTime);
+
+					Shots.RemoveAtSwap(Index);
+				}
+			}
+		}
+		return Errors;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestHitRegistrationRewindTest, "UnrealTest.Combat.HitRegistration.Rewind",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestHitRegistrationRewindTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestHitRegistrationTests;
+
+	struct FCondition
+	{
+		const TCHAR* Name;
+		float Delay;
+		float Jitter;
+	};
+	const FCondition Conditions[] =
+	{
+		{ TEXT("LAN"), 0.005f, 0.002f },
+		{ TEXT("Broadband"), 0.04f, 0.01f },
+		{ TEXT("Mobile"), 0.08f, 0.04f },
+	};
+
+	for (const FCondition& Condition : Conditions)
+	{
+		const FShotErrors Errors = Simulate(SETTLED_SECONDS + 10.f, Condition.Delay, Condition.Jitter, 33);
+		const double StampedMean = FShotErrors::GetMean(Errors.Stamped);
+		const double HalfRoundTripMean = FShotErrors::GetMean(Errors.HalfRoundTrip);
+
+		AddInfo(FString::Printf(TEXT("%s, %.0f ms +%.0f ms each way: click to hit decision error %.1f ms mean, %.1f ms max (%.1f cm at run speed), %.1f ms mean rewinding half the round trip"),
+			Condition.Name, Condition.Delay * 1000.f, Condition.Jitter * 1000.f, StampedMean * 1000.0, FShotErrors::GetMax(Errors.Stamped) * 1000.0,
+			FShotErrors::GetMax(Errors.Stamped) * RUN_SPEED, HalfRoundTripMean * 1000.0));
+
+		TestTrue(FString::Printf(TEXT("%s: shots were resolved"), Condition.Name), Errors.Stamped.Num() > 0);
+		TestTrue(FString::Printf(TEXT("%s: the stamped rewind lands within a frame of the click on average"), Condition.Name), StampedMean <= FRAME_SECONDS);
+		TestTrue(FString::Printf(TEXT("%s: the stamped rewind lands within half the jitter and a frame of the click"), Condition.Name),
+			FShotErrors::GetMax(Errors.Stamped) <= Condition.Jitter * 0.5f + FRAME_SECONDS);
+		TestTrue(FString::Printf(TEXT("%s: the stamped rewind beats half the round trip"), Condition.Name), StampedMean < HalfRoundTripMean);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,195 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Input/UnrealTestLookInputProcessor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestLookInputTests
+{
+	constexpr float TURN_RATE = 100.f;
+	constexpr float TOLERANCE = 1.e-4f;
+
+	/** Linear response, so the dead zones and the acceleration can be read straight from the output */
+	FUnrealTestLookInputSettings MakeLinearSettings()
+	{
+		FUnrealTestLookInputSettings Settings;
+		Settings.ResponseExponent = 1.f;
+		return Settings;
+	}
+
+	/** Look rate of the last frame, per second */
+	float ProcessRate(FUnrealTestLookInputProcessor& Processor, const FUnrealTestLookInputSettings& Settings, const FVector2D& Stick, float DeltaSeconds)
+	{
+		return Processor.Process(Settings, Stick, DeltaSeconds, TURN_RATE).X / DeltaSeconds;
+	}
+
+	/**
+	 * Yaw accumulated every sixth of a second over one second of a stick pushed from center to full
+	 * deflection in half a second and then held, sampled at the given frame rate
+	 */
+	TArray<float> SampleTrajectory(const FUnrealTestLookInputSettings& Settings, int32 FrameRate)
+	{
+		FUnrealTestLookInputProcessor Processor;
+		TArray<float> Trajectory;
+		float Yaw = 0.f;
+		for (int32 Frame = 1; Frame <= FrameRate; ++Frame)
+		{
+			const float Time = float(Frame) / FrameRate;
+			Yaw += Processor.Process(Settings, FVector2D(FMath::Min(Time / 0.5f, 1.f), 0.f), 1.f / FrameRate, TURN_RATE).X;
+			if (Frame * 6 % FrameRate == 0)
+			{
+				Trajectory.Add(Yaw);
+			}
+		}
+		return Trajectory;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestLookInputDeadZoneTest, "UnrealTest.Input.LookStick.DeadZones",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestLookInputDeadZoneTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestLookInputTests;
+	const FUnrealTestLookInputSettings Settings = MakeLinearSettings();
+
+	TestEqual(TEXT("A stick inside the inner dead zone reads centered"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.1f, 0.f)), FVector2D::ZeroVector);
+	TestEqual(TEXT("A stick on the inner dead zone reads centered"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(Settings.InnerDeadZone, 0.f)), FVector2D::ZeroVector);
+	TestEqual(TEXT("The dead zone is radial, small diagonals read centered"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.1f, -0.1f)), FVector2D::ZeroVector);
+
+	TestEqual(TEXT("Halfway between the dead zones reads half deflected"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.55f, 0.f)), FVector2D(0.5f, 0.f), TOLERANCE);
+	TestEqual(TEXT("A stick on the outer dead zone reads fully deflected"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.f, Settings.OuterDeadZone)), FVector2D(0.f, 1.f), TOLERANCE);
+	TestEqual(TEXT("A stick past the outer dead zone reads fully deflected"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(-1.f, 0.f)), FVector2D(-1.f, 0.f), TOLERANCE);
+
+	// Scaling happens on the magnitude, the direction is kept
+	const FVector2D Diagonal = FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.3f, 0.4f));
+	TestEqual(TEXT("A diagonal keeps its direction"), Diagonal.GetSafeNormal(), FVector2D(0.6f, 0.8f), TOLERANCE);
+	TestEqual(TEXT("A diagonal is scaled on its magnitude"), Diagonal.Size(), (0.5f - 0.15f) / 0.8f, TOLERANCE);
+	TestEqual(TEXT("A corner of the stick square is clamped to full deflection"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.8f, 0.8f)).Size(), 1.f, TOLERANCE);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestLookInputResponseCurveTest, "UnrealTest.Input.LookStick.ResponseCurve",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestLookInputResponseCurveTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestLookInputTests;
+	FUnrealTestLookInputSettings Settings;
+
+	// 0.55 is halfway between the dead zones
+	const FVector2D HalfStick(0.55f, 0.f);
+	const float Exponents[] = { 0.5f, 1.f, 2.f, 3.f };
+	for (const float Exponent : Exponents)
+	{
+		Settings.ResponseExponent = Exponent;
+		TestEqual(FString::Printf(TEXT("Exponent %.1f maps half deflection to 0.5^%.1f"), Exponent, Exponent),
+			FUnrealTestLookInputProcessor::ApplyResponse(Settings, HalfStick).X, FMath::Pow(0.5f, Exponent), TOLERANCE);
+		TestEqual(FString::Printf(TEXT("Exponent %.1f keeps full deflection"), Exponent),
+			FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(1.f, 0.f)).X, 1.f, TOLERANCE);
+	}
+
+	// The default curve gives finer control near the center and never goes backwards
+	Settings.ResponseExponent = 2.f;
+	float LastResponse = 0.f;
+	for (float Deflection = 0.f; Deflection <= 1.f; Deflection += 0.05f)
+	{
+		const float Response = FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(Deflection, 0.f)).X;
+		TestTrue(FString::Printf(TEXT("The response grows with the deflection at %.2f"), Deflection), Response >= LastResponse);
+		LastResponse = Response;
+	}
+	TestTrue(TEXT("The default curve is below linear near the center"), FUnrealTestLookInputProcessor::ApplyResponse(Settings, FVector2D(0.35f, 0.f)).X < 0.25f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestLookInputAccelerationTest, "UnrealTest.Input.LookStick.Acceleration",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestLookInputAccelerationTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestLookInputTests;
+	const FUnrealTestLookInputSettings Settings = MakeLinearSettings();
+	const float FrameSeconds = 1.f / 60.f;
+	const FVector2D FullStick(1.f, 0.f);
+
+	// The first frame interpolates from the centered stick, the rate is read from the next ones on
+	FUnrealTestLookInputProcessor Processor;
+	Processor.Process(Settings, FullStick, FrameSeconds, TURN_RATE);
+	float HeldSeconds = FrameSeconds;
+
+	float LastRate = 0.f;
+	for (int32 Frame = 0; Frame < 40; ++Frame)
+	{
+		const float Rate = ProcessRate(Processor, Settings, FullStick, FrameSeconds);
+		HeldSeconds += FrameSeconds;
+
+		if (HeldSeconds <= Settings.AccelerationDelay)
+		{
+			TestEqual(FString::Printf(TEXT("No acceleration before the delay, %.3f s held"), HeldSeconds), Rate, TURN_RATE, TURN_RATE * 0.01f);
+		}
+		else if (HeldSeconds >= Settings.AccelerationDelay + Settings.AccelerationRampTime + 2.f * FrameSeconds)
+		{
+			TestEqual(FString::Printf(TEXT("Full acceleration after the ramp, %.3f s held"), HeldSeconds), Rate, TURN_RATE * Settings.MaxAccelerationMultiplier, TURN_RATE * 0.01f);
+		}
+		else
+		{
+			TestTrue(FString::Printf(TEXT("The acceleration ramps up, %.3f s held"), HeldSeconds), Rate >= LastRate);
+		}
+		LastRate = Rate;
+	}
+
+	const float MidRampSeconds = Settings.AccelerationDelay + Settings.AccelerationRampTime * 0.5f;
+	Processor.Reset();
+	Processor.Process(Settings, FullStick, FrameSeconds, TURN_RATE);
+	for (float Held = FrameSeconds; Held < MidRampSeconds; Held += FrameSeconds)
+	{
+		LastRate = ProcessRate(Processor, Settings, FullStick, FrameSeconds);
+	}
+	TestTrue(TEXT("Halfway through the ramp the rate is between the base and the maximum"),
+		LastRate > TURN_RATE * 1.1f && LastRate < TURN_RATE * Settings.MaxAccelerationMultiplier * 0.9f);
+
+	// Easing off below the threshold drops the acceleration, pushing again starts the delay over
+	ProcessRate(Processor, Settings, FVector2D(0.5f, 0.f), FrameSeconds);
+	ProcessRate(Processor, Settings, FullStick, FrameSeconds);
+	TestEqual(TEXT("Dropping below the threshold resets the acceleration"), ProcessRate(Processor, Settings, FullStick, FrameSeconds), TURN_RATE, TURN_RATE * 0.01f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestLookInputFrameRateTest, "UnrealTest.Input.LookStick.FrameRateIndependence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestLookInputFrameRateTest::RunTest(const FString& Parameters)
+{
+	using namespace UnrealTestLookInputTests;
+	const FUnrealTestLookInputSettings Settings;
+
+	// Frames only decide when a step is integrated, and the carried time is a float:
+	// trajectories may be one step apart, with some rounding on top
+	const float StepTolerance = 1.01f * TURN_RATE * Settings.MaxAccelerationMultiplier * Settings.IntegrationStepSeconds;
+
+	const TArray<float> Reference = SampleTrajectory(Settings, 60);
+	TestTrue(TEXT("The stick turns the view"), Reference.Num() == 6 && Reference.Last() > TURN_RATE * 0.5f);
+
+	const int32 FrameRates[] = { 30, 144 };
+	for (const int32 FrameRate : FrameRates)
+	{
+		const TArray<float> Trajectory = SampleTrajectory(Settings, FrameRate);
+		if (!TestEqual(FString::Printf(TEXT("%d Hz samples the trajectory as often"), FrameRate), Trajectory.Num(), Reference.Num()))
+		{
+			continue;
+		}
+
+		for (int32 Index = 0; Index < Reference.Num(); ++Index)
+		{
+			TestEqual(FString::Printf(TEXT("%d Hz yaw after %d/6 s matches 60 Hz"), FrameRate, Index + 1), Trajectory[Index], Reference[Index], StepTolerance);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
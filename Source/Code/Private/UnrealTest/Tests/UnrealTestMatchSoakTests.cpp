@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestGameMode.h"
+#include "UnrealTest/Game/UnrealTestGameState.h"
+#include "UnrealTest/Game/UnrealTestWaveSpawnerComponent.h"
+#include "UnrealTest/UnrealTestLog.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "UObject/UObjectArray.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestMatchSoakTests
+{
+	constexpr int32 NUM_ROUNDS = 20;
+
+	/** Rounds played before the object count is taken as the baseline, so pools and caches are warm */
+	constexpr int32 WARMUP_ROUNDS = 2;
+
+	/** Phases short enough for a soak to finish in seconds */
+	constexpr float PHASE_SECONDS = 0.2f;
+	constexpr float ROUND_SECONDS = 1.f;
+
+	/**
+	 * Plays the match on the running game mode, one phase change at a time as the game would,
+	 * collects garbage at the start of every warmup and compares the live object count with the baseline.
+	 */
+	class FRoundSoakCommand : public IAutomationLatentCommand
+	{
+	public:
+		FRoundSoakCommand(FAutomationTestBase* InTest, int32 InNumRounds)
+			: Test(InTest)
+			, NumRounds(InNumRounds)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			if (!GameMode.IsValid())
+			{
+				return !Start();
+			}
+
+			const double Elapsed = FPlatformTime::Seconds() - StartTime;
+			if (Elapsed > NumRounds * (2.f * PHASE_SECONDS + ROUND_SECONDS) * 4.f + 30.f)
+			{
+				Test->AddError(FString::Printf(TEXT("The match only went through %d of %d rounds in %.0f s"), NumSamples, NumRounds, Elapsed));
+				Finish();
+				return true;
+			}
+
+			const EUnrealTestMatchPhase Phase = GameMode->GetMatchPhase();
+			const bool bEnteredWarmup = Phase == EUnrealTestMatchPhase::Warmup && LastPhase != EUnrealTestMatchPhase::Warmup;
+			LastPhase = Phase;
+			if (!bEnteredWarmup)
+			{
+				return false;
+			}
+
+			// Every warmup follows a round reset
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			const int32 NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+			const int64 UsedMemory = int64(FPlatformMemory::GetStats().UsedPhysical);
+			if (++NumSamples == WARMUP_ROUNDS)
+			{
+				BaselineObjects = NumObjects;
+				BaselineMemory = UsedMemory;
+			}
+			else if (NumSamples > WARMUP_ROUNDS)
+			{
+				MaxObjectGrowth = FMath::Max(MaxObjectGrowth, NumObjects - BaselineObjects);
+			}
+
+			if (NumSamples < NumRounds + WARMUP_ROUNDS)
+			{
+				return false;
+			}
+
+			UE_LOG(LogUnrealTest, Display, TEXT("Round soak: %d rounds in %.1f s, memory %+lld KB, objects %+d at most"),
+				NumRounds, Elapsed, (UsedMemory - BaselineMemory) / 1024, MaxObjectGrowth);
+			Test->TestEqual(TEXT("Live objects after a round reset and a full purge stay at the warm baseline"), MaxObjectGrowth, 0);
+			Finish();
+			return true;
+		}
+
+	private:
+		/** Speeds up the match of the running game mode and starts it with the local player alone */
+		bool Start()
+		{
+			UWorld* World = AutomationCommon::GetAnyGameWorld();
+			AUnrealTestGameMode* FoundGameMode = World ? World->GetAuthGameMode<AUnrealTestGameMode>() : nullptr;
+			if (FoundGameMode == nullptr)
+			{
+				Test->AddError(TEXT("The soak needs a game world run by AUnrealTestGameMode, start it with -game on a map using it"));
+				return false;
+			}
+
+			GameMode = FoundGameMode;
+			SavedMinPlayersToStart = FoundGameMode->MinPlayersToStart;
+			SavedWarmupSeconds = FoundGameMode->WarmupSeconds;
+			SavedRoundTimeLimitSeconds = FoundGameMode->RoundTimeLimitSeconds;
+			SavedRoundEndSeconds = FoundGameMode->RoundEndSeconds;
+
+			FoundGameMode->MinPlayersToStart = 1;
+			FoundGameMode->WarmupSeconds = PHASE_SECONDS;
+			FoundGameMode->RoundTimeLimitSeconds = ROUND_SECONDS;
+			FoundGameMode->RoundEndSeconds = PHASE_SECONDS;
+
+			// Waves early and often, so NPCs go through the pool every round
+			UUnrealTestWaveSpawnerComponent* WaveSpawner = FoundGameMode->GetWaveSpawner();
+			SavedFirstWaveDelaySeconds = WaveSpawner->FirstWaveDelaySeconds;
+			SavedWaveIntervalSeconds = WaveSpawner->WaveIntervalSeconds;
+			WaveSpawner->FirstWaveDelaySeconds = PHASE_SECONDS;
+			WaveSpawner->WaveIntervalSeconds = PHASE_SECONDS;
+
+			StartTime = FPlatformTime::Seconds();
+			LastPhase = FoundGameMode->GetMatchPhase();
+			if (LastPhase == EUnrealTestMatchPhase::WaitingForPlayers)
+			{
+				FoundGameMode->TryStartWarmup();
+			}
+			return true;
+		}
+
+		void Finish()
+		{
+			if (AUnrealTestGameMode* RunningGameMode = GameMode.Get())
+			{
+				RunningGameMode->MinPlayersToStart = SavedMinPlayersToStart;
+				RunningGameMode->WarmupSeconds = SavedWarmupSeconds;
+				RunningGameMode->RoundTimeLimitSeconds = SavedRoundTimeLimitSeconds;
+				RunningGameMode->RoundEndSeconds = SavedRoundEndSeconds;
+				RunningGameMode->GetWaveSpawner()->FirstWaveDelaySeconds = SavedFirstWaveDelaySeconds;
+				RunningGameMode->GetWaveSpawner()->WaveIntervalSeconds = SavedWaveIntervalSeconds;
+			}
+		}
+
+		FAutomationTestBase* Test;
+		int32 NumRounds;
+
+		TWeakObjectPtr<AUnrealTestGameMode> GameMode;
+		EUnrealTestMatchPhase LastPhase = EUnrealTestMatchPhase::WaitingForPlayers;
+		double StartTime = 0.0;
+
+		int32 NumSamples = 0;
+		int32 BaselineObjects = 0;
+		int64 BaselineMemory = 0;
+		int32 MaxObjectGrowth = 0;
+
+		int32 SavedMinPlayersToStart = 0;
+		float SavedWarmupSeconds = 0.f;
+		float SavedRoundTimeLimitSeconds = 0.f;
+		float SavedRoundEndSeconds = 0.f;
+		float SavedFirstWaveDelaySeconds = 0.f;
+		float SavedWaveIntervalSeconds = 0.f;
+	};
+}
+
+// Needs a running game world: UnrealEditor UnrealTest.uproject /Game/ThirdPerson/Maps/ThirdPersonMap -game -ExecCmds="Automation RunTests UnrealTest.Match.Soak"
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestMatchSoakTest, "UnrealTest.Match.Soak",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::StressFilter)
+
+bool FUnrealTestMatchSoakTest::RunTest(const FString& Parameters)
+{
+	ADD_LATENT_AUTOMATION_COMMAND(UnrealTestMatchSoakTests::FRoundSoakCommand(this, UnrealTestMatchSoakTests::NUM_ROUNDS));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
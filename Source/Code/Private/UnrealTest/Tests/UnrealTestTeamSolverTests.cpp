@@ -0,0 +1,162 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealTest/Game/UnrealTestTeamSolver.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UnrealTestTeamSolverTests
+{
+	TArray<FUnrealTestMatchmakingPlayer> MakePlayers(int32 NumPlayers, FRandomStream& Random)
+	{
+		TArray<FUnrealTestMatchmakingPlayer> Players;
+		Players.SetNum(NumPlayers);
+		for (int32 Index = 0; Index < NumPlayers; ++Index)
+		{
+			Players[Index].PlayerId = Index;
+			Players[Index].Skill = Random.FRandRange(0.f, 100.f);
+		}
+		return Players;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestTeamSolverTeamLimitsTest, "UnrealTest.Matchmaking.TeamSolver.TeamLimits",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestTeamSolverTeamLimitsTest::RunTest(const FString& Parameters)
+{
+	const FUnrealTestTeamSolver Defaults;
+	TestEqual(TEXT("A single player gets a single team"), Defaults.ComputeNumTeams(1), 1);
+	TestEqual(TEXT("Two players get two teams"), Defaults.ComputeNumTeams(2), 2);
+	TestEqual(TEXT("Three players can't make a third team of MinTeamSize"), Defaults.ComputeNumTeams(3), 2);
+	TestEqual(TEXT("Eleven players overflow two teams of MaxTeamSize"), Defaults.ComputeNumTeams(11), 3);
+	TestEqual(TEXT("A hundred players stop at MaxTeams"), Defaults.ComputeNumTeams(100), 8);
+
+	// Teams of exactly two: seven players can't fill four teams of MinTeamSize
+	FUnrealTestTeamSolverSettings PairSettings;
+	PairSettings.MinTeamSize = 2;
+	PairSettings.MaxTeamSize = 2;
+	FUnrealTestTeamSolver Pairs(PairSettings);
+
+	FRandomStream Random(7);
+	Pairs.Solve(UnrealTestTeamSolverTests::MakePlayers(7, Random));
+	TestEqual(TEXT("Seven players in pairs"), Pairs.GetNumTeams(), 3);
+	for (int32 TeamIndex = 0; TeamIndex < Pairs.GetNumTeams(); ++TeamIndex)
+	{
+		TestTrue(FString::Printf(TEXT("Team %d has at least MinTeamSize players"), TeamIndex), Pairs.GetTeamSize(TeamIndex) >= PairSettings.MinTeamSize);
+	}
+
+	FUnrealTestTeamSolverSettings FourTeamSettings;
+	FourTeamSettings.MaxTeams = 4;
+	FUnrealTestTeamSolver FourTeams(FourTeamSettings);
+	FourTeams.Solve(UnrealTestTeamSolverTests::MakePlayers(100, Random));
+	TestEqual(TEXT("MaxTeams caps the teams of a big solve"), FourTeams.GetNumTeams(), 4);
+	TestEqual(TEXT("Every player of a capped solve gets a team"), FourTeams.GetNumPlayers(), 100);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestTeamSolverAddPlayerTest, "UnrealTest.Matchmaking.TeamSolver.AddPlayer",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestTeamSolverAddPlayerTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(8);
+	const TArray<FUnrealTestMatchmakingPlayer> Players = UnrealTestTeamSolverTests::MakePlayers(8, Random);
+
+	FUnrealTestTeamSolver Solver;
+	Solver.Solve(Players);
+	TestEqual(TEXT("Eight players make two teams"), Solver.GetNumTeams(), 2);
+
+	TArray<int32> SolvedTeams;
+	for (const FUnrealTestMatchmakingPlayer& Player : Players)
+	{
+		SolvedTeams.Add(Solver.GetTeamOf(Player.PlayerId));
+	}
+
+	// Late joiners fill the smallest team up to MaxTeamSize
+	for (int32 PlayerId = 8; PlayerId < 10; ++PlayerId)
+	{
+		const int32 SmallestSize = FMath::Min(Solver.GetTeamSize(0), Solver.GetTeamSize(1));
+		const int32 Team = Solver.AddPlayer({ PlayerId, Random.FRandRange(0.f, 100.f) });
+		TestEqual(FString::Printf(TEXT("Player %d joins the smallest team"), PlayerId), Solver.GetTeamSize(Team), SmallestSize + 1);
+	}
+
+	for (int32 Index = 0; Index < Players.Num(); ++Index)
+	{
+		TestEqual(FString::Printf(TEXT("Player %d keeps the team it was solved into"), Players[Index].PlayerId), Solver.GetTeamOf(Players[Index].PlayerId), SolvedTeams[Index]);
+	}
+
+	// Both teams are full now
+	TestEqual(TEXT("A player joining full teams opens a new one"), Solver.AddPlayer({ 10, 50.f }), 2);
+	TestEqual(TEXT("Three teams after the overflow"), Solver.GetNumTeams(), 3);
+
+	const int32 KnownTeam = Solver.GetTeamOf(3);
+	TestEqual(TEXT("Adding a known player returns its team"), Solver.AddPlayer({ 3, 0.f }), KnownTeam);
+	TestEqual(TEXT("Adding a known player doesn't count it twice"), Solver.GetNumPlayers(), 11);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestTeamSolverRemovePlayerTest, "UnrealTest.Matchmaking.TeamSolver.RemovePlayer",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestTeamSolverRemovePlayerTest::RunTest(const FString& Parameters)
+{
+	const TArray<FUnrealTestMatchmakingPlayer> Players = { { 0, 40.f }, { 1, 30.f }, { 2, 20.f }, { 3, 10.f } };
+
+	FUnrealTestTeamSolver Solver;
+	Solver.Solve(Players);
+
+	const int32 Team = Solver.GetTeamOf(1);
+	const int32 TeamSize = Solver.GetTeamSize(Team);
+	const float TeamSkill = Solver.GetTeamSkill(Team);
+
+	Solver.RemovePlayer(1);
+	TestEqual(TEXT("A removed player has no team"), Solver.GetTeamOf(1), INDEX_NONE);
+	TestEqual(TEXT("A removed player leaves the player count"), Solver.GetNumPlayers(), 3);
+	TestEqual(TEXT("A removed player leaves its team"), Solver.GetTeamSize(Team), TeamSize - 1);
+	TestEqual(TEXT("A removed player takes its skill along"), Solver.GetTeamSkill(Team), TeamSkill - 30.f, KINDA_SMALL_NUMBER);
+
+	Solver.RemovePlayer(1);
+	Solver.RemovePlayer(42);
+	TestEqual(TEXT("Removing an unknown player does nothing"), Solver.GetNumPlayers(), 3);
+	TestEqual(TEXT("Removing an unknown player leaves the teams alone"), Solver.GetTeamSize(Team), TeamSize - 1);
+
+	TestEqual(TEXT("A player joining back fills the team short of a player"), Solver.AddPlayer({ 1, 30.f }), Team);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealTestTeamSolverSkillSpreadTest, "UnrealTest.Matchmaking.TeamSolver.SkillSpread",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealTestTeamSolverSkillSpreadTest::RunTest(const FString& Parameters)
+{
+	const TArray<FUnrealTestMatchmakingPlayer> EvenPlayers = { { 0, 4.f }, { 1, 3.f }, { 2, 2.f }, { 3, 1.f } };
+	FUnrealTestTeamSolver Solver;
+	Solver.Solve(EvenPlayers);
+	TestEqual(TEXT("4 + 1 against 3 + 2 is an even split"), Solver.GetSkillSpread(), 0.f, KINDA_SMALL_NUMBER);
+
+	// Greedy assignment to the weakest team bounds the spread by the best single player, the swaps only shrink it
+	for (int32 Seed = 0; Seed < 100; ++Seed)
+	{
+		FRandomStream Random(Seed);
+		const TArray<FUnrealTestMatchmakingPlayer> Players = UnrealTestTeamSolverTests::MakePlayers(Random.RandRange(2, 40), Random);
+
+		float BestSkill = 0.f;
+		for (const FUnrealTestMatchmakingPlayer& Player : Players)
+		{
+			BestSkill = FMath::Max(BestSkill, Player.Skill);
+		}
+
+		Solver.Solve(Players);
+		TestTrue(FString::Printf(TEXT("Seed %d: spread %.2f within the best player skill %.2f"), Seed, Solver.GetSkillSpread(), BestSkill),
+			Solver.GetSkillSpread() <= BestSkill + KINDA_SMALL_NUMBER);
+		TestEqual(FString::Printf(TEXT("Seed %d: every player gets a team"), Seed), Solver.GetNumPlayers(), Players.Num());
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
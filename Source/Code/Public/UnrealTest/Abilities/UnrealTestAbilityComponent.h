@@ -0,0 +1,140 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UnrealTest/Game/UnrealTestRoundResettable.h"
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
+#include "UnrealTestAbilityComponent.generated.h"
+
+/** Most abilities a champion can have, ability state lives in arrays of this size */
+constexpr int32 UNREALTEST_MAX_ABILITIES = 16;
+
+/** Most timed buffs a champion can carry at once */
+constexpr int32 UNREALTEST_MAX_BUFFS = 8;
+
+class UUnrealTestAbilityComponent;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FUnrealTestAbilityReadySignature, UUnrealTestAbilityComponent*, int32 /* AbilityIndex */);
+
+/** Cooldown and charges of one champion ability */
+USTRUCT(BlueprintType)
+struct FUnrealTestAbilityDefinition
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ability)
+	FName Name;
+
+	/** Seconds it takes one charge to come back */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ability, meta = (ClampMin = "0.0"))
+	float CooldownSeconds = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ability, meta = (ClampMin = "1"))
+	int32 MaxCharges = 1;
+};
+
+/**
+ * Cooldowns, charges and timed buffs of a champion.
+ * Every ability is described by a single timestamp, the server time its charges are full again, stored
+ * as integer milliseconds in fixed size arrays. Nothing ticks: charges are derived from the timestamps
+ * when queried, and only the timestamps are replicated, so the cost doesn't grow with time or ability count.
+ */
+UCLASS(ClassGroup=(Abilities), meta=(BlueprintSpawnableComponent))
+class UUnrealTestAbilityComponent : public UActorComponent, public IUnrealTestRoundResettable
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestAbilityComponent();
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// End of UActorComponent interface
+
+	// IUnrealTestRoundResettable interface
+	virtual void ResetForNewRound() override;
+	// End of IUnrealTestRoundResettable interface
+
+	/** Index of the ability with the given name, INDEX_NONE if the champion doesn't have it */
+	int32 FindAbility(FName AbilityName) const;
+
+	/** Number of charges the ability has right now */
+	int32 GetCharges(int32 AbilityIndex) const;
+
+	/** Seconds until the next charge of the ability comes back, 0 when charges are full */
+	float GetCooldownRemaining(int32 AbilityIndex) const;
+
+	/** True if the ability has at least one charge right now */
+	bool IsAbilityReady(int32 AbilityIndex) const;
+
+	/** Bit per ability, set when it has at least one charge. One branchless pass over the arrays */
+	uint32 GetReadyMask() const;
+
+	/**
+	 * Spends one charge of the ability if there is one.
+	 * Clients call it to predict, the server's timestamps win once they replicate.
+	 * @param SecondsAgo	Server only, how long ago the owning player activated it. Charges are checked and
+	 *						spent at that time, so RPC jitter doesn't turn back to back activations down
+	 */
+	bool TryActivateAbility(int32 AbilityIndex, float SecondsAgo = 0.f);
+
+	/** Server time, in milliseconds, the ability has all its charges back */
+	int32 GetChargesFullAtMs(int32 AbilityIndex) const;
+
+	/**
+	 * Client only. Replaces a prediction the server turned down with the server's timestamp.
+	 * Needed because a timestamp the server never changed doesn't replicate again.
+	 */
+	void ResyncAbility(int32 AbilityIndex, int32 ServerChargesFullAtMs);
+
+	/** Server only. Applies or refreshes a buff for Duration seconds */
+	void ApplyBuff(uint8 BuffId, float Duration);
+
+	bool IsBuffActive(uint8 BuffId) const;
+
+	/** Abilities of the champion, in the order they are referenced by index */
+	UPROPERTY(EditDefaultsOnly, Category = Ability)
+	TArray<FUnrealTestAbilityDefinition> Abilities;
+
+	/** Broadcast where the ability was activated, when its first charge comes back */
+	FUnrealTestAbilityReadySignature OnAbilityReady;
+
+protected:
+	/** Server time, in milliseconds, used for every timestamp of the component */
+	int32 GetNowMs() const;
+
+	/** Ready mask at the given server time */
+	uint32 GetReadyMaskAt(int32 AtMs) const;
+
+	/** Schedules the ready timer of the ability for its first charge, if it has none yet */
+	void ScheduleReadyTimer(int32 AbilityIndex);
+
+	void OnReadyTimerElapsed(int32 AbilityIndex);
+
+	void CancelReadyTimers();
+
+	/** Server time each ability has all its charges back */
+	UPROPERTY(Replicated)
+	int32 ChargesFullAtMs[UNREALTEST_MAX_ABILITIES];
+
+	/** Server time each buff slot expires */
+	UPROPERTY(Replicated)
+	int32 BuffEndMs[UNREALTEST_MAX_BUFFS];
+
+	/** Buff held by each buff slot */
+	UPROPERTY(Replicated)
+	uint8 BuffIds[UNREALTEST_MAX_BUFFS];
+
+private:
+	/** Definitions baked into arrays so the per query math never touches the TArray */
+	int32 CooldownMs[UNREALTEST_MAX_ABILITIES];
+	int32 MaxCharges[UNREALTEST_MAX_ABILITIES];
+	int32 NumAbilities;
+
+	/** Gameplay timers of the abilities waiting for a charge */
+	FUnrealTestTimerHandle ReadyTimers[UNREALTEST_MAX_ABILITIES];
+};
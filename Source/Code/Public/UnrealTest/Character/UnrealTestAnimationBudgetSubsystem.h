@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTestAnimationBudgetSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * Shares a per frame animation time budget between the character meshes of the world.
+ * Meshes are ranked by significance, distance to the local view and whether they were rendered, and the most
+ * significant ones animate every frame until the budget runs out. The rest update every few frames through the
+ * external tick rate control of the update rate optimizations, interpolating in between, and meshes off screen
+ * only tick their pose when rendered again. Costs are the game thread time UUnrealTestSkeletalMeshComponent measures.
+ *
+ * Dedicated servers never evaluate a full pose: meshes only tick montages, or when hitboxes need bones,
+ * evaluate their lowest LOD, meant to be stripped down to the hitbox bones, every few frames.
+ */
+UCLASS(config=Game)
+class UUnrealTestAnimationBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestAnimationBudgetSubsystem();
+
+	// UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End of UTickableWorldSubsystem interface
+
+	/** @param bNeedsHitboxPose whether the server reads bones of this mesh for its hitboxes */
+	void RegisterMesh(USkeletalMeshComponent* Mesh, bool bNeedsHitboxPose = false);
+	void UnregisterMesh(USkeletalMeshComponent* Mesh);
+
+	/** Game thread time spent animating on screen meshes every frame, in milliseconds */
+	UPROPERTY(Config)
+	float FrameBudgetMs;
+
+	/** Cost of animating one mesh for one frame assumed until meshes have been measured, in milliseconds */
+	UPROPERTY(Config)
+	float InitialMeshCostMs;
+
+	/** Distance at which significance has halved */
+	UPROPERTY(Config)
+	float ReferenceDistance;
+
+	/** Frames between two updates meshes fall back to, from the most significant to the least, once the budget is spent */
+	UPROPERTY(Config)
+	TArray<int32> ReducedTickRates;
+
+	/** Meshes at reduced rates blend towards their last pose on the frames they skip */
+	UPROPERTY(Config)
+	bool bInterpolateReducedRates;
+
+	/** Seconds between two rankings of the meshes */
+	UPROPERTY(Config)
+	float UpdateInterval;
+
+	/** Dedicated servers evaluate poses, of the forced LOD, for meshes whose hitboxes rewind bones */
+	UPROPERTY(Config)
+	bool bServerEvaluatesHitboxPose;
+
+	/**
+	 * LOD dedicated servers evaluate poses at, as for USkinnedMeshComponent::SetForcedLOD (0 leaves it automatic,
+	 * which is LOD0 without a view). INDEX_NONE forces the lowest LOD of each mesh
+	 */
+	UPROPERTY(Config)
+	int32 ServerForcedLOD;
+
+	/** Frames between two evaluations of the server hitbox pose */
+	UPROPERTY(Config)
+	int32 ServerPoseTickRate;
+
+protected:
+	struct FBudgetedMesh
+	{
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		/** Frames between two updates, 1 updates every frame */
+		uint8 TickRate = 1;
+
+		/** Spreads the updates of meshes at the same rate over different frames */
+		uint8 FrameOffset = 0;
+
+		bool bInterpolate = false;
+
+		/** Updated this frame */
+		bool bUpdated = false;
+
+		/** Time since the last update, handed to the mesh when it updates */
+		float AccumulatedDeltaTime = 0.f;
+	};
+
+	/** Sets the tick options dedicated servers run the mesh with */
+	void ConfigureServerMesh(FBudgetedMesh& Budgeted, bool bNeedsHitboxPose) const;
+
+	/** Ranks the meshes and hands out the budget */
+	void UpdateBudget();
+
+	/** Tells every mesh whether it updates this frame, and how far between its poses it is when it doesn't */
+	void DriveMeshUpdates(float DeltaTime);
+
+	/** Adds the game thread time the meshes measured this frame to the cost of a mesh */
+	void MeasureMeshCosts();
+
+	/** Location the local player sees the world from, false without a local player */
+	bool GetViewLocation(FVector& OutLocation) const;
+
+	const float FRAME_BUDGET_MS = 1.f;
+	const float INITIAL_MESH_COST_MS = 0.1f;
+	const float REFERENCE_DISTANCE = 2000.f;
+	const float UPDATE_INTERVAL = 0.1f;
+	const int32 SERVER_POSE_TICK_RATE = 2;
+
+	/** Weight of the last frame in the measured mesh cost */
+	const float MESH_COST_SMOOTHING = 0.05f;
+
+private:
+	TArray<FBudgetedMesh> Meshes;
+
+	// Scratch arrays of the ranking, kept to avoid allocating every update
+	TArray<float> Significances;
+	TArray<int32> RankedIndices;
+
+	float TimeUntilUpdate;
+
+	/** Measured game thread cost of updating one mesh, smoothed over frames */
+	float MeshCostMs;
+
+	uint8 NextFrameOffset;
+};
@@ -4,10 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "UnrealTest/Combat/UnrealTestAttackTypes.h"
+#include "UnrealTest/Game/UnrealTestPoolable.h"
+#include "UnrealTest/Game/UnrealTestRoundResettable.h"
+#include "UnrealTest/Input/UnrealTestInputCommandFrame.h"
+#include "UnrealTest/Input/UnrealTestLookInputProcessor.h"
 #include "UnrealTestCharacter.generated.h"
 
 UCLASS(config=Game)
-class AUnrealTestCharacter : public ACharacter
+class AUnrealTestCharacter : public ACharacter, public IUnrealTestRoundResettable, public IUnrealTestPoolable
 {
 	GENERATED_BODY()
 
@@ -18,38 +23,160 @@ class AUnrealTestCharacter : public ACharacter
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
+
+	/** Server side history of the capsule, used to validate attacks under latency */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestHitboxHistoryComponent* HitboxHistory;
+
+	/** Cooldowns, charges and buffs of the champion */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestAbilityComponent* Abilities;
+
+	/** Health, shield and status effects of the champion */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestHealthComponent* Health;
+
+	/** Server side swing of melee champions, idle for the others */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestMeleeAttackComponent* MeleeAttack;
 public:
-	AUnrealTestCharacter();
+	AUnrealTestCharacter(const FObjectInitializer& ObjectInitializer);
+
+	// AActor interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+	virtual float GetNetPriority(const FVector& ViewPos, const FVector& ViewDir, AActor* Viewer, AActor* ViewTarget, UActorChannel* InChannel, float Time, bool bLowBandwidth) override;
+	// End of AActor interface
+
+	// IUnrealTestRoundResettable interface
+	virtual void ResetForNewRound() override;
+	// End of IUnrealTestRoundResettable interface
+
+	// IUnrealTestPoolable interface
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
+	// End of IUnrealTestPoolable interface
+
+	/** Champion this character plays, selects its movement tuning */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Champion)
+	FName ChampionName;
 
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Input)
 	float TurnRateGamepad;
 
+	/** Dead zones, response curve and acceleration of the gamepad look stick */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category=Input)
+	FUnrealTestLookInputSettings GamepadLookSettings;
+
+	/** Melee champions swing their MeleeAttack instead of firing a projectile */
+	UPROPERTY(EditDefaultsOnly, Category = Attack)
+	bool bMeleeAttack;
+
+	/** Projectile spawned by this champion's attack */
+	UPROPERTY(EditDefaultsOnly, Category = Attack)
+	TSubclassOf<class AUnrealTestProjectile> ProjectileClass;
+
+	/** Projectiles this character adds to the actor pool when it begins play, enough for its shots in flight */
+	UPROPERTY(EditDefaultsOnly, Category = Attack)
+	int32 ProjectilePrewarmCount;
+
+	/** Distance in front of the character the projectile is spawned at */
+	UPROPERTY(EditDefaultsOnly, Category = Attack)
+	float MuzzleOffset;
+
+	/** How far the client reported origin may be from the server character before it gets replaced */
+	UPROPERTY(EditDefaultsOnly, Category = Attack)
+	float MaxAttackOriginError;
+
+	/**
+	 * How far back from ServerTime an attack is resolved: to the client fire time when the request has one,
+	 * half the round trip otherwise. Not capped, the hitbox history bounds it
+	 */
+	static float GetRewindSeconds(const FUnrealTestAttackRequest& Request, double ServerTime, float HalfRoundTripSeconds);
+
+#if !UE_SERVER
+	/** Removes and returns the predicted projectile matching the replicated one, if it is still alive */
+	class AUnrealTestProjectile* TakePredictedProjectile(uint32 ProjectileId);
+
+	/**
+	 * Returns what the keyboard, mouse and gamepad bindings did this frame and starts the next frame,
+	 * the look stick sample goes through the look input processor here. Called by the player controller.
+	 */
+	FUnrealTestInputCommandFrame ConsumeInputCommand(float DeltaSeconds);
+
+	/** Moves, aims, jumps and fires as the merged input of every device asks for, once per frame */
+	void ApplyInputCommand(const FUnrealTestInputCommandFrame& Command);
+#endif
+
 protected:
 
+	/** Sends the attack to the server */
+	UFUNCTION(Server, Reliable)
+	void ServerAttack(const FUnrealTestAttackRequest& Request);
+
+	/** Tells the owning player the attack was on cooldown, so it drops the prediction and takes the server's cooldown */
+	UFUNCTION(Client, Reliable)
+	void ClientRejectAttack(uint32 ProjectileId, int32 ChargesFullAtMs);
+
+	/** Server side attack resolution */
+	virtual void HandleAttack(const FUnrealTestAttackRequest& Request);
+
+	/** Stops the champion in place, on the server and on clients. Undone by the round reset */
+	void HandleDeath(class UUnrealTestHealthComponent* DeadHealth, AController* Killer);
+	void HandleRevived(class UUnrealTestHealthComponent* RevivedHealth);
+
+	/** Half of the owning player's round trip time, in seconds */
+	float GetHalfRoundTripSeconds() const;
+
+	/** How far back in time the server resolves the attack, from the client fire time when there is one */
+	float GetAttackRewindSeconds(const FUnrealTestAttackRequest& Request) const;
+
+	// Dedicated servers have no local player, so input and client prediction are compiled out
+#if !UE_SERVER
+	/** Called via input to attack. The attack is sent once the controller rotation of the frame is known */
+	void Attack();
+
+	/** Sends the attack queued this frame, aimed where the view was when the button was clicked */
+	void FireQueuedAttack();
+
+	/** Takes the local copy of the projectile the server is about to spawn from the actor pool */
+	void SpawnPredictedProjectile(const FUnrealTestAttackRequest& Request);
+
+	/** Whether the tracked prediction is still in flight for that shot, pooled projectiles get reused */
+	static bool IsPredictionPending(uint32 ProjectileId, const class AUnrealTestProjectile* Projectile);
+
 	/** Called for forwards/backward input */
 	void MoveForward(float Value);
 
 	/** Called for side to side input */
 	void MoveRight(float Value);
 
+	/** Called for devices that provide an absolute turn delta, such as a mouse */
+	void Turn(float Value);
+
+	/** Called for devices that provide an absolute look up/down delta, such as a mouse */
+	void LookUp(float Value);
+
+	/** Called via input to start and stop jumping */
+	void JumpPressed();
+	void JumpReleased();
+
 	/** 
 	 * Called via input to turn at a given rate. 
+	 * The rate is stored and turned into rotation once per frame by ConsumeInputCommand.
 	 * @param Rate	This is a normalized rate, i.e. 1.0 means 100% of desired turn rate
 	 */
 	void TurnAtRate(float Rate);
 
 	/**
 	 * Called via input to turn look up/down at a given rate. 
+	 * The rate is stored and turned into rotation once per frame by ConsumeInputCommand.
 	 * @param Rate	This is a normalized rate, i.e. 1.0 means 100% of desired turn rate
 	 */
 	void LookUpAtRate(float Rate);
-
-	/** Handler for when a touch input begins. */
-	void TouchStarted(ETouchIndex::Type FingerIndex, FVector Location);
-
-	/** Handler for when a touch input stops. */
-	void TouchStopped(ETouchIndex::Type FingerIndex, FVector Location);
+#endif
 
 protected:
 	// APawn interface
@@ -61,9 +188,22 @@ public:
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns Abilities subobject **/
+	FORCEINLINE class UUnrealTestAbilityComponent* GetAbilities() const { return Abilities; }
+	/** Returns Health subobject **/
+	FORCEINLINE class UUnrealTestHealthComponent* GetHealth() const { return Health; }
+	/** Returns MeleeAttack subobject **/
+	FORCEINLINE class UUnrealTestMeleeAttackComponent* GetMeleeAttack() const { return MeleeAttack; }
 
 	void DisableCotrollerRotation();
 	void ConfigureCharacterMovement(class UCharacterMovementComponent* characterMovement);
+	void ApplyMovementTuning(const struct FUnrealTestMovementTuning& Tuning);
+	void SetHitboxHistory();
+	void SetAbilities();
+	void SetHealth();
+	void SetMeleeAttack();
+
+#if !UE_SERVER
 	void SetCameraBoom();
 	void SetFollowCamera();
 
@@ -71,13 +211,40 @@ public:
 	void MovementBinding(class UInputComponent* PlayerInputComponent);
 	void TurnBinding(class UInputComponent* PlayerInputComponent);
 	void LookUpBinding(class UInputComponent* PlayerInputComponent);
-	void TouchBinding(class UInputComponent* PlayerInputComponent);
+	void AttackBinding(class UInputComponent* PlayerInputComponent);
+#endif
 
 	const float TURN_RATE_GAMEPAD = 50.f;
-	const float JUMP_Z_VELOCITY= 700.f;
-	const float AIR_CONTROL = 0.35f;
-	const float MAX_WALK_SPEED = 500.f;
-	const float MIN_ANALOG_WALK_SPEED = 20.f;
-	const float BRAKING_DECELERATION_WALKING = 2000.f;
+	const float MUZZLE_OFFSET = 60.f;
+	const float MAX_ATTACK_ORIGIN_ERROR = 150.f;
+	const int32 PROJECTILE_PREWARM_COUNT = 8;
+	const float PRIMARY_ATTACK_COOLDOWN = 0.5f;
+
+	/** Index of the primary attack in the ability component */
+	static const int32 PRIMARY_ATTACK_ABILITY = 0;
+
+#if !UE_SERVER
+private:
+	/** Projectiles predicted by the local player, waiting for their authoritative counterpart */
+	TMap<uint32, TWeakObjectPtr<class AUnrealTestProjectile>> PredictedProjectiles;
+
+	FUnrealTestLookInputProcessor GamepadLookProcessor;
+
+	/** Look stick sample of this frame, X turns and Y looks up */
+	FVector2D GamepadLookStick;
+
+	/** Input the bindings gathered this frame */
+	FUnrealTestInputCommandFrame PendingInputCommand;
+
+	/** Whether the last applied command held jump */
+	bool bJumpInputHeld;
+
+	bool bAttackQueued;
+
+	/** Platform time the queued attack input was handled at */
+	double AttackInputPlatformTime;
+
+	uint32 NextProjectileId;
+#endif
 };
 
@@ -0,0 +1,67 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "UnrealTestMovementSettings.generated.h"
+
+/** Character movement values designers tune per champion */
+USTRUCT(BlueprintType)
+struct FUnrealTestMovementTuning
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float JumpZVelocity = 700.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AirControl = 0.35f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float MaxWalkSpeed = 500.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float MinAnalogWalkSpeed = 20.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Movement)
+	float BrakingDecelerationWalking = 2000.f;
+};
+
+/** Movement tuning of one champion, as replicated by the game state */
+USTRUCT()
+struct FUnrealTestChampionMovementTuning
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName ChampionName;
+
+	UPROPERTY()
+	FUnrealTestMovementTuning Tuning;
+};
+
+/**
+ * Movement tuning of every champion, in the [/Script/UnrealTest.UnrealTestMovementSettings] section of DefaultGame.ini.
+ * UnrealTest.Movement.Reload rereads it on a running server and pushes it to every pawn.
+ */
+UCLASS(config=Game, defaultconfig, meta=(DisplayName="Champion Movement"))
+class UUnrealTestMovementSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** Tuning of the champion, or the default tuning for champions without one */
+	const FUnrealTestMovementTuning& GetTuning(FName ChampionName) const;
+
+	/** Every champion's tuning, in the form the game state replicates */
+	void GetChampionTunings(TArray<FUnrealTestChampionMovementTuning>& OutTunings) const;
+
+	/** Used by champions not listed below */
+	UPROPERTY(Config, EditAnywhere, Category = Movement)
+	FUnrealTestMovementTuning DefaultTuning;
+
+	/** Tuning per champion, keyed by the ChampionName of the character */
+	UPROPERTY(Config, EditAnywhere, Category = Movement)
+	TMap<FName, FUnrealTestMovementTuning> ChampionTunings;
+};
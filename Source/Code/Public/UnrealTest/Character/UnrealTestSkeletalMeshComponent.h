@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "UnrealTestSkeletalMeshComponent.generated.h"
+
+/**
+ * Character mesh that measures the game thread time it spends animating, so the animation budget
+ * (UUnrealTestAnimationBudgetSubsystem) hands out measured costs rather than guessed ones.
+ */
+UCLASS(ClassGroup=(Rendering), meta=(BlueprintSpawnableComponent))
+class UUnrealTestSkeletalMeshComponent : public USkeletalMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	// UActorComponent interface
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// End of UActorComponent interface
+
+	// USkinnedMeshComponent interface
+	virtual void FinalizeBoneTransform() override;
+	// End of USkinnedMeshComponent interface
+
+	/** Game thread cycles spent ticking and finalizing the pose since the last call */
+	uint64 ConsumeGameThreadCycles();
+
+private:
+	uint64 GameThreadCycles = 0;
+};
@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "UnrealTestAttackTypes.generated.h"
+
+/** Attack issued by a client and sent to the server in the attack RPC */
+USTRUCT()
+struct FUnrealTestAttackRequest
+{
+	GENERATED_BODY()
+
+	/** World location the attack was fired from, as seen by the client */
+	UPROPERTY()
+	FVector_NetQuantize10 Origin;
+
+	/** Aim direction of the attack, as seen by the client */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	/** Client generated id used to match the predicted projectile with the authoritative one */
+	UPROPERTY()
+	uint32 ProjectileId = 0;
+
+	/** Synchronized server time the input was delivered at on the client, the server rewinds to it */
+	UPROPERTY()
+	double ClientFireTime = 0.0;
+};
+
+/** Result of a test against the rewound hitboxes */
+struct FUnrealTestRewindHit
+{
+	/** Actor owning the hitbox that was hit */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Point on the tested shape path where the hit happened */
+	FVector Location = FVector::ZeroVector;
+
+	/** Normal pointing from the hitbox towards the hit location */
+	FVector Normal = FVector::UpVector;
+
+	/** Normalized position of the hit along the tested segment */
+	float Time = 1.f;
+
+	/** Bone of the bone hitbox that was hit, None when the character only has its capsule */
+	FName BoneName;
+
+	/** Scale applied to the damage of the hit, e.g. for headshots */
+	float DamageMultiplier = 1.f;
+};
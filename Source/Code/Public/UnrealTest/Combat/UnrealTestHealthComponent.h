@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "UnrealTest/Game/UnrealTestRoundResettable.h"
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
+#include "UnrealTestHealthComponent.generated.h"
+
+class UUnrealTestHealthComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FUnrealTestHealthChangedSignature, UUnrealTestHealthComponent*);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FUnrealTestDeathSignature, UUnrealTestHealthComponent*, AController* /* Killer */);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FUnrealTestStatusEffectChangedSignature, UUnrealTestHealthComponent*, FName /* EffectName */);
+
+/** Timed effect applied to a champion: a buff, a debuff, or damage over time */
+USTRUCT(BlueprintType)
+struct FUnrealTestStatusEffectSpec
+{
+	GENERATED_BODY()
+
+	/** Applying an effect already present refreshes it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = StatusEffect)
+	FName Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = StatusEffect, meta = (ClampMin = "0.0"))
+	float Duration = 0.f;
+
+	/** Damage dealt every TickInterval while the effect lasts, 0 for effects that only flag the champion */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = StatusEffect)
+	float DamagePerTick = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = StatusEffect, meta = (ClampMin = "0.05"))
+	float TickInterval = 1.f;
+};
+
+/** Status effect currently on a champion, replicated as a fast array item so only changes are sent */
+USTRUCT()
+struct FUnrealTestStatusEffect : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName Name;
+
+	/** Server world time the effect ends at */
+	UPROPERTY()
+	float EndTime = 0.f;
+
+	UPROPERTY()
+	float DamagePerTick = 0.f;
+
+	// Server only bookkeeping
+	float TickInterval = 0.f;
+	TWeakObjectPtr<AController> Instigator;
+	FUnrealTestTimerHandle ExpiryTimer;
+	FUnrealTestTimerHandle TickTimer;
+
+	void PostReplicatedAdd(const struct FUnrealTestStatusEffectArray& InArraySerializer);
+	void PostReplicatedChange(const struct FUnrealTestStatusEffectArray& InArraySerializer);
+	void PreReplicatedRemove(const struct FUnrealTestStatusEffectArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FUnrealTestStatusEffectArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FUnrealTestStatusEffect> Items;
+
+	/** Component owning the array, to forward replication events to */
+	UPROPERTY(NotReplicated)
+	UUnrealTestHealthComponent* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FUnrealTestStatusEffect, FUnrealTestStatusEffectArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FUnrealTestStatusEffectArray> : public TStructOpsTypeTraitsBase2<FUnrealTestStatusEffectArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Health, shield and status effects of a champion.
+ * The component never ticks: damage arrives through the owner's OnTakeAnyDamage, and effect ticks and expiry
+ * are scheduled on the shared gameplay timers. Status effects replicate as individual change events.
+ */
+UCLASS(ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class UUnrealTestHealthComponent : public UActorComponent, public IUnrealTestRoundResettable
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestHealthComponent();
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// End of UActorComponent interface
+
+	// IUnrealTestRoundResettable interface
+	virtual void ResetForNewRound() override;
+	// End of IUnrealTestRoundResettable interface
+
+	/** Server only. Shield absorbs the damage first, whatever is left goes to health */
+	void ApplyDamage(float Amount, AController* DamageInstigator);
+
+	/** Server only */
+	void AddShield(float Amount);
+
+	/** Server only. Adds the effect, or refreshes it if the champion already has it */
+	void ApplyStatusEffect(const FUnrealTestStatusEffectSpec& Spec, AController* EffectInstigator);
+
+	/** Server only */
+	void RemoveStatusEffect(FName EffectName);
+
+	bool HasStatusEffect(FName EffectName) const;
+
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetShield() const { return Shield; }
+	FORCEINLINE bool IsDead() const { return bDead; }
+
+	UPROPERTY(EditDefaultsOnly, Category = Health)
+	float MaxHealth;
+
+	/** Broadcast on the server and on clients whenever health or shield change */
+	FUnrealTestHealthChangedSignature OnHealthChanged;
+
+	/** Broadcast on the server and on clients, the killer is only known on the server */
+	FUnrealTestDeathSignature OnDeath;
+
+	/** Broadcast on the server and on clients when the round reset brings the champion back */
+	FUnrealTestHealthChangedSignature OnRevived;
+
+	/** Broadcast on the server and on clients when an effect is added, refreshed or removed */
+	FUnrealTestStatusEffectChangedSignature OnStatusEffectChanged;
+
+	const float MAX_HEALTH = 100.f;
+
+protected:
+	UFUNCTION()
+	void HandleTakeAnyDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, AController* InstigatedBy, AActor* DamageCauser);
+
+	UFUNCTION()
+	void OnRep_Health();
+
+	UFUNCTION()
+	void OnRep_Dead();
+
+	void OnStatusEffectTick(FName EffectName);
+	void OnStatusEffectExpired(FName EffectName);
+
+	void Die(AController* Killer);
+
+	/** Cancels the timers of every effect and removes them all */
+	void ClearStatusEffects();
+
+	class UUnrealTestTimerSubsystem* GetTimers() const;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Health)
+	float Health;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Health)
+	float Shield;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Dead)
+	bool bDead;
+
+	UPROPERTY(Replicated)
+	FUnrealTestStatusEffectArray StatusEffects;
+
+	friend struct FUnrealTestStatusEffect;
+};
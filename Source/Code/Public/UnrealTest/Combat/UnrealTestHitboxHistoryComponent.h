@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UnrealTest/Combat/UnrealTestAttackTypes.h"
+#include "UnrealTestHitboxHistoryComponent.generated.h"
+
+/** Capsule hitbox of a character at a given server time */
+struct FUnrealTestHitboxSample
+{
+	double Time = 0.0;
+	FVector Center = FVector::ZeroVector;
+	float Radius = 0.f;
+	float HalfHeight = 0.f;
+};
+
+/** Capsule following a bone of the character, for hits more precise than the movement capsule */
+USTRUCT(BlueprintType)
+struct FUnrealTestBoneHitbox
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hitbox)
+	FName Bone;
+
+	/** The capsule runs from Bone to EndBone, or is a sphere around Bone when None */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hitbox)
+	FName EndBone;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hitbox, meta = (ClampMin = "0.0"))
+	float Radius = 10.f;
+
+	/** Scale of the damage dealt by hits on this capsule */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hitbox, meta = (ClampMin = "0.0"))
+	float DamageMultiplier = 1.f;
+};
+
+/** Bone position relative to the capsule center, in 1/8 cm steps */
+struct FUnrealTestQuantizedBonePosition
+{
+	int16 X = 0;
+	int16 Y = 0;
+	int16 Z = 0;
+};
+
+/**
+ * Records the owner's capsule on the server every tick into a fixed size ring buffer,
+ * so attacks can be tested against where the character was when the client fired.
+ * Characters with bone hitboxes also record the positions of those bones, quantized to 6 bytes each,
+ * read from whatever pose the server already has: it never evaluates animation for them.
+ */
+UCLASS(config=Game, ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class UUnrealTestHitboxHistoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestHitboxHistoryComponent();
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// End of UActorComponent interface
+
+	/**
+	 * Returns the owner's hitbox at the given server time, interpolating between recorded samples.
+	 * Times older than the history are clamped to the oldest sample.
+	 * @return false when nothing has been recorded yet
+	 */
+	bool GetHitboxAtTime(double Time, FUnrealTestHitboxSample& OutSample) const;
+
+	/**
+	 * Sweeps a sphere against the bone hitboxes as they were at the given server time.
+	 * Meant to refine a hit on the rewound capsule, see HasBoneHitboxes.
+	 */
+	bool SweepBoneHitboxes(double Time, const FVector& Start, const FVector& End, float Radius, FUnrealTestRewindHit& OutHit) const;
+
+	FORCEINLINE bool HasBoneHitboxes() const { return BonePoints.Num() > 0; }
+
+	/** Drops every recorded sample, e.g. after a teleport */
+	void ClearHistory();
+
+	/**
+	 * Takes the owner out of lag compensation and stops recording, or puts it back with an empty history.
+	 * For owners nothing may hit for a while: dead characters, or NPCs parked in the actor pool.
+	 */
+	void SetHittable(bool bInHittable);
+
+	FORCEINLINE bool IsHittable() const { return bHittable; }
+
+	/** Oldest time we keep history for, relative to now */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Combat)
+	float MaxRewindSeconds;
+
+	/** Bone capsules tested once the movement capsule is hit. Leave empty to only use the movement capsule */
+	UPROPERTY(EditDefaultsOnly, Category = Combat)
+	TArray<FUnrealTestBoneHitbox> BoneHitboxes;
+
+	/** Most memory the bone history of one character may use, fewer samples are kept to stay under it. Bone hitboxes are left out when two samples don't fit */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Combat)
+	int32 MaxBoneHistoryBytes;
+
+	/** How far bone hitboxes may reach outside the movement capsule, which is inflated by this much for them */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Combat)
+	float BoneHitboxReach;
+
+private:
+	void RecordSample();
+	const FUnrealTestHitboxSample& GetSample(int32 AgeIndex) const;
+
+	/**
+	 * Finds the two samples around the given time, clamped to the history.
+	 * @return false when nothing has been recorded yet
+	 */
+	bool FindSamples(double Time, int32& OutNewerAge, int32& OutOlderAge, float& OutAlpha) const;
+
+	/** Resolves the bones of the bone hitboxes on the owner's mesh */
+	void InitBonePoints();
+
+	/** Ring buffer of samples, Head points at the newest one */
+	TArray<FUnrealTestHitboxSample> Samples;
+	int32 Head;
+	int32 NumSamples;
+
+	/** Bone positions of every sample, NumBonePoints per sample in the same ring order as Samples */
+	TArray<FUnrealTestQuantizedBonePosition> BoneSamples;
+
+	/** Distinct bones used by the bone hitboxes, as mesh bone indices */
+	TArray<int32> BonePoints;
+
+	/** Points each bone hitbox starts and ends at, INDEX_NONE ends for spheres */
+	TArray<TPair<int32, int32>> BoneHitboxPoints;
+
+	/** Whether the owner is registered with lag compensation, picked up by BeginPlay when set before it */
+	bool bHittable;
+
+	const float MAX_REWIND_SECONDS = 0.4f;
+	const int32 HISTORY_CAPACITY = 64;
+	const int32 MAX_BONE_HISTORY_BYTES = 4096;
+	const float BONE_HITBOX_REACH = 40.f;
+	const float BONE_POSITION_SCALE = 8.f;
+};
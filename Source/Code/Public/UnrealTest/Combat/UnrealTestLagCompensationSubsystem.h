@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Combat/UnrealTestAttackTypes.h"
+#include "UnrealTest/Combat/UnrealTestHitboxHistoryComponent.h"
+#include "UnrealTest/Memory/UnrealTestFrameArena.h"
+#include "UnrealTestLagCompensationSubsystem.generated.h"
+
+/** Hitbox of a character as it was at a past server time */
+struct FUnrealTestRewoundHitbox
+{
+	AActor* Actor = nullptr;
+	FUnrealTestHitboxSample Sample;
+};
+
+/**
+ * Server side registry of character hitbox histories.
+ * Tests attack shapes against the hitboxes as they were at a past server time.
+ */
+UCLASS()
+class UUnrealTestLagCompensationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterHitbox(UUnrealTestHitboxHistoryComponent* Hitbox);
+	void UnregisterHitbox(UUnrealTestHitboxHistoryComponent* Hitbox);
+
+	/**
+	 * Sweeps a sphere from Start to End against every hitbox rewound to RewindTime.
+	 * @param IgnoreActor	Actor whose hitbox is skipped, usually the attacker
+	 * @return true if anything was hit, OutHit holds the closest hit
+	 */
+	bool SweepSphereRewound(const FVector& Start, const FVector& End, float Radius, double RewindTime, const AActor* IgnoreActor, FUnrealTestRewindHit& OutHit) const;
+
+	/**
+	 * Collects the hitboxes, rewound to RewindTime, whose capsule comes within Radius of Center.
+	 * Lets attacks testing many shapes in a row rewind each character once. Only the characters
+	 * the spatial hash finds around Center are rewound.
+	 * @param IgnoreActor	Actor whose hitbox is skipped, usually the attacker
+	 */
+	void GatherHitboxesRewound(const FVector& Center, float Radius, double RewindTime, const AActor* IgnoreActor, TArray<FUnrealTestRewoundHitbox, FUnrealTestFrameAllocator>& OutHitboxes) const;
+
+private:
+	TArray<TWeakObjectPtr<UUnrealTestHitboxHistoryComponent>> Hitboxes;
+
+	/** Furthest a capsule surface is from the character location */
+	const float MAX_CAPSULE_EXTENT = 100.f;
+
+	/** Furthest a character moves during the longest rewind */
+	const float MAX_REWIND_TRAVEL = 400.f;
+};
@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UnrealTestMeleeAttackComponent.generated.h"
+
+/**
+ * Server side melee swing of melee champions.
+ * The blade is a capsule from the owner's center out to its reach, swept horizontally across an arc
+ * around the aim over the swing duration. Every tick the part of the arc swept since the last tick is
+ * tested in steps against the hitboxes rewound to when the client swung: several targets can be hit
+ * by one swing, each of them once. Steps per tick are capped so a brawl can't blow the frame.
+ */
+UCLASS(config=Game, ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class UUnrealTestMeleeAttackComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestMeleeAttackComponent();
+
+	// UActorComponent interface
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// End of UActorComponent interface
+
+	/**
+	 * Starts a swing on the server.
+	 * @param AimDirection	Direction the swing is centered on
+	 * @param RewindSeconds	How far back the targets are rewound for the whole swing
+	 * @return false if a swing is already running
+	 */
+	bool StartSwing(const FVector& AimDirection, float RewindSeconds);
+
+	/** Stops the current swing, if any, e.g. on death or round reset */
+	void CancelSwing();
+
+	FORCEINLINE bool IsSwinging() const { return bSwinging; }
+
+	/** Duration of a swing */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee, meta = (ClampMin = "0.01"))
+	float SwingSeconds;
+
+	/** Horizontal angle swept by the blade, centered on the aim */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee, meta = (ClampMin = "0.0", ClampMax = "360.0"))
+	float SwingArcDegrees;
+
+	/** Distance from the owner's center to the tip of the blade */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee)
+	float Reach;
+
+	/** Radius of the blade capsule */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee)
+	float BladeRadius;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee)
+	float Damage;
+
+	/** Most targets one swing damages */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee, meta = (ClampMin = "1"))
+	int32 MaxTargetsPerSwing;
+
+	/** Most blade positions tested in one tick, long frames test the swept arc more coarsely */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Melee, meta = (ClampMin = "1"))
+	int32 MaxStepsPerTick;
+
+protected:
+	/** Tests the arc swept since the last tick and applies damage to what it touched */
+	void AdvanceSwing();
+
+	/** Blade yaw offset from the aim, in degrees, at the given swing progress */
+	float GetBladeAngle(float Progress) const;
+
+	void ApplyHit(AActor* Target, const FVector& BladeStart, const FVector& BladeEnd, const FVector& HitLocation);
+
+private:
+	FVector SwingDirection;
+	double SwingStartTime;
+	float SwingRewindSeconds;
+
+	/** Swing progress, from 0 to 1, tested so far. Negative until the first blade position is tested */
+	float SweptProgress;
+
+	bool bSwinging;
+
+	/** Targets already hit by this swing */
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<8>> HitActors;
+
+	const float SWING_SECONDS = 0.35f;
+	const float SWING_ARC_DEGREES = 120.f;
+	const float REACH = 170.f;
+	const float BLADE_RADIUS = 20.f;
+	const float DAMAGE = 40.f;
+	const int32 MAX_TARGETS_PER_SWING = 8;
+	const int32 MAX_STEPS_PER_TICK = 8;
+};
@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "UnrealTest/Game/UnrealTestPoolable.h"
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
+#include "UnrealTestProjectile.generated.h"
+
+/**
+ * Projectile fired by projectile champions.
+ * The server spawns the authoritative projectile and fast-forwards it by the shooter's latency
+ * against the rewound hitboxes. The shooting client spawns a predicted copy straight away
+ * and hands its visual position over to the authoritative one once it replicates.
+ * Both come from the actor pool, so firing never creates or destroys objects once the pools are warm.
+ */
+UCLASS(config=Game)
+class AUnrealTestProjectile : public AActor, public IUnrealTestPoolable
+{
+	GENERATED_BODY()
+
+	/** Collision sphere, root of the projectile */
+	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
+	class USphereComponent* CollisionComponent;
+
+	/** Attach meshes and effects here so they can be offset while reconciling with the prediction */
+	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
+	class USceneComponent* VisualRoot;
+
+	/** Moves the projectile once it has been fast-forwarded */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
+	class UProjectileMovementComponent* ProjectileMovement;
+
+public:
+	AUnrealTestProjectile();
+
+	// AActor interface
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// End of AActor interface
+
+	// IUnrealTestPoolable interface
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
+	// End of IUnrealTestPoolable interface
+
+	/**
+	 * Server only. Advances the projectile by Seconds in fixed sub-steps, testing each step
+	 * against the hitboxes rewound to the time the projectile would have been there.
+	 */
+	void FastForward(float Seconds);
+
+	/** Turns this projectile into a client side prediction that never applies damage */
+	void MarkAsPredicted();
+
+	FORCEINLINE bool IsPredicted() const { return bIsPredicted; }
+	FORCEINLINE bool IsPoolActive() const { return bPoolActive; }
+	FORCEINLINE uint32 GetProjectileId() const { return ProjectileId; }
+	FORCEINLINE void SetProjectileId(uint32 InProjectileId) { ProjectileId = InProjectileId; }
+
+	/** Damage applied to characters hit by this projectile */
+	UPROPERTY(EditDefaultsOnly, Category = Projectile)
+	float Damage;
+
+	/** Radius of the explosion on impact, 0 for projectiles that only damage what they hit */
+	UPROPERTY(EditDefaultsOnly, Category = Projectile)
+	float ExplosionRadius;
+
+	/** Damage dealt at the center of the explosion, falling off to nothing at its edge */
+	UPROPERTY(EditDefaultsOnly, Category = Projectile)
+	float ExplosionDamage;
+
+	/** Length of each fast-forward sub-step, in seconds */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Projectile)
+	float FastForwardStepSeconds;
+
+	/** Upper bound of the latency compensation, so high ping players can't shoot from the past */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Projectile)
+	float MaxFastForwardSeconds;
+
+	/** Time the authoritative projectile takes to blend from the predicted position to its own */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Projectile)
+	float ReconcileBlendSeconds;
+
+protected:
+	UFUNCTION()
+	void OnProjectileHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	/** Pawns overlap the projectile rather than block it, so shots can fly through capsules that only bound bone hitboxes */
+	UFUNCTION()
+	void OnProjectileOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	/**
+	 * Server only. Moves a capsule hit onto the bone hitboxes of the character as they are now, if it has any.
+	 * @return false when the shot misses every bone hitbox and keeps flying
+	 */
+	bool ResolveBoneHit(AActor* HitActor, FHitResult& InOutHit, float& OutDamageMultiplier) const;
+
+	/** Applies the damage of this projectile, scaled by the multiplier of the hitbox it hit, and removes it */
+	void HandleImpact(AActor* HitActor, const FHitResult& Hit, float DamageMultiplier = 1.f);
+
+	/** Damages the characters around the impact, except the one hit directly */
+	void Explode(const FVector& Location, const AActor* HitActor);
+
+	/** Takes over the predicted projectile fired by the local player, if any */
+	void ReconcileWithPrediction();
+
+	UFUNCTION()
+	void OnRep_PoolState();
+
+	/** Shows or hides the projectile to match its pool state */
+	void ApplyPoolState();
+
+	/** Gives the projectile back to the pool, or destroys it when there is no pool */
+	void Release();
+
+	bool SweepWorld(const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+private:
+	/** Matches the authoritative projectile with the prediction of the client that fired it */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+	uint32 ProjectileId;
+
+	/** False while sitting in the pool */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+	bool bPoolActive;
+
+	/** Bumped every time the pool hands the projectile out, so clients notice a reuse */
+	UPROPERTY(ReplicatedUsing = OnRep_PoolState)
+	uint8 ActivationCount;
+
+	/** Last activation the client matched against its prediction */
+	uint8 ReconciledActivation;
+
+	bool bIsPredicted;
+
+	/** Releases the projectile once it has flown for LIFE_SPAN */
+	FUnrealTestTimerHandle LifeTimerHandle;
+
+	/** Offset of the visuals towards where the prediction was, decays to zero */
+	FVector VisualOffset;
+	float VisualOffsetTimeRemaining;
+
+	const float DAMAGE = 20.f;
+	const float COLLISION_RADIUS = 8.f;
+	const float INITIAL_SPEED = 3000.f;
+	const float LIFE_SPAN = 3.f;
+	const float FAST_FORWARD_STEP_SECONDS = 1.f / 120.f;
+	const float MAX_FAST_FORWARD_SECONDS = 0.15f;
+	const float RECONCILE_BLEND_SECONDS = 0.1f;
+};
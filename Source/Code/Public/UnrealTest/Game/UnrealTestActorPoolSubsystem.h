@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTestActorPoolSubsystem.generated.h"
+
+/** Actors of one class handed out and taken back by the actor pool */
+USTRUCT()
+struct FUnrealTestActorPool
+{
+	GENERATED_BODY()
+
+	/** Released actors, hidden, without collision and dormant */
+	UPROPERTY()
+	TArray<AActor*> Free;
+
+	UPROPERTY()
+	TArray<AActor*> Active;
+
+	/** Most actors of the class active at once */
+	int32 HighWaterMark = 0;
+
+	/** Actors spawned because the pool was empty when one was needed */
+	int32 NumSpawnedOnDemand = 0;
+
+	/** Components of the free actors that were ticking when released, they tick again once handed out */
+	TMap<TWeakObjectPtr<AActor>, TArray<TWeakObjectPtr<UActorComponent>>> ParkedTickingComponents;
+};
+
+/** Actors of a class spawned into the pool when the world begins play */
+USTRUCT()
+struct FUnrealTestActorPoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSoftClassPtr<AActor> ActorClass;
+
+	UPROPERTY()
+	int32 Count = 0;
+};
+
+/**
+ * Pools of actors, one per class, so projectiles and other short-lived actors are reused instead of
+ * spawned and destroyed during a match, and never become garbage. Pooled actors stay replicated: released
+ * ones are hidden, lose their collision and go dormant, which keeps them on the clients that already have
+ * them and out of the relevancy of late joiners until they are handed out again.
+ * Clients pool the actors only they have, such as predicted projectiles, which never replicate.
+ * Actors implementing IUnrealTestPoolable get told when they are acquired and released.
+ */
+UCLASS(config=Game)
+class UUnrealTestActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// End of UWorldSubsystem interface
+
+	/**
+	 * Returns an active actor of the given class at Transform, reusing a released one when possible.
+	 * @return null if the pool was empty and spawning failed
+	 */
+	AActor* AcquireActor(UClass* ActorClass, const FTransform& Transform, AActor* ActorOwner, APawn* ActorInstigator);
+
+	template<typename T>
+	T* AcquireActor(TSubclassOf<T> ActorClass, const FTransform& Transform, AActor* ActorOwner, APawn* ActorInstigator)
+	{
+		return Cast<T>(AcquireActor(*ActorClass, Transform, ActorOwner, ActorInstigator));
+	}
+
+	/** Hands an active actor back to its pool, actors the pool doesn't know are ignored */
+	void ReleaseActor(AActor* Actor);
+
+	/** Releases every active actor of every pool, used between rounds */
+	void ReleaseAllActors();
+
+	/** Spawns Count more actors of the class into its pool, so the match never has to */
+	void Prewarm(UClass* ActorClass, int32 Count);
+
+	/** Logs the actors of every pool */
+	void DumpPools() const;
+
+	/** Pools filled when the world begins play, on top of what actors prewarm for themselves */
+	UPROPERTY(Config)
+	TArray<FUnrealTestActorPoolPrewarm> PrewarmPools;
+
+private:
+	/** Spawns a released actor into the pool of its class */
+	AActor* SpawnPooledActor(UClass* ActorClass, const FTransform& Transform);
+
+	/** Hides the actor, stops its ticks, puts it to sleep and adds it to the free list */
+	void Deactivate(AActor* Actor, FUnrealTestActorPool& Pool);
+
+	void UpdateStats() const;
+
+	UPROPERTY()
+	TMap<UClass*, FUnrealTestActorPool> Pools;
+};
@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Keeps count of the players alive in every team, updated as players spawn, die and leave,
+ * so knowing how many teams are still standing never needs a pass over the pawns.
+ * A player is only ever counted once, dying and disconnecting in the same frame decrements a single time.
+ */
+class FUnrealTestAliveTracker
+{
+public:
+	/** Teams are tracked in a bit mask, team ids from this one on are ignored */
+	static constexpr int32 MAX_TEAMS = 32;
+
+	/** Counts the player as alive in Team, moving it there if it was alive in another team */
+	void MarkAlive(FObjectKey Player, int32 Team);
+
+	/** Stops counting the player. Returns true if that eliminated its team */
+	bool MarkDead(FObjectKey Player);
+
+	void Reset();
+
+	bool IsAlive(FObjectKey Player) const;
+
+	FORCEINLINE int32 GetNumAliveTeams() const { return FMath::CountBits(AliveTeamMask); }
+
+	/** Team with players alive when it is the only one left, INDEX_NONE otherwise */
+	int32 GetLastTeamStanding() const;
+
+	FORCEINLINE int32 GetAliveCount(int32 Team) const { return Team >= 0 && Team < MAX_TEAMS ? AliveCounts[Team] : 0; }
+
+private:
+	TMap<FObjectKey, int32> AliveTeamOfPlayer;
+
+	int32 AliveCounts[MAX_TEAMS] = {};
+
+	/** Bit per team with at least one player alive */
+	uint32 AliveTeamMask = 0;
+};
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UnrealTestBakeVisibilityCommandlet.generated.h"
+
+/**
+ * Bakes the visibility grid of a map into the file the server maps when play begins.
+ * Run it again after moving player starts or level geometry:
+ * UnrealEditor-Cmd UnrealTest.uproject -run=UnrealTestBakeVisibility -Map=/Game/ThirdPerson/Maps/ThirdPersonMap [-CellSize=400] [-Margin=2000] [-EyeHeight=160]
+ */
+UCLASS()
+class UUnrealTestBakeVisibilityCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestBakeVisibilityCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End of UCommandlet interface
+
+	const float CELL_SIZE = 400.f;
+	const float MARGIN = 2000.f;
+	const float EYE_HEIGHT = 160.f;
+};
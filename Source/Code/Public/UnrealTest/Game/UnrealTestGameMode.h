@@ -4,15 +4,118 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "UnrealTest/Game/UnrealTestAliveTracker.h"
+#include "UnrealTest/Game/UnrealTestGameState.h"
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
 #include "UnrealTestGameMode.generated.h"
 
-UCLASS(minimalapi)
+class IUnrealTestRoundResettable;
+
+/**
+ * Runs matches back to back without reloading the map:
+ * WaitingForPlayers -> Warmup -> InProgress -> RoundEnd -> Warmup -> ...
+ * Entering warmup resets every registered actor in place and rebalances the teams.
+ * Garbage is collected between rounds and held back while they are in progress (UUnrealTestGarbageCollectionSubsystem).
+ */
+UCLASS(minimalapi, config=Game)
 class AUnrealTestGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
+	/** Keeps connected players split in balanced teams */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Matchmaking, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestMatchmakingComponent* Matchmaking;
+
+	/** Sends NPC waves into the arena during rounds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestWaveSpawnerComponent* WaveSpawner;
+
 public:
 	AUnrealTestGameMode();
+
+	// AGameModeBase interface
+	virtual void StartPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PostLogin(APlayerController* NewPlayer) override;
+	virtual void Logout(AController* Exiting) override;
+	virtual void FinishRestartPlayer(AController* NewPlayer, const FRotator& StartRotation) override;
+	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
+	virtual bool ShouldSpawnAtStartSpot_Implementation(AController* Player) override;
+	// End of AGameModeBase interface
+
+	/** Returns Matchmaking subobject **/
+	FORCEINLINE class UUnrealTestMatchmakingComponent* GetMatchmaking() const { return Matchmaking; }
+	/** Returns WaveSpawner subobject **/
+	FORCEINLINE class UUnrealTestWaveSpawnerComponent* GetWaveSpawner() const { return WaveSpawner; }
+
+	/** Adds an object implementing IUnrealTestRoundResettable to the objects reset between rounds */
+	void RegisterRoundResettable(UObject* Resettable);
+
+	/** Stops counting the player as alive, the round ends at the end of the frame if one team is left */
+	void NotifyPlayerDied(AController* Player);
+
+	/** Ends the round in progress, NO_TEAM meaning a draw */
+	void EndRound(int32 WinningTeam);
+
+	/** Puts every player pawn back on a start spot and resets pooled actors, without touching the map */
+	void ResetRound();
+
+	/** Starts the warmup if enough players are connected, otherwise waits for them */
+	void TryStartWarmup();
+
+	EUnrealTestMatchPhase GetMatchPhase() const;
+
+	/** Players needed before the warmup starts */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Match)
+	int32 MinPlayersToStart;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Match)
+	float WarmupSeconds;
+
+	/** Rounds still going after this long end in a draw */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Match)
+	float RoundTimeLimitSeconds;
+
+	/** Time the results are shown before the next warmup */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Match)
+	float RoundEndSeconds;
+
+protected:
+	void SetMatchPhase(EUnrealTestMatchPhase NewPhase, double Duration);
+	void OnPhaseTimeElapsed();
+
+	void StartRound();
+
+	AUnrealTestGameState* GetUnrealTestGameState() const;
+
+	/** Counts the alive players of every team from scratch, once teams are final for the round */
+	void RebuildAliveCounts();
+
+	/** Marks the player alive if it has a team and a living pawn */
+	void TrackAlivePlayer(AController* Player);
+
+	/**
+	 * Ends the round once every death and disconnect of the frame is in.
+	 * Teams eliminated in the same frame as the last other team make the round a draw.
+	 */
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	const int32 MIN_PLAYERS_TO_START = 2;
+	const float WARMUP_SECONDS = 5.f;
+	const float ROUND_TIME_LIMIT_SECONDS = 300.f;
+	const float ROUND_END_SECONDS = 5.f;
+
+private:
+	TArray<TWeakObjectPtr<UObject>> RoundResettables;
+
+	FUnrealTestTimerHandle PhaseTimerHandle;
+
+	FUnrealTestAliveTracker AliveTracker;
+
+	/** A team was eliminated this frame */
+	bool bVictoryCheckPending;
+
+	FDelegateHandle PostActorTickHandle;
 };
 
 
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "UnrealTest/Character/UnrealTestMovementSettings.h"
+#include "UnrealTestGameState.generated.h"
+
+/** Phases a match goes through, the server loops through them without reloading the map */
+UENUM(BlueprintType)
+enum class EUnrealTestMatchPhase : uint8
+{
+	WaitingForPlayers,
+	Warmup,
+	InProgress,
+	RoundEnd
+};
+
+UCLASS()
+class AUnrealTestGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	AUnrealTestGameState();
+
+	virtual void BeginPlay() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Server only. Moves to a new phase that lasts for Duration seconds, 0 meaning until told otherwise */
+	void SetMatchPhase(EUnrealTestMatchPhase NewPhase, double Duration);
+
+	FORCEINLINE EUnrealTestMatchPhase GetMatchPhase() const { return MatchPhase; }
+	FORCEINLINE double GetPhaseEndTime() const { return PhaseEndTime; }
+	FORCEINLINE int32 GetRoundNumber() const { return RoundNumber; }
+	FORCEINLINE int32 GetWinningTeam() const { return WinningTeam; }
+
+	void SetRoundNumber(int32 NewRoundNumber);
+	void SetWinningTeam(int32 NewWinningTeam);
+
+	/** Movement tuning of the champion as the server has it, so prediction matches on every client */
+	const FUnrealTestMovementTuning& GetMovementTuning(FName ChampionName) const;
+
+	/** Server only. Copies the movement settings into the replicated tunings and applies them to every character */
+	void RefreshMovementTunings();
+
+protected:
+	/** Applies the current tunings to every character of the world in one pass */
+	void ApplyMovementTunings();
+
+	UFUNCTION()
+	void OnRep_MovementTunings();
+
+	/** Lets the world schedule its garbage collection around the new phase */
+	UFUNCTION()
+	void OnRep_MatchPhase();
+
+	UPROPERTY(ReplicatedUsing = OnRep_MatchPhase, BlueprintReadOnly, Category = Match)
+	EUnrealTestMatchPhase MatchPhase;
+
+	/** Server world time the current phase ends at */
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = Match)
+	double PhaseEndTime;
+
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = Match)
+	int32 RoundNumber;
+
+	/** Team that won the last round */
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = Match)
+	int32 WinningTeam;
+
+	/** Movement tuning of every champion, the first entry being the default one */
+	UPROPERTY(ReplicatedUsing = OnRep_MovementTunings)
+	TArray<FUnrealTestChampionMovementTuning> MovementTunings;
+};
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UnrealTest/Game/UnrealTestTeamSolver.h"
+#include "UnrealTestMatchmakingComponent.generated.h"
+
+class AUnrealTestPlayerState;
+
+/**
+ * Game mode component that keeps every connected player in a team.
+ * Players joining are slotted in incrementally, a full rebalance happens when a match starts.
+ */
+UCLASS(config=Game, ClassGroup=(Game))
+class UUnrealTestMatchmakingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestMatchmakingComponent();
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of UActorComponent interface
+
+	/** Gives the player a team without moving anybody else */
+	void AddPlayer(AUnrealTestPlayerState* PlayerState);
+
+	void RemovePlayer(AUnrealTestPlayerState* PlayerState);
+
+	/** Solves balanced teams for every known player and pushes the result to their player states */
+	void RebalanceTeams();
+
+	float GetSkillRating(const AUnrealTestPlayerState* PlayerState) const;
+	void SetSkillRating(const AUnrealTestPlayerState* PlayerState, float Rating);
+
+	/**
+	 * Moves the skill rating of every player in a team, Elo style, by how unexpected the result was
+	 * against the average rating of the other teams, then saves the ratings.
+	 * @param WinningTeam	NO_TEAM for a draw
+	 */
+	void UpdateSkillRatings(int32 WinningTeam);
+
+	/** Writes the skill ratings to the local save slot */
+	void SaveSkillRatings();
+
+	FORCEINLINE const FUnrealTestTeamSolver& GetSolver() const { return Solver; }
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Matchmaking)
+	int32 MinTeamSize;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Matchmaking)
+	int32 MaxTeamSize;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Matchmaking)
+	int32 MaxTeams;
+
+	/** Rating given to players we have never seen before */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Matchmaking)
+	float DefaultSkillRating;
+
+	/** Most rating a player wins or loses in a round */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Matchmaking)
+	float SkillRatingKFactor;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Matchmaking)
+	FString SkillRatingSlotName;
+
+private:
+	void LoadSkillRatings();
+	FUnrealTestMatchmakingPlayer MakeMatchmakingPlayer(const AUnrealTestPlayerState* PlayerState) const;
+	void ApplyTeams();
+
+	FUnrealTestTeamSolver Solver;
+
+	UPROPERTY()
+	TArray<AUnrealTestPlayerState*> Players;
+
+	UPROPERTY()
+	class UUnrealTestSkillRatingSaveGame* SkillRatings;
+
+	const int32 MIN_TEAM_SIZE = 2;
+	const int32 MAX_TEAM_SIZE = 5;
+	const int32 MAX_TEAMS = 8;
+	const float DEFAULT_SKILL_RATING = 1000.f;
+	const float SKILL_RATING_K_FACTOR = 32.f;
+};
@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "UnrealTestPlayerState.generated.h"
+
+UCLASS()
+class AUnrealTestPlayerState : public APlayerState
+{
+	GENERATED_BODY()
+
+public:
+	AUnrealTestPlayerState();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	FORCEINLINE int32 GetTeamId() const { return TeamId; }
+	void SetTeamId(int32 NewTeamId);
+
+	/** Key the skill rating of this player is stored under */
+	FString GetSkillRatingKey() const;
+
+	static const int32 NO_TEAM = INDEX_NONE;
+
+protected:
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = Team)
+	int32 TeamId;
+};
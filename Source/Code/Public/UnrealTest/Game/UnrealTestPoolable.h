@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "UnrealTestPoolable.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UUnrealTestPoolable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors handed out by the actor pool. The pool places, shows, hides and wakes or puts the actor to
+ * net dormancy; these hooks reset everything else the actor does, so a reused actor is indistinguishable
+ * from a freshly spawned one, on the server and on clients.
+ */
+class IUnrealTestPoolable
+{
+	GENERATED_BODY()
+
+public:
+	/** Called where the actor has authority. It was taken from the pool, already placed and owned, and starts over as if just spawned */
+	virtual void OnAcquiredFromPool() = 0;
+
+	/** Called where the actor has authority. It goes back to the pool: stop movement, timers and effects, clear per-use state */
+	virtual void OnReleasedToPool() = 0;
+};
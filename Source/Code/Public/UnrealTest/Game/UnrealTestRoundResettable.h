@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "UnrealTestRoundResettable.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UUnrealTestRoundResettable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors and components that outlive a round. The game mode resets them in place
+ * between rounds instead of destroying and spawning them again.
+ */
+class IUnrealTestRoundResettable
+{
+	GENERATED_BODY()
+
+public:
+	/** Server only. Brings the object back to the state it had when the first round started */
+	virtual void ResetForNewRound() = 0;
+};
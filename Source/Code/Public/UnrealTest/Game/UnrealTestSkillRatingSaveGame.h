@@ -0,0 +1,18 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SaveGame.h"
+#include "UnrealTestSkillRatingSaveGame.generated.h"
+
+/** Skill ratings of the players that joined this host, stored locally */
+UCLASS()
+class UUnrealTestSkillRatingSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TMap<FString, float> Ratings;
+};
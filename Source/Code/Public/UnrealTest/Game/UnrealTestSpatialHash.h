@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform grid of points in the XY plane, hashed into a fixed number of buckets and rebuilt from scratch
+ * in linear time. Points are stored as structure of arrays sorted by bucket, every bucket padded to a
+ * multiple of 4 with points out of reach, so queries run the batch math culls over whole buckets.
+ * Plain C++, queries write the index the point had when built into buffers owned by the caller.
+ */
+class FUnrealTestSpatialHash
+{
+public:
+	explicit FUnrealTestSpatialHash(float InCellSize = 1000.f);
+
+	/** Takes effect on the next Build */
+	void SetCellSize(float InCellSize);
+
+	/** Replaces every point of the hash, reusing the memory of the previous build */
+	void Build(TArrayView<const FVector> Locations);
+
+	/**
+	 * Points within Radius of Center.
+	 * @return number of indices written to OutIndices, at most its size
+	 */
+	int32 QueryRadius(const FVector& Center, float Radius, TArrayView<int32> OutIndices) const;
+
+	/**
+	 * Points within Range of Origin and less than HalfAngleDegrees away from Direction.
+	 * @return number of indices written to OutIndices, at most its size
+	 */
+	int32 QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArrayView<int32> OutIndices) const;
+
+	/** Number of points in the last build */
+	FORCEINLINE int32 Num() const { return NumPoints; }
+
+	static const int32 NUM_BUCKETS = 1024;
+
+private:
+	/** Batch distance test of the points of a bucket range, writes the hits from OutIndices[NumFound] on */
+	template<bool bCone>
+	int32 TestRange(int32 Begin, int32 End, const FVector& Center, float Radius, const FVector& Direction, float CosAngle, TArrayView<int32> OutIndices, int32 NumFound) const;
+
+	/** Calls TestRange on every bucket touched by the square around Center */
+	template<bool bCone>
+	int32 Query(const FVector& Center, float Radius, const FVector& Direction, float CosAngle, TArrayView<int32> OutIndices) const;
+
+	FORCEINLINE uint32 GetBucket(int32 CellX, int32 CellY) const
+	{
+		return (uint32(CellX) * 73856093u ^ uint32(CellY) * 19349663u) & (NUM_BUCKETS - 1);
+	}
+
+	float CellSize;
+	float InvCellSize;
+	int32 NumPoints;
+
+	/** First slot of every bucket, the last entry is the total number of slots */
+	TArray<int32> BucketStarts;
+
+	// Slots sorted by bucket, 16 byte aligned so every bucket starts on a SIMD register
+	TArray<float, TAlignedHeapAllocator<16>> PositionsX;
+	TArray<float, TAlignedHeapAllocator<16>> PositionsY;
+	TArray<float, TAlignedHeapAllocator<16>> PositionsZ;
+
+	/** Index of the point in every slot, INDEX_NONE for padding */
+	TArray<int32> Indices;
+
+	// Scratch memory of Build
+	TArray<uint32> PointBuckets;
+	TArray<int32> BucketCursors;
+};
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Game/UnrealTestSpatialHash.h"
+#include "UnrealTestSpatialHashSubsystem.generated.h"
+
+/**
+ * Gameplay only broadphase of the characters and NPCs, rebuilt once per frame from where movement left them.
+ * Area of effect, cone and radius queries run against it instead of overlap queries on the physics scene.
+ * Queries return indices into the pawns of the last build, valid until the next one.
+ */
+UCLASS(config=Game)
+class UUnrealTestSpatialHashSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestSpatialHashSubsystem();
+
+	// UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End of UTickableWorldSubsystem interface
+
+	/** Adds the pawn from the next build on, dead characters unregister until they are revived */
+	void RegisterPawn(APawn* Pawn);
+	void UnregisterPawn(APawn* Pawn);
+
+	/** Pawns within Radius of Center. @return number of indices written to OutIndices */
+	int32 QueryRadius(const FVector& Center, float Radius, TArrayView<int32> OutIndices) const;
+
+	/** Pawns within Range of Origin and HalfAngleDegrees of Direction. @return number of indices written to OutIndices */
+	int32 QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArrayView<int32> OutIndices) const;
+
+	/** Number of pawns in the last build */
+	FORCEINLINE int32 GetNumPawns() const { return Pawns.Num(); }
+
+	/** Pawn of a query result, null if it was destroyed since the build */
+	FORCEINLINE APawn* GetPawn(int32 Index) const { return Pawns[Index].Get(); }
+
+	/** Location of the pawn when the hash was built */
+	FORCEINLINE const FVector& GetLocation(int32 Index) const { return Locations[Index]; }
+
+	/** Team of the pawn when the hash was built, NO_TEAM for NPCs */
+	FORCEINLINE int32 GetTeam(int32 Index) const { return Teams[Index]; }
+
+	/** Size of the hash cells, around the radius of the most common queries */
+	UPROPERTY(Config)
+	float CellSize;
+
+	const float CELL_SIZE = 1000.f;
+
+private:
+	TArray<TWeakObjectPtr<APawn>> RegisteredPawns;
+
+	// State of the last build, indexed by the indices queries return
+	TArray<TWeakObjectPtr<APawn>> Pawns;
+	TArray<FVector> Locations;
+	TArray<int32> Teams;
+
+	FUnrealTestSpatialHash Hash;
+};
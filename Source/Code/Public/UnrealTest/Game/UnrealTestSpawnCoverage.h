@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealTestSpawnCoverage.generated.h"
+
+class APlayerStart;
+struct FUnrealTestVisibilityGrid;
+
+/**
+ * Which parts of the arena can see each spawn point.
+ * The arena is cut in a 2D grid of cells around the spawn points, and every spawn point keeps a bit per cell
+ * with a line of sight from the spawn point's eye height. Baked offline, so the runtime only tests bits.
+ */
+USTRUCT()
+struct FUnrealTestSpawnCoverage
+{
+	GENERATED_BODY()
+
+	/** Checks the line of sight from every spawn point to every cell through UUnrealTestVisibilitySubsystem. Slow, meant to run in the editor */
+	void Bake(UWorld* World, float InCellSize, float Margin, float EyeHeight);
+
+	/** Takes the rows of the cells the spawn points stand in from the visibility grid, false if one stands outside of it */
+	bool CopyFromVisibilityGrid(UWorld* World, const FUnrealTestVisibilityGrid& Grid);
+
+	/** Cell containing the location, INDEX_NONE outside the grid */
+	int32 GetCell(const FVector& Location) const;
+
+	FORCEINLINE bool IsCellVisible(int32 SpawnIndex, int32 Cell) const
+	{
+		return (VisibilityBits[SpawnIndex * WordsPerSpawn + (Cell >> 6)] & (uint64(1) << (Cell & 63))) != 0;
+	}
+
+	FORCEINLINE int32 GetNumCells() const { return GridSizeX * GridSizeY; }
+	FORCEINLINE bool IsBaked() const { return SpawnPoints.Num() > 0; }
+
+	/** Cells per side the grid is limited to, so a spawn point never needs more than 512 bytes */
+	static constexpr int32 MAX_GRID_SIZE = 64;
+
+	UPROPERTY()
+	TArray<APlayerStart*> SpawnPoints;
+
+	/** Bits of every spawn point, WordsPerSpawn words each */
+	UPROPERTY()
+	TArray<uint64> VisibilityBits;
+
+	/** Number of cells each spawn point sees, how exposed it is */
+	UPROPERTY()
+	TArray<int32> VisibleCellCounts;
+
+	UPROPERTY()
+	FVector2D GridOrigin = FVector2D::ZeroVector;
+
+	UPROPERTY()
+	float CellSize = 0.f;
+
+	UPROPERTY()
+	int32 GridSizeX = 0;
+
+	UPROPERTY()
+	int32 GridSizeY = 0;
+
+	UPROPERTY()
+	int32 WordsPerSpawn = 0;
+};
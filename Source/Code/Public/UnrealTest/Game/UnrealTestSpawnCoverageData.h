@@ -0,0 +1,44 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "UnrealTest/Game/UnrealTestSpawnCoverage.h"
+#include "UnrealTestSpawnCoverageData.generated.h"
+
+/**
+ * Holds the spawn coverage baked for the level it is placed in.
+ * Press Bake after moving player starts or level geometry. Levels without one are baked when play begins.
+ */
+UCLASS()
+class AUnrealTestSpawnCoverageData : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AUnrealTestSpawnCoverageData();
+
+	/** Traces the visibility of every player start of the level */
+	UFUNCTION(CallInEditor, Category = SpawnCoverage)
+	void Bake();
+
+	/** Requested size of the grid cells, cells grow when the arena doesn't fit in the grid */
+	UPROPERTY(EditAnywhere, Category = SpawnCoverage)
+	float CellSize;
+
+	/** Extra space covered around the player starts */
+	UPROPERTY(EditAnywhere, Category = SpawnCoverage)
+	float Margin;
+
+	/** Height above the player start the lines of sight are traced from */
+	UPROPERTY(EditAnywhere, Category = SpawnCoverage)
+	float EyeHeight;
+
+	UPROPERTY(VisibleAnywhere, Category = SpawnCoverage)
+	FUnrealTestSpawnCoverage Coverage;
+
+	const float CELL_SIZE = 800.f;
+	const float MARGIN = 2000.f;
+	const float EYE_HEIGHT = 160.f;
+};
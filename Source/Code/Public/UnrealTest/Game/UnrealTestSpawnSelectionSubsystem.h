@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Game/UnrealTestSpawnCoverage.h"
+#include "UnrealTestSpawnSelectionSubsystem.generated.h"
+
+/**
+ * Server side choice of where players spawn, away from the sight and reach of their enemies.
+ * Spawn points are scored against the enemy positions of the frame with the baked coverage bits,
+ * so a choice costs a few bit tests per enemy and spawn point, however many players respawn at once.
+ */
+UCLASS(config=Game)
+class UUnrealTestSpawnSelectionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestSpawnSelectionSubsystem();
+
+	// UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// End of UWorldSubsystem interface
+
+	/** Best spawn point for the player, or for an NPC when null. Null when the level has no coverage */
+	AActor* ChooseSpawnPoint(AController* Player);
+
+	/** Score lost for every enemy in a cell that can see the spawn point */
+	UPROPERTY(Config)
+	float VisibleEnemyPenalty;
+
+	/** Enemies closer than this lower the score the closer they are */
+	UPROPERTY(Config)
+	float NearEnemyDistance;
+
+	/** Score lost for an enemy standing on the spawn point */
+	UPROPERTY(Config)
+	float NearEnemyPenalty;
+
+	/** Score lost by a spawn point seeing the whole grid, spawn points hidden from most of the arena are preferred */
+	UPROPERTY(Config)
+	float ExposurePenalty;
+
+	/** Spawn points used this recently are avoided so players spawning together don't stack */
+	UPROPERTY(Config)
+	float RecentUseSeconds;
+
+	UPROPERTY(Config)
+	float RecentUsePenalty;
+
+	const float VISIBLE_ENEMY_PENALTY = 10.f;
+	const float NEAR_ENEMY_DISTANCE = 3000.f;
+	const float NEAR_ENEMY_PENALTY = 8.f;
+	const float EXPOSURE_PENALTY = 2.f;
+	const float RECENT_USE_SECONDS = 3.f;
+	const float RECENT_USE_PENALTY = 20.f;
+
+protected:
+	/** Gathers the pawns of the spatial hash with their cell and team, once per frame however many players spawn */
+	void UpdateEnemyGrid();
+
+	float ScoreSpawnPoint(int32 SpawnIndex, int32 Team, const APawn* Ignored) const;
+
+private:
+	UPROPERTY()
+	FUnrealTestSpawnCoverage Coverage;
+
+	/** World time every spawn point was last chosen at */
+	TArray<float> LastUseTimes;
+
+	// Pawns of the frame, as parallel arrays
+	TArray<FVector> PawnLocations;
+	TArray<int32> PawnCells;
+	TArray<int32> PawnTeams;
+	TArray<const APawn*> Pawns;
+
+	uint64 EnemyGridFrame;
+};
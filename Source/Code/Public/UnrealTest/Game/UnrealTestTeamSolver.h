@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Player entry handed to the team solver */
+struct FUnrealTestMatchmakingPlayer
+{
+	int32 PlayerId = INDEX_NONE;
+	float Skill = 0.f;
+};
+
+/** Limits the team solver works with */
+struct FUnrealTestTeamSolverSettings
+{
+	/** Teams are created so each has at least this many players when there are enough of them */
+	int32 MinTeamSize = 2;
+
+	/** Teams grow up to this size before a new team gets opened */
+	int32 MaxTeamSize = 5;
+
+	int32 MaxTeams = 8;
+
+	/** Swap passes run after the greedy assignment to even out team skill */
+	int32 MaxRefinementPasses = 8;
+};
+
+/**
+ * Splits players into skill balanced teams.
+ * Plain C++ so it can be used and tested without a world, e.g. from a lobby server.
+ */
+class FUnrealTestTeamSolver
+{
+public:
+	explicit FUnrealTestTeamSolver(const FUnrealTestTeamSolverSettings& InSettings = FUnrealTestTeamSolverSettings());
+
+	/**
+	 * Builds teams from scratch: players sorted by skill are greedily given to the weakest team
+	 * with room left, then pairs of players are swapped between the strongest and weakest teams.
+	 */
+	void Solve(TArrayView<const FUnrealTestMatchmakingPlayer> Players);
+
+	/** Puts a player in the smallest, then weakest, team without touching anybody else. Returns the team */
+	int32 AddPlayer(const FUnrealTestMatchmakingPlayer& Player);
+
+	void RemovePlayer(int32 PlayerId);
+
+	void Reset();
+
+	/** Returns the team of the player or INDEX_NONE if it isn't known */
+	int32 GetTeamOf(int32 PlayerId) const;
+
+	FORCEINLINE int32 GetNumTeams() const { return Teams.Num(); }
+	FORCEINLINE int32 GetNumPlayers() const { return PlayerToTeam.Num(); }
+	FORCEINLINE int32 GetTeamSize(int32 TeamIndex) const { return Teams[TeamIndex].Members.Num(); }
+	FORCEINLINE float GetTeamSkill(int32 TeamIndex) const { return Teams[TeamIndex].TotalSkill; }
+
+	/** Difference between the strongest and the weakest team total skill */
+	float GetSkillSpread() const;
+
+	/** Number of teams the solver would use for the given amount of players */
+	int32 ComputeNumTeams(int32 NumPlayers) const;
+
+private:
+	struct FTeam
+	{
+		float TotalSkill = 0.f;
+		TArray<FUnrealTestMatchmakingPlayer> Members;
+	};
+
+	/** Swaps the pair of players that brings the two teams closest, returns false when nothing helps */
+	bool RefineTeams(int32 StrongTeam, int32 WeakTeam);
+
+	FUnrealTestTeamSolverSettings Settings;
+	TArray<FTeam> Teams;
+	TMap<int32, int32> PlayerToTeam;
+};
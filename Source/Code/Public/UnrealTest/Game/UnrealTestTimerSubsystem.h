@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
+#include "UnrealTestTimerSubsystem.generated.h"
+
+/**
+ * Shared scheduler for gameplay timers: match phases, status effects, ability cooldowns and waves.
+ * Everything goes through one hierarchical timing wheel advanced once per frame on the world's game time,
+ * instead of a timer manager entry or a tick per actor.
+ */
+UCLASS()
+class UUnrealTestTimerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// UTickableWorldSubsystem interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End of UTickableWorldSubsystem interface
+
+	/** Calls Callback once, Delay seconds from now. Precision is one frame at 60 Hz */
+	FUnrealTestTimerHandle Schedule(float Delay, FSimpleDelegate&& Callback);
+
+	/** Cancels the timer if it is still pending and invalidates the handle */
+	void Cancel(FUnrealTestTimerHandle& Handle);
+
+	bool IsPending(const FUnrealTestTimerHandle& Handle) const;
+
+	/** Seconds until the timer fires, 0 if it isn't pending */
+	float GetRemaining(const FUnrealTestTimerHandle& Handle) const;
+
+private:
+	FUnrealTestTimingWheel Timers;
+};
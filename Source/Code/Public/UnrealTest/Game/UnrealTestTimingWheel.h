@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Identifies a timer scheduled on a FUnrealTestTimingWheel, stale once the timer fires or is cancelled */
+struct FUnrealTestTimerHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+	FORCEINLINE void Invalidate() { Index = INDEX_NONE; }
+};
+
+/**
+ * Hierarchical timing wheel for gameplay timers that don't need sub frame precision.
+ * The first level has a slot per tick of SlotSeconds, each further level covers the whole level below
+ * with every slot, and timers move down a level as their time gets closer. Scheduling and cancelling
+ * are O(1), advancing only visits the slots that elapsed, and due timers are called in one batch.
+ * Timer nodes are recycled, so a warm wheel never allocates.
+ */
+class FUnrealTestTimingWheel
+{
+public:
+	explicit FUnrealTestTimingWheel(float InSlotSeconds = 1.f / 60.f);
+
+	/** Calls Callback once, Delay seconds after the wheel's current time, rounded up to the next tick */
+	FUnrealTestTimerHandle Schedule(float Delay, FSimpleDelegate&& Callback);
+
+	/** Cancels the timer if it is still pending and invalidates the handle */
+	void Cancel(FUnrealTestTimerHandle& Handle);
+
+	bool IsPending(const FUnrealTestTimerHandle& Handle) const;
+
+	/** Seconds until the timer fires, 0 if it isn't pending */
+	float GetRemaining(const FUnrealTestTimerHandle& Handle) const;
+
+	/** Moves the wheel to Time, in seconds, and calls every timer that came due */
+	void Advance(double Time);
+
+	/** Drops every pending timer without calling it */
+	void Reset();
+
+	FORCEINLINE int32 GetNumPending() const { return NumPending; }
+
+	/** Longest delay a timer can have, longer ones are clamped to it */
+	double GetMaxDelay() const;
+
+private:
+	struct FNode
+	{
+		FSimpleDelegate Callback;
+		uint64 DueTick = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		int32 Slot = INDEX_NONE;
+		uint32 Serial = 0;
+	};
+
+	/** Puts the node in the slot matching how far away it is due */
+	void Link(int32 NodeIndex);
+	void Unlink(int32 NodeIndex);
+	void Free(int32 NodeIndex);
+
+	/** Moves every node of a slot of an upper level down to the levels below */
+	void Cascade(int32 Slot);
+
+	static constexpr int32 FIRST_LEVEL_BITS = 8;
+	static constexpr int32 LEVEL_BITS = 6;
+	static constexpr int32 NUM_LEVELS = 4;
+	static constexpr int32 FIRST_LEVEL_SLOTS = 1 << FIRST_LEVEL_BITS;
+	static constexpr int32 LEVEL_SLOTS = 1 << LEVEL_BITS;
+	static constexpr int32 NUM_SLOTS = FIRST_LEVEL_SLOTS + (NUM_LEVELS - 1) * LEVEL_SLOTS;
+	static constexpr uint64 MAX_DELAY_TICKS = (uint64(1) << (FIRST_LEVEL_BITS + (NUM_LEVELS - 1) * LEVEL_BITS)) - 1;
+
+	const double SlotSeconds;
+
+	TArray<FNode> Nodes;
+	int32 SlotHeads[NUM_SLOTS];
+
+	/** Timers that came due during the current Advance, called once every slot has been collected */
+	TArray<FUnrealTestTimerHandle> DueTimers;
+
+	int32 FreeHead;
+	int32 NumPending;
+	uint64 CurrentTick;
+};
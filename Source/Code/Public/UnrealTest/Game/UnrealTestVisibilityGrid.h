@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+
+/** Start of a baked visibility grid file, followed by the eye height of every cell and the visibility bits of every cell */
+struct FUnrealTestVisibilityGridHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	float OriginX;
+	float OriginY;
+	float CellSize;
+	float EyeHeight;
+	int32 GridSizeX;
+	int32 GridSizeY;
+	int32 WordsPerCell;
+	uint32 Padding[3];
+
+	static constexpr uint32 MAGIC = 0x47565455; // "UTVG"
+	static constexpr uint32 VERSION = 1;
+};
+
+static_assert(sizeof(FUnrealTestVisibilityGridHeader) % 16 == 0, "The visibility bits have to stay aligned in the mapped file");
+
+/**
+ * Which cells of the arena can see each other.
+ * The arena is cut in a 2D grid of cells around the player starts, each with an eye point at EyeHeight above its floor,
+ * and every cell keeps a bit per cell with a line of sight between their eye points.
+ * Baked offline by the UnrealTestBakeVisibility commandlet into a file laid out exactly like the memory the runtime reads,
+ * so loading it maps the file instead of parsing it, and a line of sight check is a single bit test.
+ * The bits are coarse: two characters in cells that see each other may still be hidden from each other.
+ */
+struct FUnrealTestVisibilityGrid
+{
+	/** Traces between the eye points of every pair of cells. Slow, meant for the bake commandlet */
+	void Bake(UWorld* World, float InCellSize, float Margin, float InEyeHeight);
+
+	/** Writes the grid as it is in memory */
+	bool Save(const FString& Filename) const;
+
+	/** Maps the file, or reads it where files can't be mapped, such as from a pak file */
+	bool Load(const FString& Filename);
+
+	void Reset();
+
+	/** Cell under the location, INDEX_NONE outside the grid or over a cell without a floor */
+	int32 GetCell(const FVector& Location) const;
+
+	FORCEINLINE bool IsCellVisible(int32 FromCell, int32 ToCell) const
+	{
+		return (Bits[FromCell * Header->WordsPerCell + (ToCell >> 6)] & (uint64(1) << (ToCell & 63))) != 0;
+	}
+
+	FORCEINLINE bool IsLoaded() const { return Header != nullptr; }
+	FORCEINLINE bool IsMapped() const { return MappedRegion.IsValid(); }
+	FORCEINLINE int32 GetNumCells() const { return Header ? Header->GridSizeX * Header->GridSizeY : 0; }
+	FORCEINLINE int32 GetGridSizeX() const { return Header ? Header->GridSizeX : 0; }
+	FORCEINLINE int32 GetGridSizeY() const { return Header ? Header->GridSizeY : 0; }
+	FORCEINLINE float GetCellSize() const { return Header ? Header->CellSize : 0.f; }
+	FORCEINLINE float GetEyeHeight() const { return Header ? Header->EyeHeight : 0.f; }
+	FORCEINLINE FVector2D GetOrigin() const { return Header ? FVector2D(Header->OriginX, Header->OriginY) : FVector2D::ZeroVector; }
+	FORCEINLINE int64 GetDataSize() const { return DataSize; }
+
+	/** Baked file of the map, in the project content so it can be staged loose, outside of the pak file */
+	static FString GetFilename(const FString& MapName);
+
+	/** Cells per side the grid is limited to, so the bits of the whole grid stay within 2 MB */
+	static constexpr int32 MAX_GRID_SIZE = 64;
+
+	/** Eye height of the cells without a floor, whose bits are all clear */
+	static constexpr float NO_FLOOR = -MAX_flt;
+
+private:
+	/** Points the grid at data laid out like the file, false if it isn't a valid grid */
+	bool Bind(const uint8* Data, int64 Size);
+
+	static int64 GetBitsOffset(int32 NumCells);
+
+	const FUnrealTestVisibilityGridHeader* Header = nullptr;
+	const float* EyeHeights = nullptr;
+	const uint64* Bits = nullptr;
+	int64 DataSize = 0;
+
+	/** Baked or read data, unused when the file is mapped */
+	TArray<uint8> Storage;
+
+	// The region has to go before the file it maps
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+};
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Game/UnrealTestVisibilityGrid.h"
+#include "UnrealTestVisibilitySubsystem.generated.h"
+
+/**
+ * Server side line of sight queries answered from the visibility grid baked for the map.
+ * Far apart points are a bit test. Points closer than CloseRangeDistance, where a cell is too coarse to tell,
+ * and points outside the grid, fall back to a trace. Maps without a baked grid always trace.
+ */
+UCLASS(config=Game)
+class UUnrealTestVisibilitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestVisibilitySubsystem();
+
+	// UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// End of UWorldSubsystem interface
+
+	/** Maps the grid baked for the world, once. Other subsystems needing it when play begins call it first */
+	void LoadGrid();
+
+	/** Whether a character standing at From could see To */
+	bool HasLineOfSight(const FVector& From, const FVector& To, const AActor* IgnoredActor = nullptr) const;
+
+	/** Bit test only, true when the grid can't tell. For scoring many pairs, where a wrong guess only costs priority */
+	bool IsPotentiallyVisible(const FVector& From, const FVector& To) const;
+
+	FORCEINLINE const FUnrealTestVisibilityGrid& GetGrid() const { return Grid; }
+
+	/** Points closer than this are traced, the bits only describe cell centers */
+	UPROPERTY(Config)
+	float CloseRangeDistance;
+
+	const float CLOSE_RANGE_DISTANCE = 1000.f;
+
+private:
+	FUnrealTestVisibilityGrid Grid;
+
+	bool bGridLoadAttempted;
+};
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UnrealTest/Game/UnrealTestRoundResettable.h"
+#include "UnrealTest/Game/UnrealTestTimingWheel.h"
+#include "UnrealTestWaveSpawnerComponent.generated.h"
+
+/**
+ * Game mode component sending waves of AI controlled NPCs into the arena while a round is in progress.
+ * Waves are scheduled on the gameplay timers. NPCs come from the actor pool and go back to it with the round reset,
+ * their AI controllers are kept aside and possess the NPCs handed out by the next waves.
+ */
+UCLASS(config=Game, ClassGroup=(Game))
+class UUnrealTestWaveSpawnerComponent : public UActorComponent, public IUnrealTestRoundResettable
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestWaveSpawnerComponent();
+
+	// UActorComponent interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of UActorComponent interface
+
+	// IUnrealTestRoundResettable interface
+	virtual void ResetForNewRound() override;
+	// End of IUnrealTestRoundResettable interface
+
+	/** Schedules the first wave, the following ones chain from it */
+	void StartWaves();
+
+	/** Cancels the next wave, NPCs already spawned stay until the round reset */
+	void StopWaves();
+
+	/** NPC sent by the waves, possessed by its AI controller class. No waves without one */
+	UPROPERTY(EditDefaultsOnly, Category = Waves)
+	TSubclassOf<APawn> NpcClass;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Waves)
+	float FirstWaveDelaySeconds;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Waves)
+	float WaveIntervalSeconds;
+
+	UPROPERTY(Config, EditDefaultsOnly, Category = Waves)
+	int32 NpcsPerWave;
+
+	/** Waves stop adding NPCs while this many are still alive */
+	UPROPERTY(Config, EditDefaultsOnly, Category = Waves)
+	int32 MaxAliveNpcs;
+
+protected:
+	void SpawnWave();
+
+	/** NPCs of the round still standing, dead ones are only released with the round reset */
+	int32 GetNumAliveNpcs() const;
+
+	/** Takes dead NPCs out of the spatial hash, whatever their pawn class does on death */
+	void HandleNpcDeath(class UUnrealTestHealthComponent* DeadHealth, AController* Killer);
+
+	const float FIRST_WAVE_DELAY_SECONDS = 10.f;
+	const float WAVE_INTERVAL_SECONDS = 20.f;
+	const int32 NPCS_PER_WAVE = 4;
+	const int32 MAX_ALIVE_NPCS = 32;
+
+private:
+	TArray<TWeakObjectPtr<APawn>> SpawnedNpcs;
+
+	/** AI controllers of the NPCs released by the last round reset */
+	TArray<TWeakObjectPtr<AController>> IdleControllers;
+
+	/** Player starts of the map, gathered the first time a wave spawns. Picked at random when spawn selection has no coverage */
+	TArray<TWeakObjectPtr<AActor>> SpawnPoints;
+
+	FUnrealTestTimerHandle WaveTimerHandle;
+};
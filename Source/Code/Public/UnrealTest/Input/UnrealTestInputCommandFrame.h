@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Input of the local player for one frame, whatever device it came from.
+ * Keyboard, mouse, gamepad and touch each fill one in, they are merged and the character applies the result once.
+ */
+struct FUnrealTestInputCommandFrame
+{
+	/** Movement relative to the controller yaw, X forward and Y right */
+	FVector2D Move = FVector2D::ZeroVector;
+
+	/** Yaw (X) and pitch (Y) input, in the units of AddControllerYawInput and AddControllerPitchInput */
+	FVector2D Look = FVector2D::ZeroVector;
+
+	/** Platform time the fire input was delivered at, as returned by FPlatformTime::Seconds */
+	double FirePlatformTime = 0.0;
+
+	bool bFire = false;
+
+	/** Whether jump is held, the character jumps when this goes up */
+	bool bJump = false;
+
+	/** Adds the input another device produced this frame */
+	void Merge(const FUnrealTestInputCommandFrame& Other)
+	{
+		Move = (Move + Other.Move).GetClampedToMaxSize(1.f);
+		Look += Other.Look;
+		if (Other.bFire && (!bFire || Other.FirePlatformTime < FirePlatformTime))
+		{
+			FirePlatformTime = Other.FirePlatformTime;
+		}
+		bFire |= Other.bFire;
+		bJump |= Other.bJump;
+	}
+};
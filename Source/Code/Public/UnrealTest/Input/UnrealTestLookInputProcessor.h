@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealTestLookInputProcessor.generated.h"
+
+/** Tuning of the gamepad look stick */
+USTRUCT(BlueprintType)
+struct FUnrealTestLookInputSettings
+{
+	GENERATED_BODY()
+
+	/** Stick deflection below which the stick reads as centered */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float InnerDeadZone = 0.15f;
+
+	/** Stick deflection above which the stick reads as fully deflected */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float OuterDeadZone = 0.95f;
+
+	/** Exponent of the response curve, 1 is linear, higher gives finer control near the center */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.1"))
+	float ResponseExponent = 2.f;
+
+	/** Deflection the stick has to be held above to start accelerating */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AccelerationThreshold = 0.9f;
+
+	/** Seconds at full deflection before acceleration kicks in */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0"))
+	float AccelerationDelay = 0.15f;
+
+	/** Seconds it takes the acceleration to reach its maximum */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0"))
+	float AccelerationRampTime = 0.3f;
+
+	/** Turn rate multiplier once fully accelerated */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "1.0"))
+	float MaxAccelerationMultiplier = 2.f;
+
+	/** Fixed step the look rate is integrated with, independent of the frame rate */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0001"))
+	float IntegrationStepSeconds = 1.f / 480.f;
+
+	/** Longest frame integrated, so hitches don't turn into big camera jumps */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0"))
+	float MaxFrameSeconds = 0.1f;
+};
+
+/**
+ * Turns raw look stick samples into yaw and pitch input.
+ * The stick is interpolated between frame samples and integrated with a fixed step, carrying
+ * the leftover time to the next frame, so the same stick motion gives the same aim trajectory
+ * whatever the frame rate. Plain C++ and deterministic so it can be driven with synthetic input.
+ */
+struct FUnrealTestLookInputProcessor
+{
+	/**
+	 * Advances the processor by one frame.
+	 * @param Stick			Raw stick sample this frame, X feeds yaw and Y feeds pitch
+	 * @param DeltaSeconds	Frame time
+	 * @param TurnRate		Look rate at full deflection without acceleration, per second
+	 * @return Yaw (X) and pitch (Y) input to add this frame
+	 */
+	FVector2D Process(const FUnrealTestLookInputSettings& Settings, const FVector2D& Stick, float DeltaSeconds, float TurnRate);
+
+	void Reset();
+
+	/** Stick after dead zones and response curve */
+	static FVector2D ApplyResponse(const FUnrealTestLookInputSettings& Settings, const FVector2D& Stick);
+
+private:
+	float GetAccelerationMultiplier(const FUnrealTestLookInputSettings& Settings) const;
+
+	FVector2D PreviousStick = FVector2D::ZeroVector;
+
+	/** Frame time not integrated yet, always below one step */
+	float PendingSeconds = 0.f;
+
+	/** Time the stick has been held above the acceleration threshold */
+	float AccelerationHoldSeconds = 0.f;
+};
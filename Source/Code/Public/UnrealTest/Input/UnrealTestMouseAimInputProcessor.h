@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_SERVER
+#include "Framework/Application/IInputProcessor.h"
+
+/**
+ * Slate input preprocessor that sees every raw mouse move and click in the order the OS delivered them.
+ * High polling rate mice send many moves per frame: the processor remembers how much of this frame's
+ * motion happened before the attack click, so the attack can use the aim at the moment of the click
+ * instead of the one at the end of the frame. Never consumes events.
+ */
+class FUnrealTestMouseAimInputProcessor : public IInputProcessor
+{
+public:
+	// IInputProcessor interface
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override;
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual const TCHAR* GetDebugName() const override { return TEXT("UnrealTestMouseAim"); }
+	// End of IInputProcessor interface
+
+	/** Starts accumulating a new frame of mouse motion */
+	void BeginFrame();
+
+	/** Raw mouse motion received since BeginFrame */
+	FORCEINLINE const FVector2D& GetFrameDelta() const { return FrameDelta; }
+
+	/** True if the attack button was clicked since BeginFrame */
+	FORCEINLINE bool HasClick() const { return bHasClick; }
+
+	/** Raw mouse motion received before the first click of the frame */
+	FORCEINLINE const FVector2D& GetDeltaBeforeClick() const { return DeltaBeforeClick; }
+
+	/** Platform time the first click of the frame was handled at, in seconds */
+	FORCEINLINE double GetClickTimestamp() const { return ClickTimestamp; }
+
+	/** Number of raw mouse moves received since BeginFrame */
+	FORCEINLINE int32 GetNumFrameSamples() const { return NumFrameSamples; }
+
+private:
+	FVector2D FrameDelta = FVector2D::ZeroVector;
+	FVector2D DeltaBeforeClick = FVector2D::ZeroVector;
+	double ClickTimestamp = 0.0;
+	int32 NumFrameSamples = 0;
+	bool bHasClick = false;
+};
+#endif
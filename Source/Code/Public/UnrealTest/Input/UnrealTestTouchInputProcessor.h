@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealTest/Input/UnrealTestInputCommandFrame.h"
+#include "UnrealTest/Input/UnrealTestTouchInputSettings.h"
+
+#if !UE_SERVER
+#include "Framework/Application/IInputProcessor.h"
+#include "InputCoreTypes.h"
+#include "Tasks/Task.h"
+
+/**
+ * Slate input preprocessor turning raw touches into twin-stick commands.
+ * Touch events are only appended to a queue as Slate delivers them. Once input is done for the frame
+ * the batch is handed to a worker task that classifies gestures (move stick, aim drag, taps), and the
+ * player controller collects the resulting command when it processes input. Never consumes events.
+ */
+class FUnrealTestTouchInputProcessor : public IInputProcessor
+{
+public:
+	explicit FUnrealTestTouchInputProcessor(const FUnrealTestTouchInputSettings& InSettings);
+	virtual ~FUnrealTestTouchInputProcessor();
+
+	// IInputProcessor interface
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override;
+	virtual bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual bool HandleMouseButtonUpEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual const TCHAR* GetDebugName() const override { return TEXT("UnrealTestTouch"); }
+	// End of IInputProcessor interface
+
+	/** Size of the game viewport in pixels, used from the next batch on */
+	void SetViewportSize(const FVector2D& InViewportSize);
+
+	/** Waits for the batch in flight, if any, and returns the command touches produced since the last call */
+	FUnrealTestInputCommandFrame ConsumeCommand();
+
+private:
+	enum class ETouchEventType : uint8
+	{
+		Down,
+		Move,
+		Up
+	};
+
+	struct FTouchEvent
+	{
+		FVector2D Position;
+		double PlatformTime;
+		uint32 PointerIndex;
+		ETouchEventType Type;
+	};
+
+	struct FFinger
+	{
+		FVector2D Start = FVector2D::ZeroVector;
+		FVector2D Last = FVector2D::ZeroVector;
+		double StartTime = 0.0;
+		float MaxTravelSquared = 0.f;
+		bool bDown = false;
+		bool bMoveStick = false;
+	};
+
+	void QueueEvent(const FPointerEvent& MouseEvent, ETouchEventType Type);
+
+	/** Runs the gestures of BatchEvents into Command, on a worker */
+	void ClassifyBatch();
+
+	FUnrealTestTouchInputSettings Settings;
+	FVector2D ViewportSize = FVector2D::ZeroVector;
+
+	/** Events received this frame, only touched by the game thread */
+	TArray<FTouchEvent> PendingEvents;
+
+	// Owned by the classification task while it runs
+	TArray<FTouchEvent> BatchEvents;
+	FVector2D BatchViewportSize = FVector2D::ZeroVector;
+	FFinger Fingers[ETouchIndex::MAX_TOUCHES];
+	int32 MoveFinger = INDEX_NONE;
+	FUnrealTestInputCommandFrame Command;
+
+	UE::Tasks::FTask ClassifyTask;
+};
+#endif
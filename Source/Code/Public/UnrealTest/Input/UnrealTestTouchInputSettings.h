@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealTestTouchInputSettings.generated.h"
+
+/**
+ * Tuning of the twin-stick touch controls: a virtual move stick wherever a finger lands on the
+ * left of the screen, drag anywhere else to aim and tap to fire. Distances are in screen heights.
+ */
+USTRUCT(BlueprintType)
+struct FUnrealTestTouchInputSettings
+{
+	GENERATED_BODY()
+
+	/** Part of the screen width, from the left, where touches drive the move stick */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MoveAreaWidth = 0.4f;
+
+	/** Distance from where the finger landed at which the move stick is fully deflected */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.01"))
+	float MoveStickRadius = 0.12f;
+
+	/** Move stick deflection below which the stick reads as centered */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MoveDeadZone = 0.1f;
+
+	/** Look input for an aim drag the height of the screen */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0"))
+	float LookSensitivity = 60.f;
+
+	/** Longest touch that still counts as a tap */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0"))
+	float TapMaxSeconds = 0.2f;
+
+	/** Furthest a finger may wander from where it landed and still count as a tap */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (ClampMin = "0.0"))
+	float TapMaxDistance = 0.02f;
+};
@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Gameplay math over arrays of character state, kept as structure of arrays (one array per component).
+ * Every kernel handles 4 elements per SIMD register and finishes the last few with scalar code,
+ * so arrays of any length work. Arrays of one call must all have the same length.
+ */
+struct FUnrealTestBatchMath
+{
+	/** Forward and right of a yaw, in degrees. Scalar form of YawToDirections, without a rotation matrix */
+	static FORCEINLINE void YawToForwardRight(float YawDegrees, FVector& OutForward, FVector& OutRight)
+	{
+		float Sin;
+		float Cos;
+		FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(YawDegrees));
+		OutForward = FVector(Cos, Sin, 0.f);
+		OutRight = FVector(-Sin, Cos, 0.f);
+	}
+
+	/** Horizontal forward of every yaw, in degrees. The right vector is (-ForwardY, ForwardX) */
+	static void YawToDirections(TArrayView<const float> YawDegrees, TArrayView<float> OutForwardX, TArrayView<float> OutForwardY);
+
+	/** Squared distance of every point to Center */
+	static void DistanceSquared(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Center, TArrayView<float> OutDistanceSquared);
+
+	/**
+	 * Points within Radius of Center.
+	 * @return number of point indices written to OutIndices, at most its size
+	 */
+	static int32 CullSphere(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Center, float Radius, TArrayView<int32> OutIndices);
+
+	/**
+	 * Points within Range of Origin whose direction is less than acos(CosHalfAngle) away from Direction.
+	 * @param Direction	Normalized
+	 * @return number of point indices written to OutIndices, at most its size
+	 */
+	static int32 CullCone(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Origin, const FVector& Direction, float CosHalfAngle, float Range, TArrayView<int32> OutIndices);
+
+	/** 1 at Center down to 0 at MaxDistance and beyond, linear in distance */
+	static void DistanceFalloff(TArrayView<const float> X, TArrayView<const float> Y, TArrayView<const float> Z, const FVector& Center, float MaxDistance, TArrayView<float> OutValues);
+
+	/**
+	 * Multiplies the values of the points outside of a horizontal view cone by OutsideScale.
+	 * @param Direction	Horizontal and normalized
+	 */
+	static void ScaleOutsideCone2D(TArrayView<const float> X, TArrayView<const float> Y, const FVector& Origin, const FVector& Direction, float CosHalfAngle, float OutsideScale, TArrayView<float> InOutValues);
+
+	/** Values moved towards Targets by Alpha, 0 keeps the values and 1 snaps them to the targets */
+	static void Interpolate(TArrayView<float> InOutValues, TArrayView<const float> Targets, float Alpha);
+
+	/** Per element maximum, kept in InOutValues */
+	static void Max(TArrayView<float> InOutValues, TArrayView<const float> Others);
+};
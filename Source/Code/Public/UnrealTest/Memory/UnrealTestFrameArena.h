@@ -0,0 +1,224 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Linear allocator for memory that only lives until the end of the frame.
+ * Allocating bumps a cursor, nothing is freed individually, and the whole arena is rewound once the frame is over.
+ * Frames that outgrow the arena chain extra blocks, merged into one big enough block on the next reset,
+ * so after a few frames of peak load gameplay queries stop reaching the heap at all.
+ * Game thread only.
+ */
+class FUnrealTestFrameArena
+{
+public:
+	/** Arena of the game thread, rewound at the end of every engine frame, after every world ticked */
+	static FUnrealTestFrameArena& Get();
+
+	FUnrealTestFrameArena();
+	~FUnrealTestFrameArena();
+
+	void* Allocate(SIZE_T Size, uint32 Alignment);
+
+	/**
+	 * Resizes an allocation of this frame, in place if it is the latest one and still fits.
+	 * @param NumBytesToKeep	Bytes at the start of Ptr copied when the allocation moves
+	 */
+	void* Reallocate(void* Ptr, SIZE_T NumBytesToKeep, SIZE_T NewSize, uint32 Alignment);
+
+	/** Rewinds the arena, every pointer it returned becomes invalid */
+	void Reset();
+
+	/** Logs the arena and heap allocations of the next NumFrames frames once they are over */
+	void StartReport(int32 NumFrames);
+
+	/** Number of resets so far, to catch arrays kept past their frame */
+	FORCEINLINE uint32 GetFrame() const { return Frame; }
+
+	/** Allocations served since the last reset */
+	FORCEINLINE int32 GetNumAllocations() const { return NumAllocations; }
+
+	/** Blocks allocated from the heap since the last reset, 0 once the arena is warm */
+	FORCEINLINE int32 GetNumHeapAllocations() const { return NumHeapAllocations; }
+
+	/** Blocks the arena holds, a single one right after a reset */
+	FORCEINLINE int32 GetNumBlocks() const { return Blocks.Num(); }
+
+	/** Bytes of all the blocks together */
+	SIZE_T GetCapacity() const;
+
+	static const SIZE_T DEFAULT_BLOCK_SIZE = 64 * 1024;
+	static const uint32 MIN_ALIGNMENT = 16;
+
+private:
+	/** Moves the cursor to a block with at least MinSize bytes free, allocating it if needed */
+	void NextBlock(SIZE_T MinSize);
+
+	/** Bytes handed out since the last reset */
+	SIZE_T GetUsedBytes() const;
+
+	struct FBlock
+	{
+		uint8* Memory;
+		SIZE_T Size;
+	};
+
+	TArray<FBlock> Blocks;
+	int32 CurrentBlock;
+	UPTRINT Cursor;
+	UPTRINT End;
+	void* LastAllocation;
+	uint32 Frame;
+
+	// Counters of the current frame
+	int32 NumAllocations;
+	int32 NumHeapAllocations;
+
+	// Running report, see StartReport
+	int32 ReportFramesLeft;
+	int32 ReportFrames;
+	int64 ReportAllocations;
+	int64 ReportHeapAllocations;
+	SIZE_T ReportPeakBytes;
+};
+
+/**
+ * TArray allocator taking its memory from the frame arena, for arrays that never outlive the frame:
+ * query results, candidate lists, scratch buffers. Growing the latest allocation is done in place,
+ * freeing is a no-op. Game thread only.
+ *
+ *	TArray<int32, FUnrealTestFrameAllocator> Victims;
+ */
+class FUnrealTestFrameAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = false };
+	enum { RequireRangeCheck = true };
+
+	class ForAnyElementType
+	{
+	public:
+		ForAnyElementType()
+			: Data(nullptr)
+#if DO_CHECK
+			, Frame(0)
+#endif
+		{
+		}
+
+		ForAnyElementType(const ForAnyElementType&) = delete;
+		ForAnyElementType& operator=(const ForAnyElementType&) = delete;
+
+		FORCEINLINE void MoveToEmpty(ForAnyElementType& Other)
+		{
+			checkSlow(this != &Other);
+			Data = Other.Data;
+			Other.Data = nullptr;
+#if DO_CHECK
+			Frame = Other.Frame;
+#endif
+		}
+
+		FORCEINLINE FScriptContainerElement* GetAllocation() const
+		{
+			return Data;
+		}
+
+		void ResizeAllocation(SizeType PreviousNumElements, SizeType NumElements, SIZE_T NumBytesPerElement, uint32 AlignmentOfElement)
+		{
+			if (NumElements == 0)
+			{
+				Data = nullptr;
+				return;
+			}
+
+			FUnrealTestFrameArena& Arena = FUnrealTestFrameArena::Get();
+#if DO_CHECK
+			checkf(Data == nullptr || Frame == Arena.GetFrame(), TEXT("Frame arena array kept past the frame it was allocated in"));
+			Frame = Arena.GetFrame();
+#endif
+			const uint32 Alignment = FMath::Max(AlignmentOfElement, FUnrealTestFrameArena::MIN_ALIGNMENT);
+			Data = (FScriptContainerElement*)Arena.Reallocate(Data, PreviousNumElements * NumBytesPerElement, NumElements * NumBytesPerElement, Alignment);
+		}
+
+		FORCEINLINE void ResizeAllocation(SizeType PreviousNumElements, SizeType NumElements, SIZE_T NumBytesPerElement)
+		{
+			ResizeAllocation(PreviousNumElements, NumElements, NumBytesPerElement, FUnrealTestFrameArena::MIN_ALIGNMENT);
+		}
+
+		FORCEINLINE SizeType CalculateSlackReserve(SizeType NumElements, SIZE_T NumBytesPerElement) const
+		{
+			return NumElements;
+		}
+
+		FORCEINLINE SizeType CalculateSlackReserve(SizeType NumElements, SIZE_T NumBytesPerElement, uint32 AlignmentOfElement) const
+		{
+			return NumElements;
+		}
+
+		/** Memory given back to the arena is not reusable until the reset, so never shrink */
+		FORCEINLINE SizeType CalculateSlackShrink(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return NumAllocatedElements;
+		}
+
+		FORCEINLINE SizeType CalculateSlackShrink(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement, uint32 AlignmentOfElement) const
+		{
+			return NumAllocatedElements;
+		}
+
+		FORCEINLINE SizeType CalculateSlackGrow(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false);
+		}
+
+		FORCEINLINE SizeType CalculateSlackGrow(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement, uint32 AlignmentOfElement) const
+		{
+			return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false, AlignmentOfElement);
+		}
+
+		FORCEINLINE SIZE_T GetAllocatedSize(SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+		{
+			return NumAllocatedElements * NumBytesPerElement;
+		}
+
+		FORCEINLINE bool HasAllocation() const
+		{
+			return Data != nullptr;
+		}
+
+		FORCEINLINE SizeType GetInitialCapacity() const
+		{
+			return 0;
+		}
+
+	private:
+		FScriptContainerElement* Data;
+
+#if DO_CHECK
+		/** Arena frame Data was allocated in */
+		uint32 Frame;
+#endif
+	};
+
+	template<typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		FORCEINLINE ElementType* GetAllocation() const
+		{
+			return (ElementType*)ForAnyElementType::GetAllocation();
+		}
+	};
+};
+
+template <>
+struct TAllocatorTraits<FUnrealTestFrameAllocator> : TAllocatorTraitsBase<FUnrealTestFrameAllocator>
+{
+	enum { SupportsMove = true };
+	enum { IsZeroConstruct = true };
+};
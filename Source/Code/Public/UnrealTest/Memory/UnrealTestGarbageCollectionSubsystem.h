@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Game/UnrealTestGameState.h"
+#include "UnrealTestGarbageCollectionSubsystem.generated.h"
+
+/**
+ * Keeps garbage collection pauses out of rounds in progress. When the match enters a quiet phase, such as
+ * waiting for players or showing the round results, reachability analysis runs right away and the purge is
+ * spread over the frames after it. While a round is in progress, the engine's periodic collection is pushed back.
+ * Collections under memory pressure still happen.
+ * Every collection reports its pause in the UnrealTest stats, and pauses during a round are logged.
+ */
+UCLASS(config=Game)
+class UUnrealTestGarbageCollectionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestGarbageCollectionSubsystem();
+
+	// UWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of UWorldSubsystem interface
+
+	/** Collects garbage, or holds it back, for the phase the match just entered. Called by the game state on server and clients */
+	void OnMatchPhaseChanged(EUnrealTestMatchPhase NewPhase);
+
+	/** Logs how many collections ran and how long they paused the game */
+	void DumpStats() const;
+
+	/** Phases that collect garbage as soon as the match enters them */
+	UPROPERTY(Config)
+	TArray<EUnrealTestMatchPhase> CollectOnPhases;
+
+	/** Purges every unreachable object during the pause instead of over the following frames */
+	UPROPERTY(Config)
+	bool bFullPurge;
+
+	/** Pushes the periodic collection back while a round is in progress */
+	UPROPERTY(Config)
+	bool bDeferDuringRounds;
+
+	/** Time between periodic collections while a round is in progress, longer than a round by default */
+	UPROPERTY(Config)
+	float RoundSecondsBetweenCollections;
+
+protected:
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	/** Swaps the time between periodic collections for the round one, or back to what it was */
+	void SetDeferred(bool bDeferred);
+
+	const float ROUND_SECONDS_BETWEEN_COLLECTIONS = 600.f;
+
+private:
+	EUnrealTestMatchPhase MatchPhase;
+
+	bool bIsDeferring;
+
+	double CollectionStartTime;
+
+	int32 NumCollections;
+	int32 NumCollectionsDuringRounds;
+	float LongestPauseMs;
+	float TotalPauseMs;
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	/** Engine time between collections before the first world deferred it, shared since the setting is global */
+	static float DefaultSecondsBetweenCollections;
+	static int32 NumDeferringWorlds;
+};
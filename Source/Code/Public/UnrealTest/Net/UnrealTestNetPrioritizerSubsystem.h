@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "UnrealTestNetPrioritizerSubsystem.generated.h"
+
+class AUnrealTestCharacter;
+class UUnrealTestVisibilitySubsystem;
+
+/**
+ * Server side scoring of how much each connection cares about each character.
+ * The score drives the per-connection net priority of the character and its net update frequency,
+ * so bandwidth goes to the characters near, in front of, or fighting with each viewer.
+ *
+ * Per connection, distance and view cone terms are evaluated between grid cells rather than exact positions
+ * and cached for the frame, so connections sharing a cell and view direction share the work.
+ * The update frequencies use exact positions instead, scored for all characters at once with the batch math kernels.
+ * Characters the baked visibility grid says the viewer can't see are scaled down, without tracing.
+ */
+UCLASS(config=Game)
+class UUnrealTestNetPrioritizerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestNetPrioritizerSubsystem();
+
+	// UTickableWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// End of UTickableWorldSubsystem interface
+
+	void RegisterCharacter(AUnrealTestCharacter* Character);
+	void UnregisterCharacter(AUnrealTestCharacter* Character);
+
+	/**
+	 * Returns how relevant Target is to a viewer, from 0 (barely) to 1 (fully).
+	 * @param ViewTarget	Actor the viewer is looking through, usually its pawn
+	 */
+	float GetRelevancyScore(const AActor* Target, const FVector& ViewPos, const FVector& ViewDir, const AActor* ViewTarget);
+
+	/** Records that Attacker hit Victim, both become fully relevant to each other for a while */
+	void NotifyCombat(const AActor* Attacker, const AActor* Victim);
+
+	/** Size of the grid cells positions are snapped to */
+	UPROPERTY(Config)
+	float CellSize;
+
+	/** Distance at which the distance term reaches zero */
+	UPROPERTY(Config)
+	float MaxRelevantDistance;
+
+	/** Cosine of the half angle of the view cone */
+	UPROPERTY(Config)
+	float ViewConeCosine;
+
+	/** Scale applied to characters behind the viewer's camera */
+	UPROPERTY(Config)
+	float OutOfViewScale;
+
+	/** Scale applied to characters hidden from the viewer by the level, according to the visibility grid */
+	UPROPERTY(Config)
+	float OccludedScale;
+
+	/** Seconds two characters stay fully relevant to each other after a hit */
+	UPROPERTY(Config)
+	float CombatMemorySeconds;
+
+	UPROPERTY(Config)
+	float MinNetUpdateFrequency;
+
+	UPROPERTY(Config)
+	float MaxNetUpdateFrequency;
+
+	/** Seconds between updates of the character net update frequencies */
+	UPROPERTY(Config)
+	float FrequencyUpdateInterval;
+
+private:
+	FIntVector GetCell(const FVector& Location) const;
+	float GetSpatialScore(const FIntVector& ViewCell, const FVector& ViewDir, const FIntVector& TargetCell);
+	float GetCombatScore(const AActor* Target, const AActor* ViewTarget) const;
+	void UpdateNetUpdateFrequencies();
+
+	UPROPERTY()
+	UUnrealTestVisibilitySubsystem* Visibility;
+
+	TArray<TWeakObjectPtr<AUnrealTestCharacter>> Characters;
+
+	/** Spatial scores of this frame, keyed by viewer cell, target cell and view direction bucket */
+	TMap<uint64, float> SpatialScoreCache;
+	uint64 SpatialScoreCacheFrame;
+
+	/** Last hit time between two characters, keyed by the pair ordered by object key */
+	TMap<TPair<FObjectKey, FObjectKey>, float> LastCombatTimes;
+
+	float TimeUntilFrequencyUpdate;
+
+	const float CELL_SIZE = 1000.f;
+	const float MAX_RELEVANT_DISTANCE = 15000.f;
+	const float VIEW_CONE_COSINE = 0.5f;
+	const float OUT_OF_VIEW_SCALE = 0.3f;
+	const float OCCLUDED_SCALE = 0.5f;
+	const float COMBAT_MEMORY_SECONDS = 3.f;
+	const float MIN_NET_UPDATE_FREQUENCY = 10.f;
+	const float MAX_NET_UPDATE_FREQUENCY = 100.f;
+	const float FREQUENCY_UPDATE_INTERVAL = 0.25f;
+	const int32 VIEW_YAW_BUCKETS = 16;
+};
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Offset between the local platform clock and the server clock, estimated from NTP style samples.
+ * Samples are filtered by keeping the lowest round trip of a sliding window, and the offset handed out
+ * is slewed towards the filtered one so the synchronized time never runs backwards, unless the error
+ * is too large to wait for. Plain C++ so it can be fed synthetic samples.
+ */
+struct FUnrealTestClockFilter
+{
+	/**
+	 * Adds a sample and picks the offset of the fastest round trip of the window as the target.
+	 * The first sample is applied at once.
+	 * @param RoundTripSeconds	Time between sending the request and receiving the answer
+	 * @param Offset			Server time minus the local time halfway through the round trip
+	 */
+	void AddSample(float RoundTripSeconds, double Offset);
+
+	/**
+	 * Moves the applied offset towards the target.
+	 * @param MaxSlewRate			Maximum correction, in seconds per second
+	 * @param StepThresholdSeconds	Errors larger than this are corrected at once
+	 */
+	void Advance(float DeltaSeconds, float MaxSlewRate, float StepThresholdSeconds);
+
+	void Reset();
+
+	/** True once the first sample came in */
+	FORCEINLINE bool IsSynchronized() const { return bSynchronized; }
+
+	/** Offset to add to the platform time to get the server time */
+	FORCEINLINE double GetAppliedOffset() const { return AppliedOffset; }
+
+	/** Offset of the best sample, the applied offset slews towards it */
+	FORCEINLINE double GetTargetOffset() const { return TargetOffset; }
+
+	/** Smoothed round trip of every sample, not only the best one */
+	FORCEINLINE float GetRoundTripSeconds() const { return SmoothedRoundTripSeconds; }
+
+	static constexpr int32 SAMPLE_WINDOW = 16;
+	static constexpr float ROUND_TRIP_SMOOTHING = 0.1f;
+
+private:
+	struct FSample
+	{
+		float RoundTripSeconds = 0.f;
+		double Offset = 0.0;
+	};
+	FSample Samples[SAMPLE_WINDOW];
+	int32 SampleHead = INDEX_NONE;
+
+	double AppliedOffset = 0.0;
+	double TargetOffset = 0.0;
+	float SmoothedRoundTripSeconds = 0.f;
+	bool bSynchronized = false;
+};
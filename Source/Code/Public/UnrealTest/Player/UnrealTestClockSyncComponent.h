@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "UnrealTest/Player/UnrealTestClockFilter.h"
+#include "UnrealTestClockSyncComponent.generated.h"
+
+/** Server side half of a clock sync sample, replicated to the owning client */
+USTRUCT()
+struct FUnrealTestClockSyncEcho
+{
+	GENERATED_BODY()
+
+	/** Movement timestamp of the last move the server received from the client */
+	UPROPERTY()
+	float ClientTimeStamp = 0.f;
+
+	/** Server world time the move was received at */
+	UPROPERTY()
+	double ServerTime = 0.0;
+};
+
+/**
+ * NTP style clock synchronization between a player and the server, living on the player controller.
+ * It doesn't send anything of its own: the client already stamps every move it sends with a movement
+ * timestamp, the server echoes back the last one it received together with its own time through the
+ * controller's owner only replication, and the client pairs that with the local time the move was sent at.
+ * The samples go through FUnrealTestClockFilter.
+ */
+UCLASS(config=Game, ClassGroup=(Player))
+class UUnrealTestClockSyncComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealTestClockSyncComponent();
+
+	// UActorComponent interface
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// End of UActorComponent interface
+
+	/** Current synchronized server time. Monotonic, and equal to the world time on the server */
+	double GetServerTime() const;
+
+	/** Converts a local platform time, as returned by FPlatformTime::Seconds, to synchronized server time */
+	double PlatformTimeToServerTime(double PlatformTime) const;
+
+	/** True once the client got its first sample */
+	FORCEINLINE bool IsSynchronized() const { return Filter.IsSynchronized(); }
+
+	/** Filtered round trip time to the server, in seconds */
+	FORCEINLINE float GetRoundTripSeconds() const { return Filter.GetRoundTripSeconds(); }
+
+	// Client side of a sample, driven by the tick and the echo replication, or by tests without a connection
+
+	/** Remembers the local platform time the move stamped with TimeStamp left at */
+	void RecordSentMove(float TimeStamp, double PlatformTime);
+
+	/** Pairs an echo with the time its move left and adds the sample to the filter */
+	void ReceiveEcho(const FUnrealTestClockSyncEcho& Echo, double ReceivedPlatformTime);
+
+	/** Slews the applied offset, once per frame */
+	void AdvanceClock(float DeltaTime);
+
+	/** Seconds between two samples the server sends */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ClockSync)
+	float SampleInterval;
+
+	/** Maximum speed the offset is corrected at, in seconds per second */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ClockSync)
+	float MaxSlewRate;
+
+	/** Errors larger than this are corrected at once instead of slewed */
+	UPROPERTY(Config, EditDefaultsOnly, Category = ClockSync)
+	float StepThresholdSeconds;
+
+protected:
+	UFUNCTION()
+	void OnRep_ServerEcho();
+
+private:
+	bool IsLocalClient() const;
+	void TickServer();
+	void TickClient(float DeltaTime);
+
+	/** Records the moves the movement component sent since the last call */
+	void RecordSentMoves();
+
+	class UCharacterMovementComponent* GetCharacterMovement() const;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ServerEcho)
+	FUnrealTestClockSyncEcho ServerEcho;
+
+	/** Server: time left until the next echo gets updated */
+	float TimeUntilNextSample;
+
+	/** Server: last movement timestamp seen, to detect new moves */
+	float LastReceivedTimeStamp;
+
+	/** Client: local platform time each recent move left at, by movement timestamp */
+	struct FSentTimeStamp
+	{
+		float TimeStamp = 0.f;
+		double PlatformTime = 0.0;
+	};
+	TArray<FSentTimeStamp> SentTimeStamps;
+	int32 SentTimeStampHead;
+
+	/** Client: newest movement timestamp recorded as sent */
+	float LastSentTimeStamp;
+
+	/** Client: offset between the platform time and the server time */
+	FUnrealTestClockFilter Filter;
+
+	/** Last synchronized time handed out, to keep it monotonic */
+	mutable double LastServerTime;
+
+	const float SAMPLE_INTERVAL = 0.1f;
+	const float MAX_SLEW_RATE = 0.05f;
+	const float STEP_THRESHOLD_SECONDS = 0.25f;
+	const int32 SENT_TIMESTAMP_CAPACITY = 128;
+};
@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "UnrealTest/Input/UnrealTestTouchInputSettings.h"
+#include "UnrealTestPlayerController.generated.h"
+
+UCLASS(config=Game)
+class AUnrealTestPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+	/** Keeps the shared timebase with the server used by lag compensation */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Network, meta = (AllowPrivateAccess = "true"))
+	class UUnrealTestClockSyncComponent* ClockSync;
+
+public:
+	AUnrealTestPlayerController();
+
+	// AActor interface
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// End of AActor interface
+
+	// APlayerController interface
+	virtual void PlayerTick(float DeltaTime) override;
+	// End of APlayerController interface
+
+#if !UE_SERVER
+	/**
+	 * View rotation at the moment the attack button was clicked this frame, interpolated
+	 * through the raw mouse motion received before the click.
+	 * @param OutPlatformTime	Platform time the click was delivered at
+	 * @return false if there was no click this frame
+	 */
+	bool GetClickAim(FRotator& OutRotation, double& OutPlatformTime) const;
+#endif
+
+	/** Move stick, aim drag and tap areas of the touch controls */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = Input)
+	FUnrealTestTouchInputSettings TouchInputSettings;
+
+	/** Converts a local platform time, as returned by FPlatformTime::Seconds, to synchronized server time */
+	double PlatformTimeToServerTime(double PlatformTime) const;
+
+	/** Returns ClockSync subobject **/
+	FORCEINLINE class UUnrealTestClockSyncComponent* GetClockSync() const { return ClockSync; }
+
+protected:
+	// APlayerController interface
+	virtual void ProcessPlayerInput(const float DeltaTime, const bool bGamePaused) override;
+	// End of APlayerController interface
+
+#if !UE_SERVER
+private:
+	/** Works out ClickAimRotation from how much of the frame's rotation happened before the click */
+	void UpdateClickAimRotation(const FRotator& FrameStartRotation);
+
+	TSharedPtr<class FUnrealTestMouseAimInputProcessor> MouseAimProcessor;
+
+	/** Only created on devices with touch input */
+	TSharedPtr<class FUnrealTestTouchInputProcessor> TouchProcessor;
+
+	FRotator ClickAimRotation;
+	double ClickPlatformTime;
+	bool bHasClickAimRotation;
+#endif
+};
@@ -0,0 +1,9 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/** Stat group for the arena gameplay systems. Use "stat UnrealTest" to display it. */
+DECLARE_STATS_GROUP(TEXT("UnrealTest"), STATGROUP_UnrealTest, STATCAT_Advanced);
@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class UnrealTestServerTarget : TargetRules
+{
+	public UnrealTestServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_0;
+		ExtraModuleNames.Add("UnrealTest");
+
+		// Match servers never show a browser or run developer tools, keep them out of the binary
+		bCompileCEF3 = false;
+		bBuildDeveloperTools = false;
+
+		// Still want to know why a match server went down
+		bUseLoggingInShipping = true;
+	}
+}